@@ -24,8 +24,10 @@
 #ifndef LSST_AFW_DETECTION_FOOTPRINTMERGE_H
 #define LSST_AFW_DETECTION_FOOTPRINTMERGE_H
 
+#include <cstdint>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "lsst/afw/table/Source.h"
 
@@ -49,8 +51,9 @@ class FootprintMerge;
  *  existing FootprintMerge, the Footprint will be added to it.  If not, then a new FootprintMerge will be
  *  created and added to the vector.
  *
- *  The search algorithm uses a brute force approach over the current list.  This should be fine if we
- *  are operating on smallish number of objects, such as at the tract level.
+ *  Candidate overlaps are found with a grid index on the bounding boxes of the current list, so each
+ *  new Footprint is only compared with the FootprintMerges in its neighbourhood.  The results are the
+ *  same as those of a search over the whole list, in the same order.
  *
  */
 class FootprintMergeList final {
@@ -110,7 +113,11 @@ public:
     /**
      *  Clear entries in the current vector
      */
-    void clearCatalog() { _mergeList.clear(); }
+    void clearCatalog() {
+        _mergeList.clear();
+        _cells.clear();
+        _numRemoved = 0;
+    }
 
     /**
      *  Get SourceCatalog with entries that contain the final Footprint and SourceRecord for each entry
@@ -130,12 +137,24 @@ private:
 
     typedef std::vector<std::shared_ptr<FootprintMerge>> FootprintMergeVec;
     typedef std::map<std::string, KeyTuple> FilterMap;
+    typedef std::unordered_map<std::uint64_t, std::vector<std::size_t>> CellMap;
 
     friend class FootprintMerge;
 
     void _initialize(afw::table::Schema &sourceSchema, std::vector<std::string> const &filterList);
 
-    FootprintMergeVec _mergeList;
+    // Add _mergeList[index] to the cells covered by its bounding box, grown by one pixel
+    void _indexMerge(std::size_t index);
+
+    // Return the indices of the entries in _mergeList that may overlap bbox, in list order
+    std::vector<std::size_t> _findCandidates(lsst::geom::Box2I const &bbox) const;
+
+    // Drop the entries of _mergeList that were merged into others, and rebuild the index
+    void _compact();
+
+    FootprintMergeVec _mergeList;  // entries merged into others are reset until the next _compact()
+    CellMap _cells;                // indices into _mergeList of the entries overlapping each grid cell
+    std::size_t _numRemoved = 0;   // number of reset entries in _mergeList
     FilterMap _filterMap;
     afw::table::SchemaMapper _peakSchemaMapper;
     std::shared_ptr<PeakTable> _peakTable;
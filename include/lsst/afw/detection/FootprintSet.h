@@ -62,10 +62,12 @@ public:
      * @param threshold threshold to find objects
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
+     * @param numThreads number of threads to use; 0 for one per hardware thread.
+     *                   The result does not depend on the number of threads.
      */
     template <typename ImagePixelT>
     FootprintSet(image::Image<ImagePixelT> const& img, Threshold const& threshold, int const npixMin = 1,
-                 bool const setPeaks = true);
+                 bool const setPeaks = true, int const numThreads = 1);
 
     /**
      * Find a FootprintSet given a Mask and a threshold
@@ -73,9 +75,12 @@ public:
      * @param img Image to search for objects
      * @param threshold threshold to find objects
      * @param npixMin minimum number of pixels in an object
+     * @param numThreads number of threads to use; 0 for one per hardware thread.
+     *                   The result does not depend on the number of threads.
      */
     template <typename MaskPixelT>
-    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1);
+    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1,
+                 int const numThreads = 1);
 
     /**
      * Find a FootprintSet given a MaskedImage and a threshold
@@ -89,15 +94,23 @@ public:
      * are processed (Threshold will probably have to be below the background level
      * for this to make sense, e.g. for difference imaging)
      *
+     * The Footprint%s are sorted by their first span (that is, by the first pixel of each in raster order).
+     * With numThreads > 1 horizontal bands of the image are searched in parallel and the objects that
+     * cross the boundaries between bands are then joined, giving the same result as a single thread.
+     * The peaks of different Footprints are also searched for in parallel; the PeakRecords are still
+     * created in Footprint order, so their IDs don't depend on the number of threads.
+     *
      * @param img MaskedImage to search for objects
      * @param threshold threshold for footprints (controls size)
      * @param planeName mask plane to set (if != "")
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
+     * @param numThreads number of threads to use; 0 for one per hardware thread
      */
     template <typename ImagePixelT, typename MaskPixelT>
     FootprintSet(image::MaskedImage<ImagePixelT, MaskPixelT> const& img, Threshold const& threshold,
-                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true);
+                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true,
+                 int const numThreads = 1);
 
     /**
      * Construct an empty FootprintSet given a region that its footprints would have lived in
@@ -108,10 +121,13 @@ public:
     /**
      * Copy constructor
      *
+     * The Footprint%s are copied, unless rhs is in copy-on-write mode (see setCopyOnWrite).
+     *
      * @param rhs the input FootprintSet
      */
     FootprintSet(FootprintSet const& rhs);
     FootprintSet(FootprintSet const& set, int rGrow, FootprintControl const& ctrl);
+    /// Move constructor; does not copy the Footprint%s, and leaves rhs with none.
     FootprintSet(FootprintSet&& rhs);
     ~FootprintSet();
     /**
@@ -135,11 +151,13 @@ public:
 
     /// Assignment operator.
     FootprintSet& operator=(FootprintSet const& rhs);
+    /// Move assignment; does not copy the Footprint%s, and leaves rhs with none.
     FootprintSet& operator=(FootprintSet&& rhs);
 
     void swap(FootprintSet& rhs) noexcept {
         using std::swap;  // See Meyers, Effective C++, Item 25
         swap(*_footprints, *rhs.getFootprints());
+        swap(_copyOnWrite, rhs._copyOnWrite);
         lsst::geom::Box2I rhsRegion = rhs.getRegion();
         rhs.setRegion(getRegion());
         setRegion(rhsRegion);
@@ -189,6 +207,26 @@ public:
      */
     lsst::geom::Box2I const getRegion() const { return _region; }
 
+    /**
+     * Return whether this FootprintSet is in copy-on-write mode
+     */
+    bool isCopyOnWrite() const { return _copyOnWrite; }
+
+    /**
+     * Set copy-on-write mode
+     *
+     * In copy-on-write mode copies of this FootprintSet (which are also in copy-on-write mode) share
+     * its Footprint%s rather than copying them, as do sets grown by 0 pixels. Sets grown or merged
+     * from it share the Footprint%s that the grow or merge leaves unchanged (other than HeavyFootprint%s).
+     * setRegion copies a shared Footprint before modifying it.
+     *
+     * @param copyOnWrite share Footprint%s between copies?
+     *
+     * @warning Footprint%s obtained from getFootprints() may be shared with other sets in this mode,
+     * and should not be modified.
+     */
+    void setCopyOnWrite(bool copyOnWrite) { _copyOnWrite = copyOnWrite; }
+
     /**
      * Return an Image with pixels set to the Footprint%s in the FootprintSet
      *
@@ -227,14 +265,16 @@ public:
      *
      * @param mimg the image providing pixel values
      * @param ctrl Control how we manipulate HeavyFootprints
+     * @param numThreads number of threads to use; 0 for one per hardware thread
      */
     template <typename ImagePixelT, typename MaskPixelT>
     void makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const& mimg,
-                   HeavyFootprintCtrl const* ctrl = NULL);
+                   HeavyFootprintCtrl const* ctrl = NULL, int const numThreads = 1);
 
 private:
     std::shared_ptr<FootprintList> _footprints;  ///< the Footprints of detected objects
     lsst::geom::Box2I _region;  ///< The corners of the MaskedImage that the detections live in
+    bool _copyOnWrite = false;  ///< Share Footprints between copies? See setCopyOnWrite
 };
 }  // namespace detection
 }  // namespace afw
@@ -14,8 +14,11 @@
  */
 
 #include <climits>
+#include <cstddef>
 #include <string>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <boost/format.hpp>
 
@@ -586,6 +589,14 @@ public:
     /// Write a string to a binary table.
     void writeTableScalar(std::size_t row, int col, std::string const& value);
 
+    /**
+     *  Write raw bytes to consecutive rows of a binary table, without any conversion.
+     *
+     *  The bytes must already be in the FITS representation (big-endian, with any TZERO offset
+     *  applied); nBytes may span several rows.
+     */
+    void writeTableBytes(std::size_t row, std::size_t nBytes, void const* data);
+
     /// Read an array value from a binary table.
     template <typename T>
     void readTableArray(std::size_t row, int col, int nElements, T* value);
@@ -605,6 +616,38 @@ public:
     /// Return the size of an variable-length array field.
     long getTableArraySize(std::size_t row, int col);
 
+    /**
+     *  Read raw bytes from consecutive rows of a binary table, without any conversion.
+     *
+     *  Values are left in the FITS representation; see getTableColumnOffsets() for how to decode them.
+     *  nBytes may span several rows.
+     */
+    void readTableBytes(std::size_t row, std::size_t nBytes, void* data);
+
+    /**
+     *  Return the byte offset of each column within the rows of a binary table, for decoding the
+     *  bytes returned by readTableBytes().
+     *
+     *  The values of a column with a non-negative offset are stored in the row as big-endian numbers
+     *  (or characters, or bits) with no scaling, except that 16-bit integer ('I') columns qualify only
+     *  with the TZERO = 32768 cfitsio uses for unsigned values.  Other columns (scaled columns and
+     *  variable-length arrays, whose values are in the heap) have offset -1, and must be read with
+     *  readTableArray.
+     */
+    std::vector<std::ptrdiff_t> getTableColumnOffsets();
+
+    /**
+     *  Return the data type and repeat count of each column of a binary table.
+     *
+     *  The data type is the TFORM letter code of the column's elements (e.g. 'J' for 32-bit integers,
+     *  'X' for bits), or '\0' for types with no code here; for variable-length arrays it is the code
+     *  of the elements in the heap.
+     */
+    std::vector<std::pair<char, std::size_t>> getTableColumnFormats();
+
+    /// Return the number of bytes in each row of a binary table (NAXIS1).
+    std::size_t getTableRowSize();
+
     /// Default constructor; set all data members to 0.
     Fits() : fptr(0), status(0), behavior(0) {}
 
@@ -49,6 +49,14 @@ namespace math {
  */
 class ConvolutionControl {
 public:
+    /**
+     * How to convolve with a spatially varying LinearCombinationKernel
+     */
+    enum LinearCombinationAlgorithm {
+        KERNEL_IMAGES,  ///< compute (or interpolate) the kernel image at each pixel
+        BASIS_IMAGES    ///< convolve with each basis kernel and combine using the spatial model
+    };
+
     ConvolutionControl(bool doNormalize = true,  ///< normalize the kernel to sum=1?
                        bool doCopyEdge = false,  ///< copy edge pixels from source image
                        ///< instead of setting them to the standard edge pixel?
@@ -57,17 +65,77 @@ public:
                        )
             : _doNormalize(doNormalize),
               _doCopyEdge(doCopyEdge),
-              _maxInterpolationDistance(maxInterpolationDistance) {}
+              _maxInterpolationDistance(maxInterpolationDistance),
+              _fftMinKernelSize(15),
+              _linearCombinationAlgorithm(KERNEL_IMAGES),
+              _numThreads(1) {}
 
     bool getDoNormalize() const { return _doNormalize; }
     bool getDoCopyEdge() const { return _doCopyEdge; }
     int getMaxInterpolationDistance() const { return _maxInterpolationDistance; };
+    /**
+     * Return the smallest kernel width and height for which convolution may use FFTs
+     *
+     * Kernels at least this large in both dimensions are convolved using FFTs when the output pixels are
+     * floating point, the input image (and variance) pixels are all finite, and FFTs are expected to be
+     * faster; otherwise the convolution is done in real space.  0 means never use FFTs.
+     */
+    int getFftMinKernelSize() const { return _fftMinKernelSize; }
+    /**
+     * Return the algorithm used to convolve with a spatially varying LinearCombinationKernel
+     *
+     * KERNEL_IMAGES computes the kernel image at each pixel, or interpolates between kernel images
+     * computed on a grid (see getMaxInterpolationDistance).  BASIS_IMAGES convolves the image with each basis
+     * kernel (using the fastest method for that kernel) and sums the results, weighted by the spatial model
+     * evaluated at each pixel; this is exact, and fast for many basis kernels of simple form (e.g. delta
+     * functions or separable kernels), but the variance needs a convolution for each pair of basis
+     * kernels whose product is nonzero.
+     */
+    LinearCombinationAlgorithm getLinearCombinationAlgorithm() const { return _linearCombinationAlgorithm; }
+    /**
+     * Return the number of threads to use; 0 means one per hardware thread
+     *
+     * The good region of the output is split into bands of rows, which are convolved in parallel.
+     * Results don't depend on the number of threads, except when using FFTs (for which they may differ
+     * by roundoff) or convolving with a DeltaFunctionKernel (which is always done in one thread, as it
+     * is just a copy).
+     */
+    int getNumThreads() const { return _numThreads; }
 
     void setDoNormalize(bool doNormalize) { _doNormalize = doNormalize; }
     void setDoCopyEdge(bool doCopyEdge) { _doCopyEdge = doCopyEdge; }
     void setMaxInterpolationDistance(int maxInterpolationDistance) {
         _maxInterpolationDistance = maxInterpolationDistance;
     }
+    /**
+     * Set the smallest kernel width and height for which convolution may use FFTs; 0 means never
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if fftMinKernelSize < 0
+     */
+    void setFftMinKernelSize(int fftMinKernelSize) {
+        if (fftMinKernelSize < 0) {
+            std::ostringstream os;
+            os << "fftMinKernelSize = " << fftMinKernelSize << " < 0";
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError, os.str());
+        }
+        _fftMinKernelSize = fftMinKernelSize;
+    }
+    void setLinearCombinationAlgorithm(LinearCombinationAlgorithm algorithm) {
+        _linearCombinationAlgorithm = algorithm;
+    }
+    /**
+     * Set the number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void setNumThreads(int numThreads) {
+        if (numThreads < 0) {
+            std::ostringstream os;
+            os << "numThreads = " << numThreads << " < 0";
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError, os.str());
+        }
+        _numThreads = numThreads;
+    }
 
 private:
     bool _doNormalize;              ///< normalize the kernel to sum=1?
@@ -75,6 +143,10 @@ private:
                                     ///< instead of setting them to the standard edge pixel?
     int _maxInterpolationDistance;  ///< maximum width or height of a region
                                     ///< over which to attempt interpolation
+    int _fftMinKernelSize;          ///< minimum kernel width and height for which to consider FFTs
+    LinearCombinationAlgorithm _linearCombinationAlgorithm;  ///< how to convolve with a spatially varying
+                                                             ///< LinearCombinationKernel
+    int _numThreads;                ///< number of threads to use; 0 for one per hardware thread
 };
 
 /**
@@ -131,9 +203,11 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  * to the lower left corner of the sub-image, but it will almost certainly change to be
  * the lower left corner of the parent image.
  *
- * All convolution is performed in real space. This allows convolution to handle masked pixels
- * and spatially varying kernels. Although convolution of an Image with a spatially invariant kernel could,
- * in fact, be performed in Fourier space, the code does not do this.
+ * Most convolution is performed in real space. This allows convolution to handle masked pixels
+ * and spatially varying kernels. Large spatially invariant kernels, and spatially varying
+ * LinearCombinationKernels with large basis kernels, are convolved using FFTs (tile by tile) when
+ * that is expected to be faster; see ConvolutionControl::setFftMinKernelSize. The mask is always
+ * smeared in real space.
  *
  * Note that mask bits are smeared by convolution; all nonzero pixels in the kernel smear the mask, even
  * pixels that have very small values. Larger kernels smear the mask more and are also slower to convolve.
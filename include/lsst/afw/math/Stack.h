@@ -27,7 +27,10 @@
 /*
  * Functions to stack images
  */
+#include <functional>
+#include <string>
 #include <vector>
+#include "lsst/geom/Box.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/Mask.h"
 #include "lsst/afw/math/Statistics.h"
@@ -154,6 +157,62 @@ void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,  ///< Output im
                      image::MaskPixel excuse = 0    ///< bitmask to excuse from marking as clipped
 );
 
+/**
+ * Compute some statistics of a stack of Masked Images, reading the inputs one band of rows at a time
+ *
+ * Only one band of each input is held in memory at once, so the peak memory use is of order
+ * nImage*bandHeight*out.getWidth() pixels rather than nImage times the size of the output.
+ * Each band is read by calling `readBand(i, bbox)` for i = 0..nImage-1 on the calling thread, then stacked
+ * into the corresponding rows of `out` using `sctrl.getNumThreads()` threads.
+ *
+ * @param[out] out        Output MaskedImage; its bounding box defines the region to stack.
+ * @param[in] nImage      Number of input images.
+ * @param[in] readBand    Function returning the pixels of image `i` in `bbox` (given in the PARENT
+ *                        coordinates of `out`); the returned MaskedImage must have the dimensions of `bbox`.
+ * @param[in] flags       Statistics requested.
+ * @param[in] sctrl       Control structure.
+ * @param[in] wvector     Vector of weights.
+ * @param[in] clipped     Mask to set for pixels that were clipped (NOT rejected due to masks).
+ * @param[in] maskMap     Vector of pairs of mask pixel values, as for the in-memory version.
+ * @param[in] bandHeight  Number of rows to read from each input at a time.
+ *
+ * @throws lsst::pex::exceptions::LengthError if nImage is 0.
+ * @throws lsst::pex::exceptions::InvalidParameterError if bandHeight isn't positive, if wvector doesn't
+ *         match nImage, or if a band has the wrong dimensions.
+ * @throws lsst::pex::exceptions::NotFoundError if readBand returns a null pointer.
+ */
+template <typename PixelT>
+void statisticsStack(
+        lsst::afw::image::MaskedImage<PixelT>& out, int nImage,
+        std::function<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(
+                int, lsst::geom::Box2I const&)> const& readBand,
+        Property flags, StatisticsControl const& sctrl,
+        std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+        std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap, int bandHeight);
+
+/**
+ * Compute some statistics of a stack of Masked Images stored in FITS files, reading them a band at a time
+ *
+ * Each file is opened once, with an lsst::afw::image::MaskedImageFitsReader that is kept open while
+ * stacking, and each band is read from it using a bounding box given in the PARENT coordinates of `out`;
+ * see the version taking a `readBand` function for details.
+ *
+ * @param[out] out        Output MaskedImage; its bounding box defines the region to stack.
+ * @param[in] fileNames   Names of the FITS files holding the MaskedImages to process.
+ * @param[in] flags       Statistics requested.
+ * @param[in] sctrl       Control structure.
+ * @param[in] wvector     Vector of weights.
+ * @param[in] clipped     Mask to set for pixels that were clipped (NOT rejected due to masks).
+ * @param[in] maskMap     Vector of pairs of mask pixel values, as for the in-memory version.
+ * @param[in] bandHeight  Number of rows to read from each file at a time.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out, std::vector<std::string> const& fileNames,
+                     Property flags, StatisticsControl const& sctrl,
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                     int bandHeight);
+
 /**
  * A function to compute some statistics of a stack of std::vectors
  */
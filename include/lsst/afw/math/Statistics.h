@@ -94,6 +94,12 @@ class StatisticsControl {
 public:
     enum WeightsBoolean { WEIGHTS_FALSE = 0, WEIGHTS_TRUE = 1, WEIGHTS_NONE };  // initial state is NONE
 
+    /// How to find the median and quartiles (needed for MEDIAN, IQRANGE and the clipped statistics)
+    enum QuantileAlgorithm {
+        QUANTILE_NTH_ELEMENT = 0,  ///< partially sort a copy of the good pixels (the default)
+        QUANTILE_RADIX_SELECT      ///< select on the pixels' bit patterns; O(N) with bounded memory
+    };
+
     StatisticsControl(double numSigmaClip = 3.0,  ///< number of standard deviations to clip at
                       int numIter = 3,            ///< Number of iterations
                       lsst::afw::image::MaskPixel andMask =
@@ -109,7 +115,10 @@ public:
               _isNanSafe(isNanSafe),
               _useWeights(useWeights),
               _calcErrorFromInputVariance(false),
-              _maskPropagationThresholds() {
+              _maskPropagationThresholds(),
+              _quantileAlgorithm(QUANTILE_NTH_ELEMENT),
+              _incrementalClip(false),
+              _numThreads(1) {
         try {
             _noGoodPixelsMask = lsst::afw::image::Mask<>::getPlaneBitMask("NO_DATA");
         } catch (lsst::pex::exceptions::InvalidParameterError const &) {
@@ -138,6 +147,9 @@ public:
     bool getWeighted() const noexcept { return _useWeights == WEIGHTS_TRUE ? true : false; }
     bool getWeightedIsSet() const noexcept { return _useWeights != WEIGHTS_NONE ? true : false; }
     bool getCalcErrorFromInputVariance() const noexcept { return _calcErrorFromInputVariance; }
+    QuantileAlgorithm getQuantileAlgorithm() const noexcept { return _quantileAlgorithm; }
+    bool getIncrementalClip() const noexcept { return _incrementalClip; }
+    int getNumThreads() const noexcept { return _numThreads; }
 
     void setNumSigmaClip(double numSigmaClip) {
         assert(numSigmaClip > 0);
@@ -154,6 +166,40 @@ public:
     void setCalcErrorFromInputVariance(bool calcErrorFromInputVariance) noexcept {
         _calcErrorFromInputVariance = calcErrorFromInputVariance;
     }
+    /**
+     * Set the algorithm used to find the median and quartiles
+     *
+     * QUANTILE_RADIX_SELECT makes a pass through the image for each 16 bits of the pixel type
+     * rather than copying the good pixels, and needs at most a few MB of workspace whatever the
+     * size of the image.  It returns identical results for floating-point images; for integer images
+     * the ties are resolved using the counts over the whole image (as is done when only the MEDIAN
+     * is requested), so the quartiles may differ slightly.
+     */
+    void setQuantileAlgorithm(QuantileAlgorithm quantileAlgorithm) noexcept {
+        _quantileAlgorithm = quantileAlgorithm;
+    }
+    /**
+     * Clip a sorted copy of the good pixels, rather than passing through the image once per iteration
+     *
+     * The pixels within each clipping range are a contiguous run of the sorted copy, so after the first
+     * iteration only the pixels entering or leaving the run need be examined.  The results are the same
+     * (up to rounding); it is ignored for weighted statistics and errors from the input variance.
+     */
+    void setIncrementalClip(bool incrementalClip) noexcept { _incrementalClip = incrementalClip; }
+    /**
+     * Set the number of threads used to pass through the image
+     *
+     * The rows are split into one band per thread, and the sums (or histograms, for
+     * QUANTILE_RADIX_SELECT) from each band are combined in a fixed order, so the results are
+     * reproducible for a given number of threads; they may differ in the last bits from those with
+     * a different number of threads.  Small images are always processed by a single thread.
+     *
+     * @param numThreads number of threads; 0 means one per hardware thread
+     */
+    void setNumThreads(int numThreads) {
+        assert(numThreads >= 0);
+        _numThreads = numThreads;
+    }
 
 private:
     friend class Statistics;
@@ -167,6 +213,9 @@ private:
     bool _calcErrorFromInputVariance;  // Calculate errors from the input variances, if available
     std::vector<double> _maskPropagationThresholds;  // Thresholds for when to propagate mask bits,
                                                      // treated like a dict (unset bits are set to 1.0)
+    QuantileAlgorithm _quantileAlgorithm;  // How to find the median and quartiles
+    bool _incrementalClip;                 // Clip a sorted copy of the pixels
+    int _numThreads;                       // Number of threads to use (0: one per hardware thread)
 };
 
 /**
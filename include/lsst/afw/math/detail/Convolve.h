@@ -36,6 +36,7 @@
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/ConvolveImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 #define IS_INSTANCE(A, B) (dynamic_cast<B const*>(&(A)) != NULL)
 
@@ -85,6 +86,9 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
  * A version of basicConvolve that should be used when convolving a LinearCombinationKernel
  *
  * The Algorithm:
+ * - If the kernel is spatially varying and convolutionControl asks for the BASIS_IMAGES algorithm
+ *   then uses convolveWithBasis
+ * - If shouldConvolveWithFft is true then convolves using FFTs (see convolveWithFft)
  * - If the kernel is spatially varying and contains only DeltaFunctionKernels
  *   then convolves the input Image by each basis kernel in turn, solves the spatial model
  *   for that component and adds in the appropriate amount of the convolved %image.
@@ -148,6 +152,94 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
                             lsst::afw::math::Kernel const& kernel,
                             lsst::afw::math::ConvolutionControl const& convolutionControl);
 
+/**
+ * Convolve an Image or MaskedImage with a Kernel using FFTs.
+ *
+ * The good region of the output is divided into tiles; the input pixels needed by each tile are
+ * Fourier transformed, multiplied by the transform of the kernel image and transformed back.
+ * MaskedImage variances are convolved in the same way using the square of the kernel, and masks are
+ * smeared in real space (by every nonzero kernel pixel, just as for convolveWithBruteForce).
+ *
+ * If the kernel is a spatially varying LinearCombinationKernel then the input is convolved with each basis
+ * kernel, and the results are combined using the kernel parameters evaluated at each output pixel.
+ * This is exact, but the variance needs one convolution for each pair of basis kernels.  In this case
+ * the mask is smeared by every pixel that is nonzero in any basis kernel.
+ *
+ * convolvedImage must be the same size as inImage, and has the same unset border as for
+ * convolveWithBruteForce.  Input pixels must be finite: a NaN or infinity would spread over a whole tile.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws lsst::pex::exceptions::InvalidParameterError if the kernel is spatially varying but isn't a
+ *         LinearCombinationKernel
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ *
+ * @warning Low-level convolution function that does not set edge pixels.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage,
+                     lsst::afw::math::Kernel const& kernel,
+                     lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Convolve an Image or MaskedImage with a spatially varying LinearCombinationKernel by convolving
+ * with each basis kernel in turn.
+ *
+ * The good region of the output is split into bands of rows, which are processed in parallel using
+ * convolutionControl.getNumThreads() threads.  For each band the input is convolved with each basis kernel
+ * (using basicConvolve, so delta function, separable and large kernels use their fast paths), and the
+ * results are summed with weights given by the kernel's spatial model at each pixel; if requested,
+ * the result is then normalized by the kernel sum at that pixel.
+ *
+ * MaskedImage variances are computed exactly, which needs a convolution of the variance for each pair
+ * of basis kernels whose product is nonzero (only one for each basis kernel if they don't overlap,
+ * e.g. delta functions).  The output mask is the OR of the masks smeared by each basis kernel whose
+ * weight is nonzero at that pixel.
+ *
+ * convolvedImage must be the same size as inImage, and has the same unset border as for
+ * convolveWithBruteForce.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if any basis kernel is spatially varying
+ * @throws lsst::pex::exceptions::OverflowError if normalizing and the kernel sum is 0 at some pixel
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ *
+ * @warning Low-level convolution function that does not set edge pixels.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithBasis(OutImageT& convolvedImage, InImageT const& inImage,
+                       lsst::afw::math::LinearCombinationKernel const& kernel,
+                       lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Should convolveWithFft be used for this convolution?
+ *
+ * Returns true if convolutionControl allows FFTs for a kernel this large, FFTs are expected to be faster
+ * than real-space convolution, the output pixels are floating point (so there is no per-pixel rounding
+ * to reproduce), and all the input pixels (and variances) are finite.
+ *
+ * @param[in] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ */
+template <typename OutImageT, typename InImageT>
+bool shouldConvolveWithFft(OutImageT const& convolvedImage, InImageT const& inImage,
+                           lsst::afw::math::Kernel const& kernel,
+                           lsst::afw::math::ConvolutionControl const& convolutionControl);
+
 // I would prefer this to be nested in KernelImagesForRegion but SWIG doesn't support that
 class RowOfKernelImagesForRegion;
 
@@ -277,6 +369,20 @@ public:
      */
     static int getMinInterpolationSize() { return _MinInterpolationSize; };
 
+    /**
+     * Compute length of each subregion for a region divided into nDivisions pieces of approximately equal
+     * length.
+     *
+     * These are the widths and heights of the subregions computed by computeNextRow.
+     *
+     * @param length length of region
+     * @param nDivisions number of divisions of region
+     * @returns a list of subspan lengths
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if nDivisions >= length
+     */
+    static std::vector<int> computeSubregionLengths(int length, int nDivisions);
+
 private:
     typedef std::vector<Location> LocationList;
 
@@ -304,17 +410,6 @@ private:
 
     // static helper functions
     static inline int _computeNextSubregionLength(int length, int nDivisions);
-    /**
-     * Compute length of each subregion for a region divided into nDivisions pieces of approximately equal
-     * length.
-     *
-     * @param length length of region
-     * @param nDivisions number of divisions of region
-     * @returns a list of subspan lengths
-     *
-     * @throws lsst::pex::exceptions::InvalidParameterError if nDivisions >= length
-     */
-    static std::vector<int> _computeSubregionLengths(int length, int nDivisions);
 
     // member variables
     KernelConstPtr _kernelPtr;
@@ -398,6 +493,10 @@ private:
  * - for each region:
  *   - convolve it using convolveRegionWithInterpolation (which see)
  *
+ * The rows of regions are split between ConvolutionControl::getNumThreads threads.  Each thread uses
+ * its own clone of the kernel, and the regions are the same for any number of threads, so the
+ * result doesn't depend on the number of threads.
+ *
  * Note that this routine will also work with spatially invariant kernels, but not efficiently.
  *
  * @param[out] outImage convolved image = inImage convolved with kernel
@@ -450,6 +549,52 @@ void convolveRegionWithInterpolation(OutImageT& outImage, InImageT const& inImag
                                      KernelImagesForRegion const& region,
                                      ConvolveWithInterpolationWorkingImages& workingImages);
 
+/**
+ * Convolve an Image or MaskedImage in bands of rows, using ConvolutionControl::getNumThreads threads.
+ *
+ * The good region of the output is split into one band of rows per thread.  Each band is convolved by
+ * calling `convolveBand(outBand, inBand, bandKernel, bandControl)`, where:
+ * - outBand and inBand are subimages of convolvedImage and inImage that cover the band and
+ *   the rows of input it depends on, so the band is exactly their good region;
+ * - bandKernel is a clone of kernel, as computing kernel images isn't thread safe;
+ * - bandControl is a copy of convolutionControl with one thread.
+ *
+ * convolveBand must only set the good region of outBand, as the rest belongs to other bands.
+ * If only one thread is requested, convolveBand is simply called with the full images (but still with
+ * bandControl), so a convolution function can call convolveInBands with itself as convolveBand whenever
+ * its ConvolutionControl doesn't ask for exactly one thread.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve; must be the same size as convolvedImage
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ * @param[in] convolveBand callable that convolves one band, as described above
+ */
+template <typename OutImageT, typename InImageT, typename KernelT, typename ConvolveBand>
+void convolveInBands(OutImageT& convolvedImage, InImageT const& inImage, KernelT const& kernel,
+                     lsst::afw::math::ConvolutionControl const& convolutionControl,
+                     ConvolveBand convolveBand) {
+    lsst::afw::math::ConvolutionControl bandControl(convolutionControl);
+    bandControl.setNumThreads(1);
+
+    int const nThreads = resolveNumThreads(convolutionControl.getNumThreads());
+    if (nThreads <= 1 || convolvedImage.getDimensions() != inImage.getDimensions() ||
+        inImage.getWidth() < kernel.getWidth() || inImage.getHeight() <= kernel.getHeight()) {
+        convolveBand(convolvedImage, inImage, kernel, bandControl);  // which reports any errors
+        return;
+    }
+    lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(inImage.getBBox(lsst::afw::image::LOCAL));
+    parallelForChunks(goodBBox.getMinY(), goodBBox.getMaxY() + 1, nThreads, [&](int y0, int y1, int) {
+        auto const bandKernel = std::static_pointer_cast<KernelT const>(kernel.clone());
+        lsst::geom::Box2I const bandBBox(
+                lsst::geom::Point2I(0, y0 - kernel.getCtrY()),
+                lsst::geom::Extent2I(inImage.getWidth(), y1 - y0 + kernel.getHeight() - 1));
+        OutImageT outBand(convolvedImage, bandBBox, lsst::afw::image::LOCAL);
+        InImageT const inBand(inImage, bandBBox, lsst::afw::image::LOCAL);
+        convolveBand(outBand, inBand, *bandKernel, bandControl);
+    });
+}
+
 /*
  * Define inline functions
  */
@@ -0,0 +1,110 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_Parallel_h_INCLUDED
+#define LSST_AFW_MATH_DETAIL_Parallel_h_INCLUDED
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Return the number of threads to use, given a user's request
+ *
+ * @param nThreads requested number of threads; 0 means one per hardware thread
+ */
+inline int resolveNumThreads(int nThreads) {
+    if (nThreads > 0) {
+        return nThreads;
+    }
+    int const nHardware = std::thread::hardware_concurrency();
+    return nHardware > 0 ? nHardware : 1;
+}
+
+/**
+ * Split [begin, end) into nChunks contiguous ranges and process them in parallel, one thread per range
+ *
+ * `func(chunkBegin, chunkEnd, iChunk)` is called once for each range; the ranges depend only on
+ * begin, end and nChunks, so combining per-chunk results in chunk order gives results that are
+ * reproducible for a given nChunks.  The calling thread processes the first chunk, so nChunks == 1
+ * involves no threads at all.
+ *
+ * If any call throws, the exception from the lowest-numbered chunk is rethrown once every thread
+ * has finished.
+ *
+ * @param begin start of the range
+ * @param end end of the range (one past the last element)
+ * @param nChunks number of chunks; reduced to end - begin if that's smaller
+ * @param func callable with signature `void (int chunkBegin, int chunkEnd, int iChunk)`
+ *
+ * @returns the number of chunks actually used
+ */
+template <typename Function>
+int parallelForChunks(int begin, int end, int nChunks, Function func) {
+    nChunks = std::max(1, std::min(nChunks, end - begin));
+    if (nChunks == 1) {
+        func(begin, end, 0);
+        return 1;
+    }
+
+    std::vector<std::exception_ptr> errors(nChunks);
+    auto runChunk = [&](int iChunk) {
+        int const chunkBegin = begin + static_cast<long>(end - begin) * iChunk / nChunks;
+        int const chunkEnd = begin + static_cast<long>(end - begin) * (iChunk + 1) / nChunks;
+        try {
+            func(chunkBegin, chunkEnd, iChunk);
+        } catch (...) {
+            errors[iChunk] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nChunks - 1);
+    for (int i = 1; i < nChunks; ++i) {
+        threads.emplace_back(runChunk, i);
+    }
+    runChunk(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (auto const &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return nChunks;
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_Parallel_h_INCLUDED
@@ -0,0 +1,117 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_TABULATEDLANCZOSKERNEL_H
+#define LSST_AFW_MATH_DETAIL_TABULATEDLANCZOSKERNEL_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "lsst/afw/math/Kernel.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * The one-dimensional weights of a Lanczos warping kernel, tabulated on a fine grid of fractional offsets
+ *
+ * The weights at other offsets are linearly interpolated between the two nearest table entries,
+ * which avoids the trigonometric functions and virtual function calls of SeparableKernel::computeVectors.
+ * The weights match those of a LanczosWarpingKernel of the same order, for which the fractional offset
+ * is the kernel parameter; see WarpingControl::setLanczosTableSize for the accuracy.
+ *
+ * Instances are immutable, so one table may be shared between threads.
+ */
+class TabulatedLanczosKernel final {
+public:
+    /**
+     * Tabulate the weights of a Lanczos warping kernel
+     *
+     * @param[in] order  order of the Lanczos function; the kernel has 2*order weights along each axis
+     * @param[in] tableSize  number of table intervals per pixel of fractional offset
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if order < 1 or tableSize < 1
+     */
+    TabulatedLanczosKernel(int order, int tableSize);
+
+    /**
+     * Return a table for a warping kernel, or an empty pointer if the kernel cannot be tabulated
+     *
+     * @param[in] kernel  warping kernel; only a LanczosWarpingKernel is tabulated
+     * @param[in] tableSize  number of table intervals per pixel; if 0 no table is made
+     */
+    static std::shared_ptr<TabulatedLanczosKernel const> make(SeparableKernel const &kernel, int tableSize);
+
+    TabulatedLanczosKernel(TabulatedLanczosKernel const &) = default;
+    TabulatedLanczosKernel(TabulatedLanczosKernel &&) = default;
+    TabulatedLanczosKernel &operator=(TabulatedLanczosKernel const &) = default;
+    TabulatedLanczosKernel &operator=(TabulatedLanczosKernel &&) = default;
+    ~TabulatedLanczosKernel() = default;
+
+    /// Return the order of the Lanczos function
+    int getOrder() const { return _order; }
+
+    /// Return the number of table intervals per pixel
+    int getTableSize() const { return _tableSize; }
+
+    /// Return the number of weights along each axis
+    int getWidth() const { return 2 * _order; }
+
+    /**
+     * Interpolate the kernel weights along one axis
+     *
+     * @param[out] weights  kernel weights; must have room for getWidth() values
+     * @param[in] frac  fractional offset, in the range [0, 1]
+     * @returns the sum of the weights
+     */
+    double computeWeights(Kernel::Pixel *weights, double frac) const {
+        int const width = getWidth();
+        double const tablePos = frac * _tableSize;
+        int const ind = std::min(static_cast<int>(tablePos), _tableSize - 1);
+        double const interpFrac = tablePos - ind;
+        double const *lowerWeights = _weights.data() + ind * width;
+        double const *upperWeights = lowerWeights + width;
+        double sum = 0.0;
+        for (int i = 0; i < width; ++i) {
+            weights[i] = lowerWeights[i] + interpFrac * (upperWeights[i] - lowerWeights[i]);
+            sum += weights[i];
+        }
+        return sum;
+    }
+
+private:
+    int _order;
+    int _tableSize;
+    std::vector<double> _weights;  ///< getWidth() weights for each of tableSize + 1 offsets
+};
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_TABULATEDLANCZOSKERNEL_H
@@ -21,11 +21,15 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/detail/TabulatedLanczosKernel.h"
 #include "lsst/geom/Point.h"
 
 namespace lsst {
@@ -33,15 +37,77 @@ namespace afw {
 namespace math {
 namespace detail {
 
+/**
+ * Raw access to the rows of an %image plane, for loops the compiler can vectorize
+ *
+ * The %image must outlive this object.
+ */
+template <typename PixelT>
+class PixelPlane final {
+public:
+    explicit PixelPlane(lsst::afw::image::Image<PixelT> const &image)
+            : _data(image.getArray().getData()), _stride(image.getArray().template getStride<0>()) {}
+
+    /// Return a pointer to pixel (x, y), where x and y are indices (relative to xy0)
+    PixelT const *getPointer(int x, int y) const { return _data + y * _stride + x; }
+
+private:
+    PixelT const *_data;
+    std::ptrdiff_t _stride;
+};
+
+/**
+ * Raw access to the %image plane, and variance plane if present, of a warping source %image
+ */
+template <typename ImageT>
+struct SourcePlanes;
+
+template <typename PixelT>
+struct SourcePlanes<lsst::afw::image::Image<PixelT>> {
+    explicit SourcePlanes(lsst::afw::image::Image<PixelT> const &srcImage) : image(srcImage) {}
+
+    PixelPlane<PixelT> image;
+};
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+struct SourcePlanes<lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>> {
+    explicit SourcePlanes(
+            lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const &maskedImage)
+            : image(*maskedImage.getImage()), variance(*maskedImage.getVariance()) {}
+
+    PixelPlane<ImagePixelT> image;
+    PixelPlane<VariancePixelT> variance;
+};
+
 /**
  * A functor that computes one warped pixel
+ *
+ * If a tabulated warping kernel is provided then the kernel weights are interpolated from the table
+ * and the image and variance planes are computed with a vectorizable dot product;
+ * otherwise the kernel is evaluated directly and applied using convolveAtAPoint.
  */
 template <typename DestImageT, typename SrcImageT>
 class WarpAtOnePoint final {
 public:
+    /**
+     * Construct a WarpAtOnePoint
+     *
+     * @param[in] srcImage  source %image
+     * @param[in] control  warping control; the warping kernels are used (and their parameters set)
+     *                     by this object, so each thread needs its own
+     * @param[in] padValue  value for destination pixels that cannot be computed
+     * @param[in] kernelTable  tabulated warping kernel, or an empty pointer to evaluate the kernel;
+     *                         see TabulatedLanczosKernel::make
+     * @param[in] maskKernelTable  tabulated mask warping kernel, or an empty pointer to evaluate it
+     */
     WarpAtOnePoint(SrcImageT const &srcImage, WarpingControl const &control,
-                   typename DestImageT::SinglePixel padValue)
+                   typename DestImageT::SinglePixel padValue,
+                   std::shared_ptr<TabulatedLanczosKernel const> kernelTable = nullptr,
+                   std::shared_ptr<TabulatedLanczosKernel const> maskKernelTable = nullptr)
             : _srcImage(srcImage),
+              _srcPlanes(srcImage),
+              _kernelTable(kernelTable),
+              _maskKernelTable(maskKernelTable),
               _kernelPtr(control.getWarpingKernel()),
               _maskKernelPtr(control.getMaskWarpingKernel()),
               _hasMaskKernel(control.getMaskWarpingKernel()),
@@ -52,6 +118,9 @@ public:
               _yList(_kernelPtr->getHeight()),
               _maskXList(_maskKernelPtr ? _maskKernelPtr->getWidth() : 0),
               _maskYList(_maskKernelPtr ? _maskKernelPtr->getHeight() : 0),
+              _xSqList(_kernelPtr->getWidth()),
+              _ySqList(_kernelPtr->getHeight()),
+              _colSumList(_kernelPtr->getWidth()),
               _padValue(padValue),
               _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))){};
 
@@ -84,6 +153,12 @@ public:
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
 
+            if (_kernelTable) {
+                double const imageSum = _applyWeights(_srcPlanes.image, srcStartX, srcStartY, _xList, _yList);
+                *destXIter = static_cast<typename DestImageT::Pixel>(imageSum * relativeArea / kSum);
+                return true;
+            }
+
             typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
 
             *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
@@ -126,40 +201,35 @@ public:
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
 
-            typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
+            if (_kernelTable) {
+                for (std::size_t i = 0; i < _xList.size(); ++i) {
+                    _xSqList[i] = _xList[i] * _xList[i];
+                }
+                for (std::size_t i = 0; i < _yList.size(); ++i) {
+                    _ySqList[i] = _yList[i] * _yList[i];
+                }
+                double const scale = relativeArea / kSum;
+                double const imageSum = _applyWeights(_srcPlanes.image, srcStartX, srcStartY, _xList, _yList);
+                double const varianceSum =
+                        _applyWeights(_srcPlanes.variance, srcStartX, srcStartY, _xSqList, _ySqList);
+                destXIter.image() = static_cast<typename DestImageT::Image::Pixel>(imageSum * scale);
+                destXIter.variance() =
+                        static_cast<typename DestImageT::Variance::Pixel>(varianceSum * scale * scale);
+                destXIter.mask() = _computeMask(srcStartX, srcStartY, _xList, _yList);
+            } else {
+                typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
 
-            *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
-            *destXIter *= relativeArea / kSum;
+                *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
+                *destXIter *= relativeArea / kSum;
+            }
 
             if (_hasMaskKernel) {
                 // compute mask value based on the mask kernel (replacing the value computed above)
                 int maskStartX = srcIndFracX.first - _maskKernelCtr[0];
                 int maskStartY = srcIndFracY.first - _maskKernelCtr[1];
 
-                typename SrcImageT::Mask::const_xy_locator srcMaskLoc =
-                        _srcImage.getMask()->xy_at(maskStartX, maskStartY);
-
-                typedef typename std::vector<lsst::afw::math::Kernel::Pixel>::const_iterator k_iter;
-
-                typename DestImageT::Mask::SinglePixel destMaskValue = 0;
-                for (k_iter kernelYIter = _maskYList.begin(), yEnd = _maskYList.end(); kernelYIter != yEnd;
-                     ++kernelYIter) {
-                    typename DestImageT::Mask::SinglePixel destMaskValueY = 0;
-                    for (k_iter kernelXIter = _maskXList.begin(), xEnd = _maskXList.end();
-                         kernelXIter != xEnd; ++kernelXIter, ++srcMaskLoc.x()) {
-                        typename lsst::afw::math::Kernel::Pixel const kValX = *kernelXIter;
-                        if (kValX != 0) {
-                            destMaskValueY |= *srcMaskLoc;
-                        }
-                    }
-
-                    double const kValY = *kernelYIter;
-                    if (kValY != 0) {
-                        destMaskValue |= destMaskValueY;
-                    }
-
-                    srcMaskLoc += lsst::afw::image::detail::difference_type(-_maskXList.size(), 1);
-                }
+                typename DestImageT::Mask::SinglePixel destMaskValue =
+                        _computeMask(maskStartX, maskStartY, _maskXList, _maskYList);
 
                 destXIter.mask() = (destXIter.mask() & _growFullMask) | destMaskValue;
             }
@@ -179,16 +249,94 @@ private:
      */
     double _setFracIndex(double xFrac, double yFrac) {
         std::pair<double, double> srcFracInd(xFrac, yFrac);
-        _kernelPtr->setKernelParameters(srcFracInd);
-        double kSum = _kernelPtr->computeVectors(_xList, _yList, false);
-        if (_maskKernelPtr) {
+        double kSum;
+        if (_kernelTable) {
+            kSum = _kernelTable->computeWeights(_xList.data(), xFrac) *
+                   _kernelTable->computeWeights(_yList.data(), yFrac);
+        } else {
+            _kernelPtr->setKernelParameters(srcFracInd);
+            kSum = _kernelPtr->computeVectors(_xList, _yList, false);
+        }
+        if (_maskKernelTable) {
+            _maskKernelTable->computeWeights(_maskXList.data(), xFrac);
+            _maskKernelTable->computeWeights(_maskYList.data(), yFrac);
+        } else if (_maskKernelPtr) {
             _maskKernelPtr->setKernelParameters(srcFracInd);
             _maskKernelPtr->computeVectors(_maskXList, _maskYList, false);
         }
         return kSum;
     }
 
+    /**
+     * Apply separable kernel weights to one plane of the source %image
+     *
+     * The sum is accumulated one kernel row at a time into a sum for each kernel column,
+     * so the inner loop has no dependency between iterations and can be vectorized.
+     *
+     * @param[in] plane  source %image plane
+     * @param[in] startX, startY  index of the source pixel under kernel pixel (0, 0)
+     * @param[in] xList, yList  kernel weights along x and y
+     * @returns the weighted sum of the pixels
+     */
+    template <typename PixelT>
+    double _applyWeights(PixelPlane<PixelT> const &plane, int startX, int startY,
+                         std::vector<double> const &xList, std::vector<double> const &yList) {
+        int const width = xList.size();
+        int const height = yList.size();
+        double *colSums = _colSumList.data();
+        std::fill(colSums, colSums + width, 0.0);
+        for (int y = 0; y < height; ++y) {
+            PixelT const *srcPtr = plane.getPointer(startX, startY + y);
+            double const yWeight = yList[y];
+            for (int x = 0; x < width; ++x) {
+                colSums[x] += yWeight * srcPtr[x];
+            }
+        }
+        double sum = 0.0;
+        for (int x = 0; x < width; ++x) {
+            sum += xList[x] * colSums[x];
+        }
+        return sum;
+    }
+
+    /**
+     * Compute the OR of the source mask pixels under the nonzero pixels of a separable kernel
+     *
+     * @param[in] startX, startY  index of the source pixel under kernel pixel (0, 0)
+     * @param[in] xList, yList  kernel weights along x and y
+     */
+    typename DestImageT::Mask::SinglePixel _computeMask(int startX, int startY,
+                                                        std::vector<double> const &xList,
+                                                        std::vector<double> const &yList) {
+        typename SrcImageT::Mask::const_xy_locator srcMaskLoc = _srcImage.getMask()->xy_at(startX, startY);
+
+        typedef typename std::vector<lsst::afw::math::Kernel::Pixel>::const_iterator k_iter;
+
+        typename DestImageT::Mask::SinglePixel destMaskValue = 0;
+        for (k_iter kernelYIter = yList.begin(), yEnd = yList.end(); kernelYIter != yEnd; ++kernelYIter) {
+            typename DestImageT::Mask::SinglePixel destMaskValueY = 0;
+            for (k_iter kernelXIter = xList.begin(), xEnd = xList.end(); kernelXIter != xEnd;
+                 ++kernelXIter, ++srcMaskLoc.x()) {
+                typename lsst::afw::math::Kernel::Pixel const kValX = *kernelXIter;
+                if (kValX != 0) {
+                    destMaskValueY |= *srcMaskLoc;
+                }
+            }
+
+            double const kValY = *kernelYIter;
+            if (kValY != 0) {
+                destMaskValue |= destMaskValueY;
+            }
+
+            srcMaskLoc += lsst::afw::image::detail::difference_type(-xList.size(), 1);
+        }
+        return destMaskValue;
+    }
+
     SrcImageT _srcImage;
+    SourcePlanes<SrcImageT> _srcPlanes;
+    std::shared_ptr<TabulatedLanczosKernel const> _kernelTable;
+    std::shared_ptr<TabulatedLanczosKernel const> _maskKernelTable;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _kernelPtr;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _maskKernelPtr;
     bool _hasMaskKernel;
@@ -199,6 +347,9 @@ private:
     std::vector<double> _yList;
     std::vector<double> _maskXList;
     std::vector<double> _maskYList;
+    std::vector<double> _xSqList;     ///< squared kernel weights along x, for tabulated variance
+    std::vector<double> _ySqList;     ///< squared kernel weights along y, for tabulated variance
+    std::vector<double> _colSumList;  ///< sum for each kernel column, used by _applyWeights
     typename DestImageT::SinglePixel _padValue;
     lsst::geom::Box2I const _srcGoodBBox;
 };
@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
@@ -273,7 +274,10 @@ public:
               _maskWarpingKernelPtr(),
               _cacheSize(cacheSize),
               _interpLength(interpLength),
-              _growFullMask(growFullMask) {
+              _growFullMask(growFullMask),
+              _numThreads(1),
+              _lanczosTableSize(0),
+              _interpTolerance(0.0) {
         setMaskWarpingKernelName(maskWarpingKernelName);
     }
 
@@ -315,6 +319,28 @@ public:
         _interpLength = interpLength;
     };
 
+    /**
+     * get the tolerance for adaptive interpolation (source pixels); 0 if interpolation is not adaptive
+     */
+    double getInterpTolerance() const { return _interpTolerance; }
+
+    /**
+     * set the tolerance for adaptive interpolation
+     *
+     * If interpTolerance and interpLength are both nonzero then interpolation is adaptive:
+     * the destination %image is divided into cells interpLength pixels on a side, and each cell
+     * is recursively split in half (along each axis longer than one pixel) until linear interpolation
+     * of the source position across the cell agrees with the exact source position to within
+     * interpTolerance source pixels. The error of a cell is estimated at the points at which it would
+     * be split: the midpoints of its edges and its center. Thus interpLength can be large
+     * (e.g. 256 pixels) and the exact transform is only evaluated often where the distortion requires it.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if interpTolerance < 0
+     */
+    void setInterpTolerance(double interpTolerance  ///< interpolation tolerance (source pixels);
+                                                    ///< 0 for a fixed interpolation length
+    );
+
     /**
      * get the warping kernel
      */
@@ -373,6 +399,49 @@ public:
         _growFullMask = growFullMask;
     }
 
+    /**
+     * get the number of threads to use; 0 means one per hardware thread
+     */
+    int getNumThreads() const { return _numThreads; }
+
+    /**
+     * set the number of threads to use
+     *
+     * The destination %image is split into bands of rows, which are warped in parallel, each thread
+     * using its own copy of the warping kernels.  The transform between destination and source pixels
+     * is only evaluated by the calling thread.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void setNumThreads(int numThreads  ///< number of threads; 0 for one per hardware thread
+    );
+
+    /**
+     * get the number of table intervals per pixel for tabulated Lanczos kernels; 0 if not tabulated
+     */
+    int getLanczosTableSize() const { return _lanczosTableSize; }
+
+    /**
+     * set the number of table intervals per pixel for tabulated Lanczos kernels
+     *
+     * If nonzero, the weights of Lanczos warping kernels (and Lanczos mask warping kernels) are
+     * linearly interpolated from a table of weights computed every 1/lanczosTableSize pixel of
+     * fractional offset, and the warped pixels are computed with a dot product that the compiler
+     * can vectorize. This is much faster than evaluating the kernel for every pixel, and it supersedes
+     * the kernel cache (see setCacheSize) for Lanczos kernels. Other kinds of kernel are not tabulated.
+     *
+     * Each tabulated weight is within pi^2 (1 + 1/order^2) / (24 lanczosTableSize^2) of the exact weight
+     * (the error bound of linear interpolation), which is 4.9e-7 for a table size of 1024 and order >= 2.
+     * The resulting error in a warped %image pixel is less than 16 order times that bound, times
+     * the largest absolute value of the source pixels under the kernel; in practice it is a few times
+     * the bound. Variance is computed with the same weights and the mask is computed as usual.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if lanczosTableSize < 0
+     */
+    void setLanczosTableSize(int lanczosTableSize  ///< table intervals per pixel, e.g. 1024;
+                                                   ///< 0 to evaluate the kernels exactly
+    );
+
 private:
     /**
      * Throw an exception if the two kernels are not compatible in shape
@@ -389,6 +458,9 @@ private:
     int _cacheSize;
     int _interpLength;
     lsst::afw::image::MaskPixel _growFullMask;
+    int _numThreads;
+    int _lanczosTableSize;
+    double _interpTolerance;
 };
 
 /**
@@ -410,6 +482,45 @@ int warpExposure(
         ///< use this value for undefined (edge) pixels
 );
 
+/**
+ * One exposure warped by warpExposures()
+ */
+template <typename ExposureT>
+struct WarpedExposure {
+    std::shared_ptr<ExposureT> exposure;  ///< warped exposure
+    /// NO_DATA is set for each pixel of exposure that could not be computed from the source exposure
+    std::shared_ptr<image::Mask<image::MaskPixel>> coverage;
+    int numGoodPixels;  ///< number of pixels that could be computed
+};
+
+/**
+ * Warp (remap) many exposures onto the same destination pixel grid.
+ *
+ * The result for each source exposure is the same as that of warpExposure() to a new exposure
+ * with bounding box destBBox and WCS destWcs, but the destination-side transform and the setup of the
+ * warping kernels are shared between exposures. The exposures are warped concurrently
+ * using control.getNumThreads() threads; the transforms are copied on the calling thread, so
+ * each thread evaluates only its own copies. If there are more threads than exposures, the spare threads
+ * warp bands of rows of each exposure as described for WarpingControl::setNumThreads.
+ *
+ * @param[in] destWcs  WCS of the warped exposures; shared by all of them
+ * @param[in] destBBox  bounding box of the warped exposures
+ * @param[in] srcExposures  exposures to warp; each must have a WCS
+ * @param[in] control  control parameters
+ * @param[in] padValue  value used for pixels that cannot be computed
+ * @returns one WarpedExposure for each source exposure, in the same order
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if destWcs or any source exposure has no WCS
+ */
+template <typename DestExposureT, typename SrcExposureT>
+std::vector<WarpedExposure<DestExposureT>> warpExposures(
+        std::shared_ptr<geom::SkyWcs const> const &destWcs, lsst::geom::Box2I const &destBBox,
+        std::vector<std::shared_ptr<SrcExposureT>> const &srcExposures, WarpingControl const &control,
+        typename DestExposureT::MaskedImageT::SinglePixel padValue =
+                lsst::afw::math::edgePixel<typename DestExposureT::MaskedImageT>(
+                        typename lsst::afw::image::detail::image_traits<
+                                typename DestExposureT::MaskedImageT>::image_category()));
+
 /**
  * @brief Warp an Image or MaskedImage to a new Wcs. See also convenience function
  * warpExposure() to warp an Exposure.
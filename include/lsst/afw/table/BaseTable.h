@@ -2,6 +2,7 @@
 #ifndef AFW_TABLE_BaseTable_h_INCLUDED
 #define AFW_TABLE_BaseTable_h_INCLUDED
 #include <memory>
+#include <vector>
 
 #include "lsst/base.h"
 #include "ndarray/Manager.h"
@@ -33,6 +34,7 @@ struct RecordData {
     void * data;
     std::shared_ptr<BaseTable> table;
     ndarray::Manager::Ptr manager;
+    bool initialized = false;  // if true, data already holds valid field values (e.g. from a mapped file)
 };
 
 } // namespace detail
@@ -72,9 +74,29 @@ public:
     /// Template of CatalogT used to hold const records of the associated type.
     typedef CatalogT<Record const> ConstCatalog;
 
-    /// Number of records in each memory block.
+    /**
+     *  Number of records in the first memory block a table allocates on its own.
+     *
+     *  Each later block a table allocates on its own is twice as large as the one before, up to
+     *  maxBytesPerBlock, so a catalog built a record at a time ends up in a handful of blocks.
+     *  Blocks allocated by preallocate() have exactly the requested size.
+     *
+     *  A block is freed only when none of its records are left, and a table keeps the size it has
+     *  grown to for as long as it lives, so a table shared by many catalogs (e.g. the one
+     *  PeakTable::make returns) may keep a whole block of up to maxBytesPerBlock alive for a single
+     *  surviving record.
+     */
     static int nRecordsPerBlock;
 
+    /**
+     *  Maximum size (in bytes) of the memory blocks a table allocates on its own (1 MiB by default),
+     *  unless nRecordsPerBlock records are larger.
+     *
+     *  Larger values mean fewer blocks for large catalogs, but more memory retained by a surviving
+     *  record; see nRecordsPerBlock.
+     */
+    static std::size_t maxBytesPerBlock;
+
     /// Return the flexible metadata associated with the table.  May be null.
     std::shared_ptr<daf::base::PropertyList> getMetadata() const { return _metadata; }
 
@@ -218,12 +240,23 @@ protected:
 
 private:
     friend class BaseRecord;
+    template <typename RecordT>
+    friend class CatalogT;
     friend class io::FitsWriter;
+    friend class io::MappedFile;
     friend class AliasMap;
 
     // Obtain raw data pointers and their managing objects for a new record.
     detail::RecordData _makeNewRecordData();
 
+    // Move the data of the given records (which must belong to this table) into a new block, in order.
+    // See CatalogT::compact.
+    void _compact(std::vector<BaseRecord*> const& records);
+
+    // Make the next nRecords records view existing, already-initialized record data instead of
+    // allocating new memory; owner keeps that memory alive.  See io::MappedFile.
+    void _useRecordData(void* data, std::size_t nRecords, ndarray::Manager::Ptr const& owner);
+
     /*
      *  Called by BaseRecord dtor to notify the table when it is about to be destroyed.
      *
@@ -242,6 +275,7 @@ private:
     // All these are definitely private, not protected - we don't want derived classes mucking with them.
     Schema _schema;                                      // schema that defines the table's fields
     ndarray::Manager::Ptr _manager;                      // current memory block to use for new records
+    std::size_t _blockRecordCount = 0;                   // number of records in the last block we sized
     std::shared_ptr<daf::base::PropertyList> _metadata;  // flexible metadata; may be null
 };
 
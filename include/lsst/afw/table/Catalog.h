@@ -14,6 +14,7 @@
 #include "lsst/afw/table/fwd.h"
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/io/FitsReader.h"
+#include "lsst/afw/table/io/MappedFile.h"
 #include "lsst/afw/table/SchemaMapper.h"
 
 namespace lsst {
@@ -369,6 +370,58 @@ public:
         return io::FitsReader::apply<CatalogT>(fitsfile, flags);
     }
 
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a regular file.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static CatalogT readFits(std::string const& filename, io::FitsReadSelection const& selection,
+                             int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<CatalogT>(filename, selection, hdu, flags);
+    }
+
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static CatalogT readFits(fits::MemFileManager& manager, io::FitsReadSelection const& selection,
+                             int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<CatalogT>(manager, selection, hdu, flags);
+    }
+
+    /**
+     *  Write the catalog to a file in afw::table's native record layout, which can be memory-mapped.
+     *
+     *  @param[in] filename    Name of the file to write.
+     *
+     *  @see io::MappedFile
+     */
+    void writeMapped(std::string const& filename) const { io::MappedFile::write(filename, *this); }
+
+    /**
+     *  Read a catalog written by writeMapped, by mapping the file into memory instead of copying it.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *
+     *  @see io::MappedFile
+     */
+    static CatalogT readMapped(std::string const& filename) {
+        return io::MappedFile::read<CatalogT>(filename);
+    }
+
     /**
      *  Return a ColumnView of this catalog's records.
      *
@@ -387,6 +440,34 @@ public:
     /// Return true if all records are contiguous.
     bool isContiguous() const { return ColumnView::isRangeContiguous(_table, begin(), end()); }
 
+    /**
+     *  Move the data of all records into a single new block of memory, making the catalog contiguous.
+     *
+     *  The records themselves are not replaced, so other references to them remain valid and see
+     *  their data in its new location; column views made before the move, however, still view the
+     *  old memory.  This is a no-op if the catalog is already contiguous.
+     *
+     *  @throws pex::exceptions::LogicError if some records belong to a different table, or the
+     *          catalog holds a record more than once.
+     */
+    void compact() {
+        // Check ownership first, as a catalog of another table's records may be contiguous too.
+        for (auto const& record : _internal) {
+            if (record->getTable().get() != _table.get()) {
+                throw LSST_EXCEPT(pex::exceptions::LogicError,
+                                  "Cannot compact a catalog with records that belong to another table.");
+            }
+        }
+        if (isContiguous()) return;
+        std::vector<BaseRecord*> records;
+        records.reserve(_internal.size());
+        for (auto const& record : _internal) {
+            // Moving the data of a const record doesn't change its values.
+            records.push_back(const_cast<typename std::remove_const<RecordT>::type*>(record.get()));
+        }
+        _table->_compact(records);
+    }
+
     //@{
     /**
      *  Iterator access.
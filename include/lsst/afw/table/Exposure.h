@@ -414,6 +414,38 @@ public:
         return io::FitsReader::apply<ExposureCatalogT>(fitsfile, flags);
     }
 
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a regular file.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static ExposureCatalogT readFits(std::string const& filename, io::FitsReadSelection const& selection,
+                                     int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<ExposureCatalogT>(filename, selection, hdu, flags);
+    }
+
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static ExposureCatalogT readFits(fits::MemFileManager& manager, io::FitsReadSelection const& selection,
+                                     int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<ExposureCatalogT>(manager, selection, hdu, flags);
+    }
+
     /**
      *  Read a FITS binary table from a file object already at the correct extension.
      *
@@ -425,6 +457,18 @@ public:
         return io::FitsReader::apply<ExposureCatalogT>(fitsfile, flags, archive);
     }
 
+    /**
+     *  Read a catalog written by writeMapped, by mapping the file into memory instead of copying it.
+     *
+     *  Only the regular fields of the records are read; their Psfs, Wcss and other objects are not
+     *  saved in mapped files.
+     *
+     *  @param[in] filename    Name of the file to read.
+     */
+    static ExposureCatalogT readMapped(std::string const& filename) {
+        return io::MappedFile::read<ExposureCatalogT>(filename);
+    }
+
     /**
      *  Convenience output function for Persistables that contain an ExposureCatalog.
      *
@@ -153,6 +153,49 @@ public:
         return io::FitsReader::apply<SortedCatalogT>(fitsfile, flags);
     }
 
+    /**
+     *  Read a catalog written by writeMapped, by mapping the file into memory instead of copying it.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *
+     *  @see io::MappedFile
+     */
+    static SortedCatalogT readMapped(std::string const& filename) {
+        return io::MappedFile::read<SortedCatalogT>(filename);
+    }
+
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a regular file.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static SortedCatalogT readFits(std::string const& filename, io::FitsReadSelection const& selection,
+                                   int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<SortedCatalogT>(filename, selection, hdu, flags);
+    }
+
+    /**
+     *  Read some of the fields and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] selection   The fields and the range of rows to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     */
+    static SortedCatalogT readFits(fits::MemFileManager& manager, io::FitsReadSelection const& selection,
+                                   int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<SortedCatalogT>(manager, selection, hdu, flags);
+    }
+
     /**
      *  Return the subset of a catalog corresponding to the True values of the given mask array.
      *
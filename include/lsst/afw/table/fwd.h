@@ -114,6 +114,7 @@ class Writer;
 class Reader;
 class FitsWriter;
 class FitsReader;
+class MappedFile;
 class Persistable;
 class InputArchive;
 class OutputArchive;
@@ -2,7 +2,12 @@
 #ifndef AFW_TABLE_IO_FitsReader_h_INCLUDED
 #define AFW_TABLE_IO_FitsReader_h_INCLUDED
 
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
@@ -16,6 +21,37 @@ namespace afw {
 namespace table {
 namespace io {
 
+/**
+ *  A subset of the fields and rows of a FITS binary table, to be read by FitsReader::apply.
+ *
+ *  Only the columns of the selected fields are decoded, and the Schema of the new catalog contains
+ *  only those fields (in their on-disk order).  Fields required by the table class (e.g. the minimal
+ *  schema of SourceTable) are always read.  Columns read by table-specific readers (such as
+ *  SourceRecord Footprints) are controlled by the usual ioFlags instead.
+ *
+ *  When rows are read as blocks of raw bytes, whole rows are still read from disk, including the
+ *  bytes of unselected columns: a selection saves decoding and memory, not I/O.
+ */
+struct FitsReadSelection {
+    /// Names of the fields to read; if both this and prefixes are empty, all fields are read.
+    std::vector<std::string> fields;
+
+    /// Prefixes of the names of additional fields to read (e.g. "base_PsfFlux_").
+    std::vector<std::string> prefixes;
+
+    /// Index of the first row to read.
+    std::size_t firstRow = 0;
+
+    /// Maximum number of rows to read.
+    std::size_t maxRows = std::numeric_limits<std::size_t>::max();
+
+    /// Return true if all fields are selected.
+    bool selectsAllFields() const { return fields.empty() && prefixes.empty(); }
+
+    /// Return true if the field with the given name is selected.
+    bool selectsField(std::string const& name) const;
+};
+
 /**
  *  A utility class for reading FITS binary tables.
  *
@@ -70,10 +106,27 @@ public:
     template <typename ContainerT>
     static ContainerT apply(afw::fits::Fits& fits, int ioFlags,
                             std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+        return apply<ContainerT>(fits, FitsReadSelection(), ioFlags, archive);
+    }
+
+    /**
+     *  Create a new Catalog by reading some of the fields and rows of a FITS binary table.
+     *
+     *  @param[in]  fits       An afw::fits::Fits helper that points to a FITS binary table HDU.
+     *  @param[in]  selection  The fields and range of rows to read.
+     *  @param[in]  ioFlags    A set of subclass-dependent bitflags; see the other overload.
+     *  @param[in]  archive    An archive of Persistables; see the other overload.
+     */
+    template <typename ContainerT>
+    static ContainerT apply(afw::fits::Fits& fits, FitsReadSelection const& selection, int ioFlags,
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
         std::shared_ptr<daf::base::PropertyList> metadata = std::make_shared<daf::base::PropertyList>();
         fits.readMetadata(*metadata, true);
         FitsReader const* reader = _lookupFitsReader(*metadata);
         FitsSchemaInputMapper mapper(*metadata, true);
+        if (!selection.selectsAllFields()) {
+            reader->_setupSelection(mapper, selection, ioFlags);
+        }
         reader->_setupArchive(fits, mapper, archive, ioFlags);
         std::shared_ptr<BaseTable> table = reader->makeTable(mapper, metadata, ioFlags, true);
         ContainerT container(std::dynamic_pointer_cast<typename ContainerT::Table>(table));
@@ -81,8 +134,10 @@ public:
             throw LSST_EXCEPT(pex::exceptions::RuntimeError, "Invalid table class for catalog.");
         }
         std::size_t nRows = fits.countRows();
-        container.reserve(nRows);
-        for (std::size_t row = 0; row < nRows; ++row) {
+        std::size_t firstRow = std::min(selection.firstRow, nRows);
+        std::size_t endRow = firstRow + std::min(selection.maxRows, nRows - firstRow);
+        container.reserve(endRow - firstRow);
+        for (std::size_t row = firstRow; row < endRow; ++row) {
             mapper.readRecord(
                     // We need to be able to support reading Catalog<T const>, since it shares the same
                     // template
@@ -108,6 +163,20 @@ public:
         return apply<ContainerT>(fits, ioFlags, archive);
     }
 
+    /**
+     *  Create a new Catalog by reading some of the fields and rows of a FITS file.
+     *
+     *  This is a simply a convenience function that creates an afw::fits::Fits object from either
+     *  a string filename or a afw::fits::MemFileManager, then calls the other apply() overload.
+     */
+    template <typename ContainerT, typename SourceT>
+    static ContainerT apply(SourceT& source, FitsReadSelection const& selection, int hdu, int ioFlags,
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+        afw::fits::Fits fits(source, "r", afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
+        fits.setHdu(hdu);
+        return apply<ContainerT>(fits, selection, ioFlags, archive);
+    }
+
     /**
      *  Callback to create a Table object from a FITS binary table schema.
      *
@@ -137,11 +206,20 @@ public:
      */
     virtual bool usesArchive(int ioFlags) const { return false; }
 
+    /**
+     *  Callback that should return the names of the fields the Table subclass requires, which are
+     *  read even when a FitsReadSelection does not include them.
+     */
+    virtual std::set<std::string> getRequiredFields(int ioFlags) const { return std::set<std::string>(); }
+
     virtual ~FitsReader() = default;
 
 private:
     static FitsReader const* _lookupFitsReader(daf::base::PropertyList const& metadata);
 
+    void _setupSelection(FitsSchemaInputMapper& mapper, FitsReadSelection const& selection,
+                         int ioFlags) const;
+
     void _setupArchive(afw::fits::Fits& fits, FitsSchemaInputMapper& mapper,
                        std::shared_ptr<InputArchive> archive, int ioFlags) const;
 };
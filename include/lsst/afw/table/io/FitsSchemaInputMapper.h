@@ -2,6 +2,12 @@
 #ifndef AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 #define AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -13,6 +19,22 @@ namespace afw {
 namespace table {
 namespace io {
 
+/**
+ *  A block of consecutive FITS binary table rows, read as raw bytes.
+ *
+ *  The values are in the FITS representation; see afw::fits::Fits::getTableColumnOffsets for which
+ *  columns can be decoded directly.
+ */
+struct FitsRowBlock {
+    std::size_t firstRow = 0;                  // index of the first row in the block
+    std::size_t nRows = 0;                     // number of rows in the block
+    std::size_t rowSize = 0;                   // number of bytes in each row
+    char const *data = nullptr;                // nRows*rowSize bytes
+    std::vector<std::ptrdiff_t> columnOffsets;  // byte offset of each column in a row; -1 if not decodable
+    std::vector<std::pair<char, std::size_t>> columnFormats;  // TFORM type code and repeat count of each
+                                                              // column; see Fits::getTableColumnFormats
+};
+
 /**
  *  Polymorphic reader interface used to read different kinds of objects from
  *  one or more FITS binary table columns.
@@ -41,6 +63,30 @@ public:
      */
     virtual void prepRead(std::size_t firstRow, std::size_t nRows, fits::Fits & fits) {}
 
+    /**
+     *  Optionally cache values from a block of rows that has already been read as raw bytes.
+     *
+     *  This is called instead of prepRead when the mapper reads whole rows at once.  The default
+     *  implementation ignores the block and calls prepRead.
+     *
+     *  @param[in] block    The rows, including the byte offset of each column.
+     *  @param[in] fits     FITS file manager object.
+     */
+    virtual void prepReadRows(FitsRowBlock const &block, fits::Fits &fits) {
+        prepRead(block.firstRow, block.nRows, fits);
+    }
+
+    /**
+     *  Return whether prepReadRows would decode values from raw rows with the given layout.
+     *
+     *  The mapper only reads whole rows as raw bytes if some reader (or the flag column) would use
+     *  them; otherwise each reader's prepRead would read the same rows again through cfitsio.  The
+     *  default implementation returns false.
+     *
+     *  @param[in] layout   The column offsets and formats of a block; its rows are not read yet.
+     */
+    virtual bool canReadRows(FitsRowBlock const &layout) const { return false; }
+
     /**
      *  Read values from a single row.
      *
@@ -103,6 +149,9 @@ public:
      *  nonsequential reads anyway, and it seems the per-call overload to
      *  CFITSIO is sufficiently high that it's best to do this anyway for all
      *  but the largest record sizes.
+     *
+     *  When whole rows are read as raw bytes, the number of rows per read is this number divided by
+     *  the size of the rows on disk instead, as that is the size of the buffer they are read into.
      */
     static std::size_t PREPPED_ROWS_FACTOR;
 
@@ -169,6 +218,16 @@ public:
      */
     void customize(std::unique_ptr<FitsColumnReader> reader);
 
+    /**
+     *  Restrict the regular fields added by finalize() to those whose names satisfy a predicate.
+     *
+     *  No reader is made for the columns of items the predicate rejects, so they are never decoded,
+     *  though their bytes are still read when whole rows are read at once.  Items that have already
+     *  been erased (e.g. because a FitsColumnReader passed to customize() handles them) are not
+     *  affected.
+     */
+    void select(std::function<bool(std::string const &)> predicate);
+
     /**
      *  Map any remaining items into regular Schema items, and return the final Schema.
      *
@@ -72,6 +72,7 @@ public:
         for (typename ContainerT::const_iterator i = container.begin(); i != container.end(); ++i) {
             _writeRecord(*i);
         }
+        _flushRecords();
         _finish();
     }
 
@@ -99,6 +100,9 @@ protected:
     std::size_t _row;  // which row we're currently processing
 
 private:
+    /// Write any records that are still buffered; called before _finish.
+    void _flushRecords();
+
     struct ProcessRecords;
 
     std::shared_ptr<ProcessRecords> _processor;  // a private Schema::forEach functor that write records
@@ -0,0 +1,126 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_IO_MappedFile_h_INCLUDED
+#define AFW_TABLE_IO_MappedFile_h_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ndarray/Manager.h"
+#include "lsst/afw/table/Schema.h"
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/BaseTable.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace io {
+
+/**
+ *  Reads and writes catalogs in afw::table's native, uncompressed record layout.
+ *
+ *  A mapped file holds a short header, a description of the Schema and its aliases, and then the
+ *  records exactly as they are laid out in memory (including the padding BaseTable adds to each
+ *  record), starting at a page boundary.  Reading a file maps it into memory instead of copying it:
+ *  the records of the new catalog point directly into the mapping, so opening a catalog takes the
+ *  same time regardless of its size, the catalog is contiguous (so column views work), and
+ *  processes that read the same file share its pages until they modify them.  Modifications are
+ *  private to the process (copy-on-write); they are never written back to the file.
+ *
+ *  The layout is that of the machine that wrote the file, so files can only be read on machines
+ *  with the same byte order (this is checked).  Schemas with variable-length fields cannot be
+ *  written, as those fields hold pointers.  Table metadata and first-class objects associated with
+ *  records (e.g. SourceRecord Footprints) are not saved; use FITS for those.
+ */
+class MappedFile final {
+public:
+    /**
+     *  Write a catalog to a file in the native record layout.
+     *
+     *  @param[in] filename  Name of the file to write; it is overwritten if it exists.
+     *  @param[in] catalog   Catalog to write; its records need not be contiguous.
+     *
+     *  @throws pex::exceptions::LogicError if the schema has variable-length fields.
+     *  @throws pex::exceptions::IoError if the file cannot be written.
+     */
+    template <typename ContainerT>
+    static void write(std::string const &filename, ContainerT const &catalog) {
+        std::vector<BaseRecord const *> records;
+        records.reserve(catalog.size());
+        for (auto const &record : catalog) {
+            records.push_back(&record);
+        }
+        _write(filename, catalog.getTable()->getSchema(), records);
+    }
+
+    /**
+     *  Read a catalog from a file in the native record layout, by mapping it into memory.
+     *
+     *  The returned catalog has a new table of type ContainerT::Table, whose schema is the one written
+     *  to the file.  Records keep the IDs they were written with; if the table has an IdFactory, it
+     *  is told about the largest of them.  Records added to it later are allocated as usual.
+     *
+     *  @throws pex::exceptions::IoError if the file cannot be read or mapped, or is not a mapped file
+     *          written on a compatible machine.
+     */
+    template <typename ContainerT>
+    static ContainerT read(std::string const &filename) {
+        Contents contents = _map(filename);
+        // Clone the table so that no other catalog can share the table whose next records are mapped
+        // (PeakTable::make, for instance, returns cached tables).
+        auto table = ContainerT::Table::make(contents.schema)->clone();
+        if (table->getSchema().getRecordSize() != static_cast<int>(contents.recordSize)) {
+            _throwLayoutMismatch(filename);
+        }
+        BaseTable &baseTable = *table;
+        baseTable._useRecordData(contents.data, contents.nRecords, contents.owner);
+        ContainerT catalog(table);
+        catalog.reserve(contents.nRecords);
+        // Construct the records directly instead of with makeRecord, which would overwrite their IDs
+        // with new ones from the table's IdFactory (and so copy every page of the mapping)
+        for (std::size_t i = 0; i < contents.nRecords; ++i) {
+            catalog.push_back(baseTable.constructRecord<typename ContainerT::Record>());
+        }
+        if (contents.nRecords > 0) {
+            _notifyIdFactory(*table, contents.maxId, 0);
+        }
+        return catalog;
+    }
+
+private:
+    struct Contents {
+        Schema schema;
+        std::size_t recordSize;
+        std::size_t nRecords;
+        void *data;
+        ndarray::Manager::Ptr owner;  // unmaps the file when the last record referring to it is gone
+        RecordId maxId;               // largest value of the "id" field, if there is one
+    };
+
+    // Make the table's IdFactory, if it has one, generate IDs larger than those read
+    template <typename TableT>
+    static auto _notifyIdFactory(TableT &table, RecordId maxId, int)
+            -> decltype(table.getIdFactory(), void()) {
+        if (table.getIdFactory()) {
+            table.getIdFactory()->notify(maxId);
+        }
+    }
+
+    template <typename TableT>
+    static void _notifyIdFactory(TableT &, RecordId, long) {}
+
+    static void _write(std::string const &filename, Schema const &schema,
+                       std::vector<BaseRecord const *> const &records);
+
+    static Contents _map(std::string const &filename);
+
+    [[noreturn]] static void _throwLayoutMismatch(std::string const &filename);
+};
+
+}  // namespace io
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_IO_MappedFile_h_INCLUDED
@@ -0,0 +1,107 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_IO_DETAIL_FitsElements_h_INCLUDED
+#define AFW_TABLE_IO_DETAIL_FitsElements_h_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace io {
+namespace detail {
+
+/*
+ *  @internal
+ *
+ *  Conversions between table elements and their representation in the rows of FITS binary tables,
+ *  shared by the code that writes and reads blocks of rows as raw bytes.  The FITS representation
+ *  is big-endian, with unsigned 16-bit integers stored as signed ones with TZERO = 32768, as cfitsio
+ *  does.  Fields of other types (scaled columns, strings, flags, ...) are not handled here.
+ */
+
+/// Unsigned integer type with the given size in bytes, used to reinterpret the bits of table elements.
+template <std::size_t N>
+struct UnsignedOfSize;
+template <>
+struct UnsignedOfSize<1> {
+    typedef std::uint8_t Type;
+};
+template <>
+struct UnsignedOfSize<2> {
+    typedef std::uint16_t Type;
+};
+template <>
+struct UnsignedOfSize<4> {
+    typedef std::uint32_t Type;
+};
+template <>
+struct UnsignedOfSize<8> {
+    typedef std::uint64_t Type;
+};
+
+/// Offset cfitsio applies to unsigned 16-bit values, which it stores as signed integers (TZERO = 32768).
+std::uint16_t const UINT16_FITS_OFFSET = 0x8000u;
+
+/// Store the bits of an unsigned integer in big-endian order; returns the next position.
+template <typename U>
+inline char *encodeBigEndian(U bits, char *out) {
+    for (std::size_t i = 0; i < sizeof(U); ++i) {
+        out[i] = static_cast<char>(bits >> (8 * (sizeof(U) - 1 - i)));
+    }
+    return out + sizeof(U);
+}
+
+/// Load the bits of an unsigned integer stored in big-endian order.
+template <typename U>
+inline U decodeBigEndian(char const *in) {
+    U bits = 0;
+    for (std::size_t i = 0; i < sizeof(U); ++i) {
+        bits = (bits << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return bits;
+}
+
+/// Convert table elements to their FITS representation; returns the next position.
+template <typename T>
+inline char *encodeElements(T const *in, std::size_t nElements, char *out) {
+    typedef typename UnsignedOfSize<sizeof(T)>::Type Bits;
+    for (std::size_t i = 0; i < nElements; ++i) {
+        Bits bits;
+        std::memcpy(&bits, in + i, sizeof(Bits));
+        out = encodeBigEndian(bits, out);
+    }
+    return out;
+}
+
+inline char *encodeElements(std::uint16_t const *in, std::size_t nElements, char *out) {
+    for (std::size_t i = 0; i < nElements; ++i) {
+        out = encodeBigEndian(static_cast<std::uint16_t>(in[i] ^ UINT16_FITS_OFFSET), out);
+    }
+    return out;
+}
+
+/// Convert elements from their FITS representation, as written by encodeElements.
+template <typename T>
+inline void decodeElements(char const *in, std::size_t nElements, T *out) {
+    typedef typename UnsignedOfSize<sizeof(T)>::Type Bits;
+    for (std::size_t i = 0; i < nElements; ++i, in += sizeof(T)) {
+        Bits const bits = decodeBigEndian<Bits>(in);
+        std::memcpy(out + i, &bits, sizeof(T));
+    }
+}
+
+inline void decodeElements(char const *in, std::size_t nElements, std::uint16_t *out) {
+    for (std::size_t i = 0; i < nElements; ++i, in += sizeof(std::uint16_t)) {
+        out[i] = decodeBigEndian<std::uint16_t>(in) ^ UINT16_FITS_OFFSET;
+    }
+}
+
+}  // namespace detail
+}  // namespace io
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_IO_DETAIL_FitsElements_h_INCLUDED
@@ -157,9 +157,19 @@ PyCatalog<Record> declareCatalog(utils::python::WrapperCollection &wrappers, std
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static("readFits",
+                               (Catalog(*)(std::string const &, io::FitsReadSelection const &, int, int)) &
+                                       Catalog::readFits,
+                               "filename"_a, "selection"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static("readFits",
+                               (Catalog(*)(fits::MemFileManager &, io::FitsReadSelection const &, int, int)) &
+                                       Catalog::readFits,
+                               "manager"_a, "selection"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
+                cls.def_static("readMapped", &Catalog::readMapped, "filename"_a);
 
                 /* Methods */
+                cls.def("writeMapped", &Catalog::writeMapped, "filename"_a);
                 cls.def("getTable", &Catalog::getTable);
                 cls.def_property_readonly("table", &Catalog::getTable);
                 cls.def("getSchema", &Catalog::getSchema);
@@ -200,6 +210,7 @@ PyCatalog<Record> declareCatalog(utils::python::WrapperCollection &wrappers, std
                     return self.get(utils::python::cppIndex(self.size(), i));
                 });
                 cls.def("isContiguous", &Catalog::isContiguous);
+                cls.def("_compact", &Catalog::compact);
                 cls.def("writeFits",
                         (void (Catalog::*)(std::string const &, std::string const &, int) const) &
                                 Catalog::writeFits,
@@ -87,7 +87,16 @@ PySortedCatalog<Record> declareSortedCatalog(utils::python::WrapperCollection &w
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static("readFits",
+                               (Catalog(*)(std::string const &, io::FitsReadSelection const &, int, int)) &
+                                       Catalog::readFits,
+                               "filename"_a, "selection"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static("readFits",
+                               (Catalog(*)(fits::MemFileManager &, io::FitsReadSelection const &, int, int)) &
+                                       Catalog::readFits,
+                               "manager"_a, "selection"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
+                cls.def_static("readMapped", &Catalog::readMapped, "filename"_a);
 
                 cls.def("subset",
                         (Catalog(Catalog::*)(ndarray::Array<bool const, 1> const &) const) & Catalog::subset);
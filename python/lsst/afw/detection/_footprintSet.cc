@@ -49,9 +49,9 @@ void declareMakeHeavy(PyClass &cls) {
     //            });
     cls.def("makeHeavy",
             (void (FootprintSet::*)(image::MaskedImage<PixelT, image::MaskPixel> const &,
-                                    HeavyFootprintCtrl const *)) &
+                                    HeavyFootprintCtrl const *, int const)) &
                     FootprintSet::makeHeavy<PixelT, image::MaskPixel>,
-            "mimg"_a, "ctrl"_a = nullptr);
+            "mimg"_a, "ctrl"_a = nullptr, "numThreads"_a = 1);
 }
 
 template <typename PixelT, typename PyClass>
@@ -65,11 +65,12 @@ void declareSetMask(PyClass &cls) {
 template <typename PixelT, typename PyClass>
 void declareTemplatedMembers(PyClass &cls) {
     /* Constructors */
-    cls.def(py::init<image::Image<PixelT> const &, Threshold const &, int const, bool const>(), "img"_a,
-            "threshold"_a, "npixMin"_a = 1, "setPeaks"_a = true);
+    cls.def(py::init<image::Image<PixelT> const &, Threshold const &, int const, bool const, int const>(),
+            "img"_a, "threshold"_a, "npixMin"_a = 1, "setPeaks"_a = true, "numThreads"_a = 1);
     cls.def(py::init<image::MaskedImage<PixelT, image::MaskPixel> const &, Threshold const &,
-                     std::string const &, int const, bool const>(),
-            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true);
+                     std::string const &, int const, bool const, int const>(),
+            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true,
+            "numThreads"_a = 1);
 
     /* Members */
     declareMakeHeavy<int>(cls);
@@ -93,8 +94,9 @@ void wrapFootprintSet(utils::python::WrapperCollection &wrappers) {
                 declareTemplatedMembers<float>(cls);
                 declareTemplatedMembers<double>(cls);
 
-                cls.def(py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const>(),
-                        "img"_a, "threshold"_a, "npixMin"_a = 1);
+                cls.def(py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const,
+                                 int const>(),
+                        "img"_a, "threshold"_a, "npixMin"_a = 1, "numThreads"_a = 1);
 
                 cls.def(py::init<lsst::geom::Box2I>(), "region"_a);
                 cls.def(py::init<FootprintSet const &>(), "set"_a);
@@ -114,6 +116,8 @@ void wrapFootprintSet(utils::python::WrapperCollection &wrappers) {
                 cls.def("makeSources", &FootprintSet::makeSources);
                 cls.def("setRegion", &FootprintSet::setRegion);
                 cls.def("getRegion", &FootprintSet::getRegion);
+                cls.def("isCopyOnWrite", &FootprintSet::isCopyOnWrite);
+                cls.def("setCopyOnWrite", &FootprintSet::setCopyOnWrite, "copyOnWrite"_a);
                 cls.def("insertIntoImage", &FootprintSet::insertIntoImage);
                 cls.def("setMask", (void (FootprintSet::*)(image::Mask<lsst::afw::image::MaskPixel> *,
                                                            std::string const &)) &
@@ -75,6 +75,12 @@ PYBIND11_MODULE(convolveImage, mod) {
     py::class_<ConvolutionControl, std::shared_ptr<ConvolutionControl>> clsConvolutionControl(
             mod, "ConvolutionControl");
 
+    py::enum_<ConvolutionControl::LinearCombinationAlgorithm>(clsConvolutionControl,
+                                                               "LinearCombinationAlgorithm")
+            .value("KERNEL_IMAGES", ConvolutionControl::LinearCombinationAlgorithm::KERNEL_IMAGES)
+            .value("BASIS_IMAGES", ConvolutionControl::LinearCombinationAlgorithm::BASIS_IMAGES)
+            .export_values();
+
     clsConvolutionControl.def(py::init<bool, bool, int>(), "doNormalize"_a = true, "doCopyEdge"_a = false,
                               "maxInterpolationDistance"_a = 10);
 
@@ -82,10 +88,18 @@ PYBIND11_MODULE(convolveImage, mod) {
     clsConvolutionControl.def("getDoCopyEdge", &ConvolutionControl::getDoCopyEdge);
     clsConvolutionControl.def("getMaxInterpolationDistance",
                               &ConvolutionControl::getMaxInterpolationDistance);
+    clsConvolutionControl.def("getFftMinKernelSize", &ConvolutionControl::getFftMinKernelSize);
+    clsConvolutionControl.def("getLinearCombinationAlgorithm",
+                              &ConvolutionControl::getLinearCombinationAlgorithm);
+    clsConvolutionControl.def("getNumThreads", &ConvolutionControl::getNumThreads);
     clsConvolutionControl.def("setDoNormalize", &ConvolutionControl::setDoNormalize);
     clsConvolutionControl.def("setDoCopyEdge", &ConvolutionControl::setDoCopyEdge);
     clsConvolutionControl.def("setMaxInterpolationDistance",
                               &ConvolutionControl::setMaxInterpolationDistance);
+    clsConvolutionControl.def("setFftMinKernelSize", &ConvolutionControl::setFftMinKernelSize);
+    clsConvolutionControl.def("setLinearCombinationAlgorithm",
+                              &ConvolutionControl::setLinearCombinationAlgorithm);
+    clsConvolutionControl.def("setNumThreads", &ConvolutionControl::setNumThreads);
 
     declareAll<double, double>(mod);
     declareAll<double, float>(mod);
@@ -54,6 +54,12 @@ void declareByType(py::module &mod) {
             (void (*)(
                     OutImageT &, InImageT const &, lsst::afw::math::Kernel const &,
                     lsst::afw::math::ConvolutionControl const &))convolveWithBruteForce<OutImageT, InImageT>);
+    mod.def("convolveWithBasis",
+            (void (*)(OutImageT &, InImageT const &, lsst::afw::math::LinearCombinationKernel const &,
+                      lsst::afw::math::ConvolutionControl const &))convolveWithBasis<OutImageT, InImageT>);
+    mod.def("convolveWithFft",
+            (void (*)(OutImageT &, InImageT const &, lsst::afw::math::Kernel const &,
+                      lsst::afw::math::ConvolutionControl const &))convolveWithFft<OutImageT, InImageT>);
 }
 template <typename PixelType1, typename PixelType2>
 void declareAll(py::module &mod) {
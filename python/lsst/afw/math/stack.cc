@@ -20,11 +20,14 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <pybind11/pybind11.h>
 //#include <pybind11/operators.h>
+#include <pybind11/functional.h>
 #include <pybind11/stl.h>
 
 #include "lsst/afw/math/Stack.h"
@@ -97,6 +100,28 @@ void declareStatisticsStack(py::module &mod) {
                     std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const &
                 ))statisticsStack<PixelT>,
             "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &, int,
+                      std::function<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(
+                              int, lsst::geom::Box2I const &)> const &,
+                      Property, StatisticsControl const &,
+                      std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel,
+                      std::vector<std::pair<lsst::afw::image::MaskPixel,
+                                            lsst::afw::image::MaskPixel>> const &,
+                      int))statisticsStack<PixelT>,
+            "out"_a, "nImage"_a, "readBand"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "bandHeight"_a);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &, std::vector<std::string> const &, Property,
+                      StatisticsControl const &,
+                      std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel,
+                      std::vector<std::pair<lsst::afw::image::MaskPixel,
+                                            lsst::afw::image::MaskPixel>> const &,
+                      int))statisticsStack<PixelT>,
+            "out"_a, "fileNames"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "bandHeight"_a);
     mod.def("statisticsStack",
             (std::vector<PixelT>(*)(
                     std::vector<std::vector<PixelT>> &, Property, StatisticsControl const &,
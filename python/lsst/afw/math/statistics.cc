@@ -99,6 +99,11 @@ PYBIND11_MODULE(statistics, mod) {
             .value("WEIGHTS_NONE", StatisticsControl::WeightsBoolean::WEIGHTS_NONE)
             .export_values();
 
+    py::enum_<StatisticsControl::QuantileAlgorithm>(clsStatisticsControl, "QuantileAlgorithm")
+            .value("QUANTILE_NTH_ELEMENT", StatisticsControl::QuantileAlgorithm::QUANTILE_NTH_ELEMENT)
+            .value("QUANTILE_RADIX_SELECT", StatisticsControl::QuantileAlgorithm::QUANTILE_RADIX_SELECT)
+            .export_values();
+
     clsStatisticsControl.def(py::init<double, int, lsst::afw::image::MaskPixel, bool,
                                       typename StatisticsControl::WeightsBoolean>(),
                              "numSigmaClip"_a = 3.0, "numIter"_a = 3, "andMask"_a = 0x0, "isNanSafe"_a = true,
@@ -115,6 +120,9 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("getWeightedIsSet", &StatisticsControl::getWeightedIsSet);
     clsStatisticsControl.def("getCalcErrorFromInputVariance",
                              &StatisticsControl::getCalcErrorFromInputVariance);
+    clsStatisticsControl.def("getQuantileAlgorithm", &StatisticsControl::getQuantileAlgorithm);
+    clsStatisticsControl.def("getIncrementalClip", &StatisticsControl::getIncrementalClip);
+    clsStatisticsControl.def("getNumThreads", &StatisticsControl::getNumThreads);
     clsStatisticsControl.def("setNumSigmaClip", &StatisticsControl::setNumSigmaClip);
     clsStatisticsControl.def("setNumIter", &StatisticsControl::setNumIter);
     clsStatisticsControl.def("setAndMask", &StatisticsControl::setAndMask);
@@ -123,6 +131,9 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("setWeighted", &StatisticsControl::setWeighted);
     clsStatisticsControl.def("setCalcErrorFromInputVariance",
                              &StatisticsControl::setCalcErrorFromInputVariance);
+    clsStatisticsControl.def("setQuantileAlgorithm", &StatisticsControl::setQuantileAlgorithm);
+    clsStatisticsControl.def("setIncrementalClip", &StatisticsControl::setIncrementalClip);
+    clsStatisticsControl.def("setNumThreads", &StatisticsControl::setNumThreads);
 
     py::class_<Statistics> clsStatistics(mod, "Statistics");
 
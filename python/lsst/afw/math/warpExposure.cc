@@ -23,9 +23,10 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <pybind11/pybind11.h>
-//#include <pybind11/stl.h>
+#include <pybind11/stl.h>
 
 #include "lsst/afw/geom/SkyWcs.h"
 #include "lsst/afw/image/Exposure.h"
@@ -128,6 +129,33 @@ void declareWarpingFunctions(py::module &mod) {
     declareImageWarpingFunctions<DestImageT, SrcImageT>(mod);
     declareImageWarpingFunctions<DestMaskedImageT, SrcMaskedImageT>(mod);
 }
+
+/**
+@internal Declare WarpedExposure and warpExposures for exposures of one pixel type
+
+Only warping to the same pixel type is wrapped, as the destination type cannot be inferred
+from the arguments.
+
+@tparam PixelT  Pixel type, e.g. `int` or `float`
+@param[in,out] mod  pybind11 module for which to declare the wrappers
+@param[in] suffix  Python class name suffix for the pixel type, e.g. "F"
+*/
+template <typename PixelT>
+void declareWarpExposures(py::module &mod, std::string const &suffix) {
+    using ExposureT = image::Exposure<PixelT, image::MaskPixel, image::VariancePixel>;
+    using MaskedImageT = image::MaskedImage<PixelT, image::MaskPixel, image::VariancePixel>;
+    using Class = WarpedExposure<ExposureT>;
+
+    py::class_<Class, std::shared_ptr<Class>> cls(mod, ("WarpedExposure" + suffix).c_str());
+    cls.def_readonly("exposure", &Class::exposure);
+    cls.def_readonly("coverage", &Class::coverage);
+    cls.def_readonly("numGoodPixels", &Class::numGoodPixels);
+
+    mod.def("warpExposures", &warpExposures<ExposureT, ExposureT>, "destWcs"_a, "destBBox"_a,
+            "srcExposures"_a, "control"_a,
+            "padValue"_a = edgePixel<MaskedImageT>(
+                    typename image::detail::image_traits<MaskedImageT>::image_category()));
+}
 }
 
 PYBIND11_MODULE(warpExposure, mod) {
@@ -148,6 +176,11 @@ PYBIND11_MODULE(warpExposure, mod) {
     declareWarpingFunctions<int, int>(mod);
     declareWarpingFunctions<std::uint16_t, std::uint16_t>(mod);
 
+    declareWarpExposures<double>(mod, "D");
+    declareWarpExposures<float>(mod, "F");
+    declareWarpExposures<int>(mod, "I");
+    declareWarpExposures<std::uint16_t>(mod, "U");
+
     /* Member types and enums */
 
     /* Constructors */
@@ -178,6 +211,13 @@ PYBIND11_MODULE(warpExposure, mod) {
                           "maskWarpingKernel"_a);
     clsWarpingControl.def("getGrowFullMask", &WarpingControl::getGrowFullMask);
     clsWarpingControl.def("setGrowFullMask", &WarpingControl::setGrowFullMask, "growFullMask"_a);
+    clsWarpingControl.def("getNumThreads", &WarpingControl::getNumThreads);
+    clsWarpingControl.def("setNumThreads", &WarpingControl::setNumThreads, "numThreads"_a);
+    clsWarpingControl.def("getInterpTolerance", &WarpingControl::getInterpTolerance);
+    clsWarpingControl.def("setInterpTolerance", &WarpingControl::setInterpTolerance, "interpTolerance"_a);
+    clsWarpingControl.def("getLanczosTableSize", &WarpingControl::getLanczosTableSize);
+    clsWarpingControl.def("setLanczosTableSize", &WarpingControl::setLanczosTableSize,
+                          "lanczosTableSize"_a);
 
     /* Members */
 }
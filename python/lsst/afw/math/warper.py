@@ -89,6 +89,13 @@ class WarperConfig(pexConfig.Config):
         doc="``interpLength`` argument to `lsst.afw.math.warpExposure`",
         default=_DefaultInterpLength,
     )
+    interpTolerance = pexConfig.Field(
+        dtype=float,
+        doc="if nonzero, adaptively subdivide cells of ``interpLength`` pixels until interpolation "
+            "is accurate to this many source pixels; "
+            "see `lsst.afw.math.WarpingControl.setInterpTolerance`",
+        default=0.0,
+    )
     cacheSize = pexConfig.Field(
         dtype=int,
         doc="``cacheSize`` argument to `lsst.afw.math.SeparableKernel.computeCache`",
@@ -99,6 +106,17 @@ class WarperConfig(pexConfig.Config):
         doc="mask bits to grow to full width of image/variance kernel,",
         default=afwImage.Mask.getPlaneBitMask("EDGE"),
     )
+    numThreads = pexConfig.Field(
+        dtype=int,
+        doc="number of threads to warp with; 0 for one per hardware thread",
+        default=1,
+    )
+    lanczosTableSize = pexConfig.Field(
+        dtype=int,
+        doc="table intervals per pixel for tabulated Lanczos kernels (e.g. 1024); 0 to evaluate exactly; "
+            "see `lsst.afw.math.WarpingControl.setLanczosTableSize`",
+        default=0,
+    )
 
 
 class Warper:
@@ -117,6 +135,12 @@ class Warper:
         see `WarperConfig.maskWarpingKernelName`
     growFullMask : `int`, optional
         mask bits to grow to full width of image/variance kernel
+    numThreads : `int`, optional
+        number of threads to warp with; 0 for one per hardware thread
+    lanczosTableSize : `int`, optional
+        table intervals per pixel for tabulated Lanczos kernels; 0 to evaluate exactly
+    interpTolerance : `float`, optional
+        tolerance (source pixels) for adaptive interpolation; 0 for a fixed ``interpLength``
     """
     ConfigClass = WarperConfig
 
@@ -125,9 +149,15 @@ class Warper:
                  interpLength=_DefaultInterpLength,
                  cacheSize=_DefaultCacheSize,
                  maskWarpingKernelName="",
-                 growFullMask=afwImage.Mask.getPlaneBitMask("EDGE"),):
+                 growFullMask=afwImage.Mask.getPlaneBitMask("EDGE"),
+                 numThreads=1,
+                 lanczosTableSize=0,
+                 interpTolerance=0.0,):
         self._warpingControl = mathLib.WarpingControl(
             warpingKernelName, maskWarpingKernelName, cacheSize, interpLength, growFullMask)
+        self._warpingControl.setNumThreads(numThreads)
+        self._warpingControl.setLanczosTableSize(lanczosTableSize)
+        self._warpingControl.setInterpTolerance(interpTolerance)
 
     @classmethod
     def fromConfig(cls, config):
@@ -144,6 +174,9 @@ class Warper:
             interpLength=config.interpLength,
             cacheSize=config.cacheSize,
             growFullMask=config.growFullMask,
+            numThreads=config.numThreads,
+            lanczosTableSize=config.lanczosTableSize,
+            interpTolerance=config.interpTolerance,
         )
 
     def getWarpingKernel(self):
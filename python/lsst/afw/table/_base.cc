@@ -173,6 +173,7 @@ PyBaseTable declareBaseTable(WrapperCollection &wrappers) {
 
 void wrapBase(WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.daf.base");
+    wrappers.addSignatureDependency("lsst.afw.table.io");
 
     auto clsBaseTable = declareBaseTable(wrappers);
     auto clsBaseRecord = declareBaseRecord(wrappers);
@@ -166,6 +166,17 @@ class Catalog(metaclass=TemplateMeta):
         self._columns = None
         return self._addNew()
 
+    def compact(self):
+        """Move the data of all records into a single block of memory, making
+        the catalog contiguous.
+
+        The records themselves are not replaced, so other references to them
+        see their data in its new location.  Column views made beforehand
+        still view the old memory.
+        """
+        self._columns = None
+        self._compact()
+
     def cast(self, type_, deep=False):
         """Return a copy of the catalog with the given type.
 
@@ -20,10 +20,14 @@
  */
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+#include <limits>
 
 #include "lsst/utils/python.h"
 
 #include "lsst/afw/table/io/FitsSchemaInputMapper.h"
+#include "lsst/afw/table/io/FitsReader.h"
 
 namespace py = pybind11;
 using namespace py::literals;
@@ -39,6 +43,28 @@ void wrapFits(utils::python::WrapperCollection& wrappers) {
                 [](std::size_t n) { FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = n; });
         mod.def("getPreppedRowsFactor", []() { return FitsSchemaInputMapper::PREPPED_ROWS_FACTOR; });
     });
+    wrappers.wrapType(py::class_<FitsReadSelection>(wrappers.module, "FitsReadSelection"),
+                      [](auto& mod, auto& cls) {
+                          cls.def(py::init([](std::vector<std::string> const& fields,
+                                              std::vector<std::string> const& prefixes, std::size_t firstRow,
+                                              std::size_t maxRows) {
+                                      FitsReadSelection self;
+                                      self.fields = fields;
+                                      self.prefixes = prefixes;
+                                      self.firstRow = firstRow;
+                                      self.maxRows = maxRows;
+                                      return self;
+                                  }),
+                                  "fields"_a = std::vector<std::string>(),
+                                  "prefixes"_a = std::vector<std::string>(), "firstRow"_a = 0,
+                                  "maxRows"_a = std::numeric_limits<std::size_t>::max());
+                          cls.def_readwrite("fields", &FitsReadSelection::fields);
+                          cls.def_readwrite("prefixes", &FitsReadSelection::prefixes);
+                          cls.def_readwrite("firstRow", &FitsReadSelection::firstRow);
+                          cls.def_readwrite("maxRows", &FitsReadSelection::maxRows);
+                          cls.def("selectsAllFields", &FitsReadSelection::selectsAllFields);
+                          cls.def("selectsField", &FitsReadSelection::selectsField, "name"_a);
+                      });
 }
 
 }  // namespace io
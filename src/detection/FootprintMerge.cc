@@ -23,6 +23,8 @@
 
 #include "boost/bind.hpp"
 
+#include <algorithm>
+
 #include "lsst/afw/detection/FootprintMerge.h"
 #include "lsst/afw/detection/FootprintSet.h"
 #include "lsst/afw/table/IdFactory.h"
@@ -30,6 +32,33 @@
 namespace lsst {
 namespace afw {
 namespace detection {
+namespace {
+
+// Side of the square cells of the FootprintMergeList index, in pixels
+int const CELL_SIZE = 128;
+
+// Cell containing a pixel coordinate, rounding towards negative infinity
+int getCell(int pos) { return pos >= 0 ? pos / CELL_SIZE : -((-pos - 1) / CELL_SIZE) - 1; }
+
+// Pack a cell's coordinates into one key; shift unsigned values, as cells may be negative
+std::uint64_t getCellKey(int xCell, int yCell) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(xCell)) << 32) |
+           static_cast<std::uint32_t>(yCell);
+}
+
+// Call func(key) for the key of every cell covered by a (non-empty) box
+template <typename Function>
+void forEachCell(lsst::geom::Box2I const &bbox, Function func) {
+    int const xEnd = getCell(bbox.getMaxX());
+    int const yEnd = getCell(bbox.getMaxY());
+    for (int yCell = getCell(bbox.getMinY()); yCell <= yEnd; ++yCell) {
+        for (int xCell = getCell(bbox.getMinX()); xCell <= xEnd; ++xCell) {
+            func(getCellKey(xCell, yCell));
+        }
+    }
+}
+
+}  // namespace
 
 class FootprintMerge {
 public:
@@ -260,16 +289,21 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
         // Empty pointer to account for the first match in the catalog.  If there is more than one
         // match, subsequent matches will be merged with this one
         std::shared_ptr<FootprintMerge> first = std::shared_ptr<FootprintMerge>();
+        std::size_t firstIndex = 0;
 
         if (checkForMatches) {
-            FootprintMergeVec::iterator iter = _mergeList.begin();
-            while (iter != _mergeList.end()) {
+            // The boxes of the candidates other than first do not change while foot is processed, so
+            // visiting them in list order gives the same merges as a scan over the whole list
+            for (std::size_t index : _findCandidates(foot->getBBox())) {
+                std::shared_ptr<FootprintMerge> &merge = _mergeList[index];
+                if (!merge) continue;  // already merged into another entry
                 // Grow by one pixel to allow for touching
-                lsst::geom::Box2I box((**iter).getBBox());
+                lsst::geom::Box2I box(merge->getBBox());
                 box.grow(lsst::geom::Extent2I(1, 1));
-                if (box.overlaps(foot->getBBox()) && (**iter).overlaps(*foot)) {
+                if (box.overlaps(foot->getBBox()) && merge->overlaps(*foot)) {
                     if (!first) {
-                        first = *iter;
+                        first = merge;
+                        firstIndex = index;
                         // Spatially extend existing FootprintMerge in order to connect subsequent,
                         // now-overlapping FootprintMerges. If a subsequent FootprintMerge overlaps with
                         // the new footprint, it's now guaranteed to overlap with this first FootprintMerge.
@@ -277,25 +311,30 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
                         // higher-priority existing peaks are merged into this first FootprintMerge.
                         first->addSpans(foot);
                     } else {
-                        // Add existing merged Footprint to first
-                        first->add(**iter, _filterMap, minNewPeakDist, maxSamePeakDist);
-                        iter = _mergeList.erase(iter);
-                        continue;
+                        // Add existing merged Footprint to first; the entry is dropped by _compact()
+                        first->add(*merge, _filterMap, minNewPeakDist, maxSamePeakDist);
+                        merge.reset();
+                        ++_numRemoved;
                     }
                 }
-                ++iter;
-            } // while mergeList
-        } //     if checkForMatches
+            }  // for candidates
+        }      // if checkForMatches
 
         if (first) {
             // Now merge footprint including peaks into the newly-connected, higher-priority FootprintMerge
             first->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist, maxSamePeakDist);
+            _indexMerge(firstIndex);
         } else {
-           // Footprint did not overlap with any existing FootprintMerges. Add to MergeList
+            // Footprint did not overlap with any existing FootprintMerges. Add to MergeList
             _mergeList.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
                                                                   _peakSchemaMapper, keyIter->second));
+            _indexMerge(_mergeList.size() - 1);
         }
     }
+
+    if (_numRemoved > 0) {
+        _compact();
+    }
 }
 
 void FootprintMergeList::getFinalSources(afw::table::SourceCatalog &outputCat) {
@@ -304,6 +343,43 @@ void FootprintMergeList::getFinalSources(afw::table::SourceCatalog &outputCat) {
         outputCat.push_back((**iter).getSource());
     }
 }
+
+void FootprintMergeList::_indexMerge(std::size_t index) {
+    lsst::geom::Box2I box(_mergeList[index]->getBBox());
+    if (box.isEmpty()) return;
+    box.grow(lsst::geom::Extent2I(1, 1));
+    forEachCell(box, [this, index](std::uint64_t key) {
+        std::vector<std::size_t> &cell = _cells[key];
+        // A grown merge is indexed again, so it may already be in some of its cells
+        if (std::find(cell.begin(), cell.end(), index) == cell.end()) {
+            cell.push_back(index);
+        }
+    });
+}
+
+std::vector<std::size_t> FootprintMergeList::_findCandidates(lsst::geom::Box2I const &bbox) const {
+    std::vector<std::size_t> candidates;
+    if (bbox.isEmpty()) return candidates;
+    forEachCell(bbox, [this, &candidates](std::uint64_t key) {
+        CellMap::const_iterator cell = _cells.find(key);
+        if (cell != _cells.end()) {
+            candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+        }
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
+void FootprintMergeList::_compact() {
+    _mergeList.erase(std::remove(_mergeList.begin(), _mergeList.end(), nullptr), _mergeList.end());
+    _numRemoved = 0;
+    _cells.clear();
+    for (std::size_t index = 0; index < _mergeList.size(); ++index) {
+        _indexMerge(index);
+    }
+}
+
 }  // namespace detection
 }  // namespace afw
 }  // namespace lsst
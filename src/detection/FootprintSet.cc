@@ -50,6 +50,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/detection/Peak.h"
 #include "lsst/afw/detection/FootprintSet.h"
 #include "lsst/afw/detection/FootprintCtrl.h"
@@ -208,11 +209,12 @@ struct SortPeaks {
 /*
  * Worker routine for merging two FootprintSets, possibly growing them as we proceed
  */
-FootprintSet mergeFootprintSets(FootprintSet const &lhs,      // the FootprintSet to be merged to
-                                int rLhs,                     // Grow lhs Footprints by this many pixels
-                                FootprintSet const &rhs,      // the FootprintSet to be merged into lhs
-                                int rRhs,                     // Grow rhs Footprints by this many pixels
-                                FootprintControl const &ctrl  // Control how the grow is done
+FootprintSet mergeFootprintSets(FootprintSet const &lhs,       // the FootprintSet to be merged to
+                                int rLhs,                      // Grow lhs Footprints by this many pixels
+                                FootprintSet const &rhs,       // the FootprintSet to be merged into lhs
+                                int rRhs,                      // Grow rhs Footprints by this many pixels
+                                FootprintControl const &ctrl,  // Control how the grow is done
+                                bool const copyOnWrite  // Reuse unchanged Footprints? (see setCopyOnWrite)
 ) {
     typedef FootprintSet::FootprintList FootprintList;
     // The isXXX routines return <isset, value>
@@ -389,6 +391,20 @@ FootprintSet mergeFootprintSets(FootprintSet const &lhs,      // the FootprintSe
                 }
             }
         }
+        /*
+         * In copy-on-write mode, share a Footprint that the merge left unchanged rather than rebuilding it
+         */
+        if (copyOnWrite && lhsFootprintIndxs.size() + rhsFootprintIndxs.size() == 1) {
+            std::shared_ptr<Footprint> const &original = lhsFootprintIndxs.empty()
+                                                                 ? rhsFootprints[*rhsFootprintIndxs.begin()]
+                                                                 : lhsFootprints[*lhsFootprintIndxs.begin()];
+            if (!original->isHeavy() && original->getRegion() == foot->getRegion() &&
+                *original->getSpans() == *foot->getSpans()) {
+                *ptr = original;
+                idFinder.reset();
+                continue;
+            }
+        }
         /*
          * We now have a complete set of Footprints that contributed to this one, so merge
          * all their Peaks into the new one
@@ -425,6 +441,7 @@ FootprintSet mergeFootprintSets(FootprintSet const &lhs,      // the FootprintSe
         idFinder.reset();
     }
 
+    fs.setCopyOnWrite(copyOnWrite);
     return fs;
 }
 /*
@@ -465,13 +482,40 @@ int resolve_alias(std::vector<int> const &aliases, /* list of aliases */
 
     return (resolved);
 }
+/*
+ * Record that two IDs belong to the same object.
+ *
+ * The smaller of the two resolved IDs becomes the alias of the larger. IDs are allocated in raster order,
+ * so each object resolves to the ID of its first pixel, and sorting objects by resolved ID sorts them
+ * by their first span, however the image was divided up for labelling.
+ */
+void merge_aliases(std::vector<int> &aliases, /* list of aliases */
+                   int id1, int id2) {        /* IDs to merge */
+    int const resolved1 = resolve_alias(aliases, id1);
+    int const resolved2 = resolve_alias(aliases, id2);
+
+    if (resolved1 < resolved2) {
+        aliases[resolved2] = resolved1;
+    } else {
+        aliases[resolved1] = resolved2;
+    }
+}
 /// @endcond
 }  // namespace
 
 namespace {
+/*
+ * A peak found in a Footprint, before it's added to the Footprint's PeakCatalog
+ */
+struct PeakCandidate {
+    int x;
+    int y;
+    double value;
+};
+
 template <typename ImageT>
-void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCatalog &peaks, Footprint &foot,
-                          std::size_t const margin = 0) {
+void findPeaksInFootprint(ImageT const &image, bool polarity, std::vector<PeakCandidate> &peaks,
+                          Footprint const &foot, std::size_t const margin = 0) {
     auto spanSet = foot.getSpans();
     if (spanSet->size() == 0) {
         return;
@@ -503,7 +547,7 @@ void findPeaksInFootprint(ImageT const &image, bool polarity, PeakCatalog &peaks
                 }
             }
 
-            foot.addPeak(x + image.getX0(), y + image.getY0(), val);
+            peaks.push_back(PeakCandidate{x + image.getX0(), y + image.getY0(), static_cast<double>(val)});
         }
     }
 }
@@ -534,7 +578,9 @@ public:
         }
     }
 
-    void addRecord(Footprint &foot) const { foot.addPeak(_x, _y, _polarity ? _max : _min); }
+    void addCandidate(std::vector<PeakCandidate> &peaks) const {
+        peaks.push_back(PeakCandidate{_x, _y, _polarity ? _max : _min});
+    }
 
 private:
     bool _polarity;
@@ -542,26 +588,82 @@ private:
     double _min, _max;
 };
 
-template <typename ImageT, typename ThresholdT>
-void findPeaks(std::shared_ptr<Footprint> foot, ImageT const &img, bool polarity, ThresholdT) {
-    findPeaksInFootprint(img, polarity, foot->getPeaks(), *foot, 1);
+/*
+ * Split a list of Footprints into nChunks contiguous ranges of roughly equal area, returning the
+ * nChunks + 1 boundaries of the ranges
+ */
+std::vector<std::size_t> splitByArea(FootprintSet::FootprintList const &footprints, int nChunks) {
+    std::size_t totalArea = 0;
+    for (auto const &foot : footprints) {
+        totalArea += foot->getArea();
+    }
+    std::vector<std::size_t> boundaries(1, 0);
+    std::size_t area = 0;
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        area += footprints[i]->getArea();
+        // Close chunk k once the area reaches k/nChunks of the total
+        while (boundaries.size() < static_cast<std::size_t>(nChunks) &&
+               area * nChunks >= totalArea * boundaries.size()) {
+            boundaries.push_back(i + 1);
+        }
+    }
+    boundaries.resize(nChunks + 1, footprints.size());
+    return boundaries;
+}
 
-    // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
-    // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
-    // it'd try to do if we passed Catalog's own iterators).
-    std::stable_sort(foot->getPeaks().getInternal().begin(), foot->getPeaks().getInternal().end(),
-                     SortPeaks());
+/*
+ * Run func(foot) on every Footprint in a list, using up to numThreads threads
+ *
+ * The Footprints are split into ranges of roughly equal area, as the work is usually proportional
+ * to the number of pixels.
+ */
+template <typename Function>
+void parallelForFootprints(FootprintSet::FootprintList &footprints, int numThreads, Function func) {
+    int const nChunks = std::max(
+            1, std::min(math::detail::resolveNumThreads(numThreads), static_cast<int>(footprints.size())));
+    std::vector<std::size_t> const boundaries = splitByArea(footprints, nChunks);
+    math::detail::parallelForChunks(0, nChunks, nChunks, [&](int, int, int iChunk) {
+        for (std::size_t i = boundaries[iChunk]; i < boundaries[iChunk + 1]; ++i) {
+            func(i, footprints[i]);
+        }
+    });
+}
 
-    if (foot->getPeaks().empty()) {
-        FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
-        foot->getSpans()->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
-        maxFinder.addRecord(*foot);
+template <typename ImageT, typename ThresholdT>
+void findPeaks(FootprintSet::FootprintList &footprints, ImageT const &img, bool polarity, int numThreads,
+               ThresholdT) {
+    // Search the pixels of each Footprint in parallel
+    std::vector<std::vector<PeakCandidate>> candidates(footprints.size());
+    std::vector<char> found(footprints.size());  // not vector<bool>, which threads can't write safely
+    parallelForFootprints(footprints, numThreads, [&](std::size_t i, std::shared_ptr<Footprint> &foot) {
+        findPeaksInFootprint(img, polarity, candidates[i], *foot, 1);
+        found[i] = !candidates[i].empty();
+        if (!found[i]) {
+            FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
+            foot->getSpans()->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
+            maxFinder.addCandidate(candidates[i]);
+        }
+    });
+    // The PeakRecords of all Footprints come from one PeakTable, whose record blocks and IdFactory aren't
+    // thread-safe, so they're made here, in the same order as a serial search would make them
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        Footprint &foot = *footprints[i];
+        for (auto const &peak : candidates[i]) {
+            foot.addPeak(peak.x, peak.y, peak.value);
+        }
+        if (found[i]) {
+            // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
+            // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
+            // it'd try to do if we passed Catalog's own iterators).
+            std::stable_sort(foot.getPeaks().getInternal().begin(), foot.getPeaks().getInternal().end(),
+                             SortPeaks());
+        }
     }
 }
 
 // No need to search for peaks when processing a Mask
 template <typename ImageT>
-void findPeaks(std::shared_ptr<Footprint>, ImageT const &, bool, ThresholdBitmask_traits) {
+void findPeaks(FootprintSet::FootprintList &, ImageT const &, bool, int, ThresholdBitmask_traits) {
     ;
 }
 }  // namespace
@@ -588,44 +690,83 @@ static inline bool inFootprint(ImagePixelT pixVal, IterT, bool, double threshold
 }
 
 /*
- * Advance the x_iterator to the variance image, when relevant (it may be NULL otherwise)
+ * Return the x_iterator to pixel x of a row of the variance image, when relevant (it may be NULL otherwise)
+ * given the x_iterator to the start of the row
  */
 template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, Threshold_traits) {
+static inline IterT getVarPtr(IterT varPtr, int, Threshold_traits) {
     return varPtr;
 }
 
 template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, ThresholdPixelLevel_traits) {
-    return varPtr + 1;
+static inline IterT getVarPtr(IterT varPtr, int x, ThresholdPixelLevel_traits) {
+    return varPtr + x;
 }
 
+namespace {
+int const PIXELS_PER_WORD = 64;  // pixels flagged by each word of findPixelsInFootprint's output
+
 /*
- * Here's the working routine for the FootprintSet constructors; see documentation
- * of the constructors themselves
+ * Flag the pixels of a row that are in a Footprint, setting bit i of words[j] for pixel 64*j + i
+ *
+ * The loop over each word has no branches (the tests are combined with bitwise operators),
+ * so that compilers can vectorise it; the caller can then skip over empty words without looking at
+ * their pixels.
  */
-template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
-static void findFootprints(
-        typename FootprintSet::FootprintList *_footprints,  // Footprints
-        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
-        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
-        image::Image<VariancePixelT> const *var,            // img's variance
-        double const footprintThreshold,                    // threshold value for footprint
-        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
-        bool const polarity,                      // if false, search _below_ thresholdVal
-        int const npixMin,                        // minimum number of pixels in an object
-        bool const setPeaks                       // should I set the Peaks list?
+template <typename ImagePixelT, typename IterT, typename VarIterT, typename ThresholdTraitT>
+void findPixelsInFootprint(IterT pixPtr,     // start of the row of the image
+                           VarIterT varPtr,  // start of the row of the variance (may be NULL)
+                           int const width,  // number of pixels in the row
+                           bool const polarity, double const thresholdVal, ThresholdTraitT,
+                           std::vector<std::uint64_t> &words  // flags; must hold a bit for each pixel
+) {
+    for (int xBegin = 0, word = 0; xBegin < width; xBegin += PIXELS_PER_WORD, ++word) {
+        int const n = std::min(PIXELS_PER_WORD, width - xBegin);
+        std::uint64_t bits = 0;
+        for (int i = 0; i < n; ++i) {
+            ImagePixelT const pixVal = pixPtr[xBegin + i];
+            bool const in = !isBadPixel(pixVal) &
+                            inFootprint(pixVal, getVarPtr(varPtr, xBegin + i, ThresholdTraitT()), polarity,
+                                        thresholdVal, ThresholdTraitT());
+            bits |= static_cast<std::uint64_t>(in) << i;
+        }
+        words[word] = bits;
+    }
+}
+}  // namespace
+
+namespace {
+/*
+ * The parts of Footprints found in a band of rows of an image, labelled with object IDs
+ */
+struct LabelledRows {
+    std::vector<IdSpan> spans;     // y:x0,x1 for objects, in raster order
+    std::vector<int> aliases;      // aliases for initially disjoint parts of Footprints; aliases[0] == 0
+    std::vector<int> firstRowIds;  // object ID of each pixel in the first row; 0 if not in an object
+    std::vector<int> lastRowIds;   // object ID of each pixel in the last row; 0 if not in an object
+};
+
+// Bands labelled in parallel have at least this many rows, to amortise stitching them together
+int const MIN_ROWS_PER_BAND = 64;
+
+/*
+ * Label the pixels in Footprints in rows [yBegin, yEnd) of an image, as if those were the only rows
+ */
+template <typename ImagePixelT, typename VariancePixelT, typename ThresholdTraitT>
+LabelledRows labelRows(image::ImageBase<ImagePixelT> const &img,  // Image to search for objects
+                       image::Image<VariancePixelT> const *var,   // img's variance
+                       int const yBegin,                          // first row to label
+                       int const yEnd,                            // one past the last row to label
+                       double const footprintThreshold,           // threshold value for footprint
+                       double const includeThreshold,             // threshold value for inclusion
+                       bool const includeAll,  // includeThreshold == footprintThreshold?
+                       bool const polarity     // if false, search _below_ thresholdVal
 ) {
     int id;       /* object ID */
     int in_span;  /* object ID of current IdSpan */
     int nobj = 0; /* number of objects found */
     int x0 = 0;   /* unpacked from a IdSpan */
 
-    double includeThreshold = footprintThreshold * includeThresholdMultiplier;  // Threshold for inclusion
-
-    int const row0 = img.getY0();
-    int const col0 = img.getX0();
-    int const height = img.getHeight();
     int const width = img.getWidth();
     /*
      * Storage for arrays that identify objects by ID. We want to be able to
@@ -638,10 +779,11 @@ static void findFootprints(
     std::vector<int>::iterator idc = id1.begin() + 1;  // object IDs in current/
     std::vector<int>::iterator idp = id2.begin() + 1;  //                       previous row
 
-    std::vector<int> aliases;          // aliases for initially disjoint parts of Footprints
-    aliases.reserve(1 + height / 20);  // initial size of aliases
+    LabelledRows result;
+    std::vector<int> &aliases = result.aliases;
+    aliases.reserve(1 + (yEnd - yBegin) / 20);  // initial size of aliases
 
-    std::vector<IdSpan> spans;          // y:x0,x1 for objects
+    std::vector<IdSpan> &spans = result.spans;
     spans.reserve(aliases.capacity());  // initial size of spans
 
     aliases.push_back(0);  // 0 --> 0
@@ -651,8 +793,11 @@ static void findFootprints(
     typedef typename image::Image<ImagePixelT>::x_iterator x_iterator;
     typedef typename image::Image<VariancePixelT>::x_iterator x_var_iterator;
 
+    // pixels of the current row that are in a Footprint; see findPixelsInFootprint
+    std::vector<std::uint64_t> inFootprintWords((width + PIXELS_PER_WORD - 1) / PIXELS_PER_WORD);
+
     in_span = 0;  // not in a span
-    for (int y = 0; y != height; ++y) {
+    for (int y = yBegin; y != yEnd; ++y) {
         if (idc == id1.begin() + 1) {
             idc = id2.begin() + 1;
             idp = id1.begin() + 1;
@@ -662,52 +807,65 @@ static void findFootprints(
         }
         std::fill_n(idc - 1, width + 2, 0);
 
-        in_span = 0;                                     /* not in a span */
-        bool good = (includeThresholdMultiplier == 1.0); /* Span exceeds the threshold? */
+        in_span = 0;            /* not in a span */
+        bool good = includeAll; /* Span exceeds the threshold? */
 
         x_iterator pixPtr = img.row_begin(y);
         x_var_iterator varPtr = (var == NULL) ? NULL : var->row_begin(y);
-        for (int x = 0; x < width; ++x, ++pixPtr, varPtr = advancePtr(varPtr, ThresholdTraitT())) {
-            ImagePixelT const pixVal = *pixPtr;
-
-            if (isBadPixel(pixVal) ||
-                !inFootprint(pixVal, varPtr, polarity, footprintThreshold, ThresholdTraitT())) {
+        findPixelsInFootprint<ImagePixelT>(pixPtr, varPtr, width, polarity, footprintThreshold,
+                                           ThresholdTraitT(), inFootprintWords);
+        for (int xBegin = 0, word = 0; xBegin < width; xBegin += PIXELS_PER_WORD, ++word) {
+            std::uint64_t bits = inFootprintWords[word];
+            if (bits == 0) { /* no pixels to fix */
                 if (in_span) {
-                    spans.emplace_back(in_span, y, x0, x - 1, good);
+                    spans.emplace_back(in_span, y, x0, xBegin - 1, good);
 
                     in_span = 0;
                     good = false;
                 }
-            } else { /* a pixel to fix */
-                if (idc[x - 1] != 0) {
-                    id = idc[x - 1];
-                } else if (idp[x - 1] != 0) {
-                    id = idp[x - 1];
-                } else if (idp[x] != 0) {
-                    id = idp[x];
-                } else if (idp[x + 1] != 0) {
-                    id = idp[x + 1];
-                } else {
-                    id = ++nobj;
-                    aliases.push_back(id);
-                }
+                continue;
+            }
+            int const xEnd = std::min(width, xBegin + PIXELS_PER_WORD);
+            for (int x = xBegin; x < xEnd; ++x, bits >>= 1) {
+                if (!(bits & 0x1)) {
+                    if (in_span) {
+                        spans.emplace_back(in_span, y, x0, x - 1, good);
+
+                        in_span = 0;
+                        good = false;
+                    }
+                } else { /* a pixel to fix */
+                    if (idc[x - 1] != 0) {
+                        id = idc[x - 1];
+                    } else if (idp[x - 1] != 0) {
+                        id = idp[x - 1];
+                    } else if (idp[x] != 0) {
+                        id = idp[x];
+                    } else if (idp[x + 1] != 0) {
+                        id = idp[x + 1];
+                    } else {
+                        id = ++nobj;
+                        aliases.push_back(id);
+                    }
 
-                idc[x] = id;
-                if (!in_span) {
-                    x0 = x;
-                    in_span = id;
-                }
-                /*
-                 * Do we need to merge ID numbers? If so, make suitable entries in aliases[]
-                 */
-                if (idp[x + 1] != 0 && idp[x + 1] != id) {
-                    aliases[resolve_alias(aliases, idp[x + 1])] = resolve_alias(aliases, id);
+                    idc[x] = id;
+                    if (!in_span) {
+                        x0 = x;
+                        in_span = id;
+                    }
+                    /*
+                     * Do we need to merge ID numbers? If so, make suitable entries in aliases[]
+                     */
+                    if (idp[x + 1] != 0 && idp[x + 1] != id) {
+                        merge_aliases(aliases, idp[x + 1], id);
 
-                    idc[x] = id = idp[x + 1];
-                }
+                        idc[x] = id = idp[x + 1];
+                    }
 
-                if (!good && inFootprint(pixVal, varPtr, polarity, includeThreshold, ThresholdTraitT())) {
-                    good = true;
+                    if (!good && inFootprint(pixPtr[x], getVarPtr(varPtr, x, ThresholdTraitT()), polarity,
+                                             includeThreshold, ThresholdTraitT())) {
+                        good = true;
+                    }
                 }
             }
         }
@@ -715,6 +873,84 @@ static void findFootprints(
         if (in_span) {
             spans.emplace_back(in_span, y, x0, width - 1, good);
         }
+        if (y == yBegin) {
+            result.firstRowIds.assign(idc, idc + width);
+        }
+    }
+    if (yEnd > yBegin) {
+        result.lastRowIds.assign(idc, idc + width);
+    }
+
+    return result;
+}
+}  // namespace
+
+/*
+ * Here's the working routine for the FootprintSet constructors; see documentation
+ * of the constructors themselves
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void findFootprints(
+        typename FootprintSet::FootprintList *_footprints,  // Footprints
+        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
+        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
+        image::Image<VariancePixelT> const *var,            // img's variance
+        double const footprintThreshold,                    // threshold value for footprint
+        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
+        bool const polarity,                      // if false, search _below_ thresholdVal
+        int const npixMin,                        // minimum number of pixels in an object
+        bool const setPeaks,                      // should I set the Peaks list?
+        int const numThreads                      // number of threads; 0 for one per hardware thread
+) {
+    int id; /* object ID */
+
+    double includeThreshold = footprintThreshold * includeThresholdMultiplier;  // Threshold for inclusion
+
+    int const row0 = img.getY0();
+    int const col0 = img.getX0();
+    int const height = img.getHeight();
+    int const width = img.getWidth();
+    /*
+     * Label horizontal bands of the image in parallel, each as if it were the whole image
+     */
+    int const nBands =
+            std::min(math::detail::resolveNumThreads(numThreads), std::max(1, height / MIN_ROWS_PER_BAND));
+    std::vector<LabelledRows> bandList(nBands);
+    math::detail::parallelForChunks(0, height, nBands, [&](int yBegin, int yEnd, int iBand) {
+        bandList[iBand] = labelRows<ImagePixelT, VariancePixelT, ThresholdTraitT>(
+                img, var, yBegin, yEnd, footprintThreshold, includeThreshold,
+                includeThresholdMultiplier == 1.0, polarity);
+    });
+    /*
+     * Stitch the bands together: renumber the IDs of each band to follow those of the bands above it
+     * (which preserves the raster order of the IDs), then merge objects that touch across the boundary
+     */
+    std::vector<int> aliases = std::move(bandList[0].aliases);
+    std::vector<IdSpan> spans = std::move(bandList[0].spans);
+    int prevIdOffset = 0;  // offset added to the IDs of the previous band
+    for (int band = 1; band < nBands; ++band) {
+        LabelledRows const &rows = bandList[band];
+        int const idOffset = aliases.size() - 1;
+        for (std::size_t i = 1; i < rows.aliases.size(); ++i) {
+            aliases.push_back(rows.aliases[i] + idOffset);
+        }
+        for (IdSpan span : rows.spans) {
+            span.id += idOffset;
+            spans.push_back(span);
+        }
+
+        std::vector<int> const &prevRowIds = bandList[band - 1].lastRowIds;
+        for (int x = 0; x < width; ++x) {
+            if (rows.firstRowIds[x] == 0) {
+                continue;
+            }
+            for (int prevX = std::max(0, x - 1), end = std::min(width - 1, x + 1); prevX <= end; ++prevX) {
+                if (prevRowIds[prevX] != 0) {
+                    merge_aliases(aliases, rows.firstRowIds[x] + idOffset, prevRowIds[prevX] + prevIdOffset);
+                }
+            }
+        }
+        prevIdOffset = idOffset;
     }
     /*
      * Resolve aliases; first alias chains, then the IDs in the spans
@@ -761,40 +997,38 @@ static void findFootprints(
      * Find all peaks within those Footprints
      */
     if (setPeaks) {
-        typedef FootprintSet::FootprintList::iterator fiterator;
-        for (fiterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
-            findPeaks(*ptr, img, polarity, ThresholdTraitT());
-        }
+        findPeaks(*_footprints, img, polarity, numThreads, ThresholdTraitT());
     }
 }
 
 template <typename ImagePixelT>
 FootprintSet::FootprintSet(image::Image<ImagePixelT> const &img, Threshold const &threshold,
-                           int const npixMin, bool const setPeaks)
+                           int const npixMin, bool const setPeaks, int const numThreads)
         : _footprints(new FootprintList()), _region(img.getBBox()) {
     typedef float VariancePixelT;
 
     findFootprints<ImagePixelT, image::MaskPixel, VariancePixelT, ThresholdLevel_traits>(
             _footprints.get(), _region, img, NULL, threshold.getValue(img), threshold.getIncludeMultiplier(),
-            threshold.getPolarity(), npixMin, setPeaks);
+            threshold.getPolarity(), npixMin, setPeaks, numThreads);
 }
 
 // NOTE: not a template to appease swig (see note by instantiations at bottom)
 
 template <typename MaskPixelT>
-FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin)
+FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin,
+                           int const numThreads)
         : _footprints(new FootprintList()), _region(msk.getBBox()) {
     switch (threshold.getType()) {
         case Threshold::BITMASK:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdBitmask_traits>(
                     _footprints.get(), _region, msk, NULL, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, numThreads);
             break;
 
         case Threshold::VALUE:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdLevel_traits>(
                     _footprints.get(), _region, msk, NULL, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, numThreads);
             break;
 
         default:
@@ -806,7 +1040,7 @@ FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &
 template <typename ImagePixelT, typename MaskPixelT>
 FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &maskedImg,
                            Threshold const &threshold, std::string const &planeName, int const npixMin,
-                           bool const setPeaks)
+                           bool const setPeaks, int const numThreads)
         : _footprints(new FootprintList()),
           _region(lsst::geom::Point2I(maskedImg.getX0(), maskedImg.getY0()),
                   lsst::geom::Extent2I(maskedImg.getWidth(), maskedImg.getHeight())) {
@@ -817,13 +1051,13 @@ FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &ma
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdPixelLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, numThreads);
             break;
         default:
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, numThreads);
             break;
     }
     // Set Mask if requested
@@ -848,7 +1082,12 @@ FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &ma
 FootprintSet::FootprintSet(lsst::geom::Box2I region)
         : _footprints(std::make_shared<FootprintList>()), _region(region) {}
 
-FootprintSet::FootprintSet(FootprintSet const &rhs) : _footprints(new FootprintList), _region(rhs._region) {
+FootprintSet::FootprintSet(FootprintSet const &rhs)
+        : _footprints(new FootprintList), _region(rhs._region), _copyOnWrite(rhs._copyOnWrite) {
+    if (_copyOnWrite) {
+        *_footprints = *rhs._footprints;  // share the Footprints
+        return;
+    }
     _footprints->reserve(rhs._footprints->size());
     for (FootprintSet::FootprintList::const_iterator ptr = rhs._footprints->begin(),
                                                      end = rhs._footprints->end();
@@ -857,8 +1096,10 @@ FootprintSet::FootprintSet(FootprintSet const &rhs) : _footprints(new FootprintL
     }
 }
 
-// Delegate to copy-constructor for backward-compatibility
-FootprintSet::FootprintSet(FootprintSet &&rhs) : FootprintSet(rhs) {}
+FootprintSet::FootprintSet(FootprintSet &&rhs)
+        : _footprints(std::move(rhs._footprints)), _region(rhs._region), _copyOnWrite(rhs._copyOnWrite) {
+    rhs._footprints = std::make_shared<FootprintList>();  // leave rhs empty, but usable
+}
 
 FootprintSet &FootprintSet::operator=(FootprintSet const &rhs) {
     FootprintSet tmp(rhs);
@@ -866,14 +1107,21 @@ FootprintSet &FootprintSet::operator=(FootprintSet const &rhs) {
     return *this;
 }
 
-// Delegate to copy-assignment for backward-compatibility
-FootprintSet &FootprintSet::operator=(FootprintSet &&rhs) { return *this = rhs; }
+FootprintSet &FootprintSet::operator=(FootprintSet &&rhs) {
+    if (this != &rhs) {
+        _footprints = std::move(rhs._footprints);
+        _region = rhs._region;
+        _copyOnWrite = rhs._copyOnWrite;
+        rhs._footprints = std::make_shared<FootprintList>();  // leave rhs empty, but usable
+    }
+    return *this;
+}
 
 FootprintSet::~FootprintSet() = default;
 
 void FootprintSet::merge(FootprintSet const &rhs, int tGrow, int rGrow, bool isotropic) {
     FootprintControl const ctrl(true, isotropic);
-    FootprintSet fs = mergeFootprintSets(*this, tGrow, rhs, rGrow, ctrl);
+    FootprintSet fs = mergeFootprintSets(*this, tGrow, rhs, rGrow, ctrl, _copyOnWrite);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
@@ -882,6 +1130,9 @@ void FootprintSet::setRegion(lsst::geom::Box2I const &region) {
 
     for (FootprintSet::FootprintList::iterator ptr = _footprints->begin(), end = _footprints->end();
          ptr != end; ++ptr) {
+        if (_copyOnWrite && ptr->use_count() > 1 && (*ptr)->getRegion() != region) {
+            *ptr = std::make_shared<Footprint>(**ptr);  // don't modify a shared Footprint
+        }
         (*ptr)->setRegion(region);
     }
 }
@@ -898,7 +1149,7 @@ FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic)
     }
 
     FootprintControl const ctrl(true, isotropic);
-    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, r, ctrl);
+    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, r, ctrl, rhs._copyOnWrite);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
@@ -913,7 +1164,8 @@ FootprintSet::FootprintSet(FootprintSet const &rhs, int ngrow, FootprintControl
                           str(boost::format("I cannot grow by negative numbers: %d") % ngrow));
     }
 
-    FootprintSet fs = mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, ngrow, ctrl);
+    FootprintSet fs =
+            mergeFootprintSets(FootprintSet(rhs.getRegion()), 0, rhs, ngrow, ctrl, rhs._copyOnWrite);
     swap(fs);  // Swap the new FootprintSet into place
 }
 
@@ -938,16 +1190,17 @@ std::shared_ptr<image::Image<FootprintIdPixel>> FootprintSet::insertIntoImage()
 
 template <typename ImagePixelT, typename MaskPixelT>
 void FootprintSet::makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const &mimg,
-                             HeavyFootprintCtrl const *ctrl) {
+                             HeavyFootprintCtrl const *ctrl, int const numThreads) {
     HeavyFootprintCtrl ctrl_s = HeavyFootprintCtrl();
 
     if (!ctrl) {
         ctrl = &ctrl_s;
     }
 
-    for (FootprintList::iterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
-        ptr->reset(new HeavyFootprint<ImagePixelT, MaskPixelT>(**ptr, mimg, ctrl));
-    }
+    // A HeavyFootprint shares its parent's PeakCatalog, so making one allocates only its pixel arrays
+    parallelForFootprints(*_footprints, numThreads, [&](std::size_t, std::shared_ptr<Footprint> &foot) {
+        foot.reset(new HeavyFootprint<ImagePixelT, MaskPixelT>(*foot, mimg, ctrl));
+    });
 }
 
 void FootprintSet::makeSources(afw::table::SourceCatalog &cat) const {
@@ -963,15 +1216,17 @@ void FootprintSet::makeSources(afw::table::SourceCatalog &cat) const {
 
 #ifndef DOXYGEN
 
-#define INSTANTIATE(PIXEL)                                                                              \
-    template FootprintSet::FootprintSet(image::Image<PIXEL> const &, Threshold const &, int const,      \
-                                        bool const);                                                    \
-    template FootprintSet::FootprintSet(image::MaskedImage<PIXEL, image::MaskPixel> const &,            \
-                                        Threshold const &, std::string const &, int const, bool const); \
-    template void FootprintSet::makeHeavy(image::MaskedImage<PIXEL, image::MaskPixel> const &,          \
-                                          HeavyFootprintCtrl const *)
-
-template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const);
+#define INSTANTIATE(PIXEL)                                                                                 \
+    template FootprintSet::FootprintSet(image::Image<PIXEL> const &, Threshold const &, int const,         \
+                                        bool const, int const);                                            \
+    template FootprintSet::FootprintSet(image::MaskedImage<PIXEL, image::MaskPixel> const &,               \
+                                        Threshold const &, std::string const &, int const, bool const,     \
+                                        int const);                                                        \
+    template void FootprintSet::makeHeavy(image::MaskedImage<PIXEL, image::MaskPixel> const &,             \
+                                          HeavyFootprintCtrl const *, int const)
+
+template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const,
+                                    int const);
 
 template void FootprintSet::setMask(image::Mask<image::MaskPixel> *, std::string const &);
 template void FootprintSet::setMask(std::shared_ptr<image::Mask<image::MaskPixel>>, std::string const &);
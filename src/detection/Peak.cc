@@ -79,6 +79,10 @@ public:
         table->setMetadata(metadata);
         return table;
     }
+
+    std::set<std::string> getRequiredFields(int ioFlags) const override {
+        return PeakTable::makeMinimalSchema().getNames();
+    }
 };
 
 // registers the reader so FitsReader::make can use it.
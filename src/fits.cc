@@ -1,6 +1,8 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <cstdio>
 #include <complex>
 #include <cmath>
@@ -1171,6 +1173,15 @@ void Fits::writeTableScalar(std::size_t row, int col, std::string const &value)
     }
 }
 
+void Fits::writeTableBytes(std::size_t row, std::size_t nBytes, void const *data) {
+    fits_write_tblbytes(reinterpret_cast<fitsfile *>(fptr), row + 1, 1, nBytes,
+                        static_cast<unsigned char *>(const_cast<void *>(data)), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this,
+                               boost::format("Writing %d bytes starting at table row %d") % nBytes % row);
+    }
+}
+
 template <typename T>
 void Fits::readTableArray(std::size_t row, int col, int nElements, T *value) {
     int anynul = false;
@@ -1218,6 +1229,133 @@ long Fits::getTableArraySize(std::size_t row, int col) {
     return result;
 }
 
+void Fits::readTableBytes(std::size_t row, std::size_t nBytes, void *data) {
+    fits_read_tblbytes(reinterpret_cast<fitsfile *>(fptr), row + 1, 1, nBytes,
+                       static_cast<unsigned char *>(data), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this,
+                               boost::format("Reading %d bytes starting at table row %d") % nBytes % row);
+    }
+}
+
+std::vector<std::ptrdiff_t> Fits::getTableColumnOffsets() {
+    fitsfile *fp = reinterpret_cast<fitsfile *>(fptr);
+    int nCols = 0;
+    fits_get_num_cols(fp, &nCols, &status);
+    std::vector<std::ptrdiff_t> offsets(nCols, -1);
+    // Read an optional numeric column key, returning a default if it's absent
+    auto readColumnKey = [this, fp](char const *prefix, int col, double defaultValue) {
+        std::string const key = (boost::format("%s%d") % prefix % (col + 1)).str();
+        double value = defaultValue;
+        if (status == 0 &&
+            fits_read_key(fp, TDOUBLE, const_cast<char *>(key.c_str()), &value, nullptr, &status) ==
+                    KEY_NO_EXIST) {
+            status = 0;
+            value = defaultValue;
+        }
+        return value;
+    };
+    std::ptrdiff_t offset = 0;
+    for (int col = 0; col < nCols && status == 0; ++col) {
+        int typecode = 0;
+        long repeat = 0;
+        long width = 0;
+        fits_get_coltype(fp, col + 1, &typecode, &repeat, &width, &status);
+        double const tscal = readColumnKey("TSCAL", col, 1.0);
+        double const tzero = readColumnKey("TZERO", col, 0.0);
+        std::ptrdiff_t size = 0;
+        if (typecode < 0) {
+            // Variable-length arrays are stored in the row as a descriptor: two 32-bit integers for
+            // TFORM code P, or two 64-bit integers for Q
+            std::string const key = (boost::format("TFORM%d") % (col + 1)).str();
+            char tform[FLEN_VALUE] = "";
+            fits_read_key(fp, TSTRING, const_cast<char *>(key.c_str()), tform, nullptr, &status);
+            size = std::string(tform).find('Q') == std::string::npos ? 8 : 16;
+        } else if (typecode == TBIT) {
+            size = (repeat + 7) / 8;
+        } else if (typecode == TSTRING) {
+            size = repeat;
+        } else {
+            size = repeat * width;
+        }
+        if (typecode > 0 && tscal == 1.0 && tzero == (typecode == TSHORT ? 32768.0 : 0.0)) {
+            offsets[col] = offset;
+        }
+        offset += size;
+    }
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Computing the layout of binary table rows");
+    }
+    if (offset != static_cast<std::ptrdiff_t>(getTableRowSize())) {
+        // Not a layout we understand; don't let anyone decode it
+        offsets.assign(nCols, -1);
+    }
+    return offsets;
+}
+
+std::vector<std::pair<char, std::size_t>> Fits::getTableColumnFormats() {
+    fitsfile *fp = reinterpret_cast<fitsfile *>(fptr);
+    int nCols = 0;
+    fits_get_num_cols(fp, &nCols, &status);
+    std::vector<std::pair<char, std::size_t>> formats(std::max(nCols, 0));
+    for (int col = 0; col < nCols && status == 0; ++col) {
+        int typecode = 0;
+        long repeat = 0;
+        long width = 0;
+        fits_get_coltype(fp, col + 1, &typecode, &repeat, &width, &status);
+        switch (std::abs(typecode)) {
+            case TBIT:
+                formats[col].first = 'X';
+                break;
+            case TBYTE:
+                formats[col].first = 'B';
+                break;
+            case TLOGICAL:
+                formats[col].first = 'L';
+                break;
+            case TSTRING:
+                formats[col].first = 'A';
+                break;
+            case TSHORT:
+                formats[col].first = 'I';
+                break;
+            case TLONG:
+                formats[col].first = 'J';
+                break;
+            case TLONGLONG:
+                formats[col].first = 'K';
+                break;
+            case TFLOAT:
+                formats[col].first = 'E';
+                break;
+            case TDOUBLE:
+                formats[col].first = 'D';
+                break;
+            case TCOMPLEX:
+                formats[col].first = 'C';
+                break;
+            case TDBLCOMPLEX:
+                formats[col].first = 'M';
+                break;
+        }
+        formats[col].second = repeat;
+    }
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Reading the formats of binary table columns");
+    }
+    return formats;
+}
+
+std::size_t Fits::getTableRowSize() {
+    long naxis1 = 0;
+    fits_read_key(reinterpret_cast<fitsfile *>(fptr), TLONG, const_cast<char *>("NAXIS1"), &naxis1, nullptr,
+                  &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Reading the row size of a binary table");
+    }
+    return naxis1;
+}
+
 // ---- Manipulating images ---------------------------------------------------------------------------------
 
 void Fits::createEmpty() {
@@ -26,14 +26,21 @@
  * Provide functions to stack images
  *
  */
+#include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <memory>
 
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/MaskedImageFitsReader.h"
 #include "lsst/afw/math/Stack.h"
 #include "lsst/afw/math/MaskedVector.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/geom/Angle.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -97,6 +104,349 @@ void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> con
     }
 }
 
+/* ************************************************************************** *
+ *
+ * A stacking engine for the commonest statistics, MEAN, MEDIAN and MEANCLIP
+ *
+ * ************************************************************************** */
+
+double const NaN = std::numeric_limits<double>::quiet_NaN();
+double const IQ_TO_STDEV = 0.741301109252802;  // 1 sigma in units of iqrange (assume Gaussian)
+int const STACK_TILE_WIDTH = 256;               // number of columns of each input image loaded at a time
+
+/**
+ * @internal Return a quantile of the first n values, interpolating as Statistics does
+ *
+ * The values are reordered; as the k'th smallest value doesn't depend on their order, the quantiles
+ * may be found one after another from the same buffer.
+ */
+template <typename PixelT>
+double interpolatedQuantile(std::vector<PixelT> &values, int const n, double const fraction) {
+    if (n == 0) {
+        return NaN;
+    } else if (n == 1) {
+        return values[0];
+    }
+    double const idx = fraction * (n - 1);
+    int const q1 = static_cast<int>(idx);
+    int const q2 = q1 + 1;
+
+    auto const begin = values.begin();
+    auto const end = begin + n;
+    std::nth_element(begin, begin + q1, end);
+    double const val1 = static_cast<double>(begin[q1]);
+    double const val2 = static_cast<double>(*std::min_element(begin + q2, end));  // the q2'th smallest
+    return (static_cast<double>(q2) - idx) * val1 + (idx - static_cast<double>(q1)) * val2;
+}
+
+/// @internal The result of stacking one pixel
+struct StackedPixel {
+    double value;
+    double variance;
+    image::MaskPixel orMask;  // OR of the good pixels' masks, including propagated bits
+    int n;                    // number of good pixels
+    int nClipped;             // number of good pixels that were clipped
+};
+
+/**
+ * @internal Compute MEAN, MEDIAN, or MEANCLIP of a stack of pixels
+ *
+ * The results are the same (up to rounding) as those of constructing a Statistics object from a
+ * MaskedVector holding the pixels, but the workspace is reused from one pixel to the next and the
+ * flags are only interpreted once.
+ */
+template <typename PixelT>
+class PixelStacker {
+public:
+    /// Can we handle the requested statistic?
+    static bool handles(Property const flags) {
+        Property const prop = static_cast<Property>(flags & ~ERRORS);
+        return prop == MEAN || prop == MEDIAN || prop == MEANCLIP;
+    }
+
+    /**
+     * @param flags the statistic to compute; one of those for which handles() is true
+     * @param sctrl how to compute it
+     * @param useWeights use the weights passed to operator()
+     * @param nImage the number of pixels in each stack
+     */
+    PixelStacker(Property const flags, StatisticsControl const &sctrl, bool const useWeights,
+                 int const nImage)
+            : _prop(static_cast<Property>(flags & ~ERRORS)),
+              _useWeights(useWeights),
+              _nanSafe(sctrl.getNanSafe()),
+              _calcErrorFromInputVariance(sctrl.getCalcErrorFromInputVariance()),
+              _andMask(sctrl.getAndMask()),
+              _numSigmaClip(sctrl.getNumSigmaClip()),
+              _numIter(sctrl.getNumIter()),
+              _propagatedBits(),
+              _thresholds(),
+              _rejectedWeights(),
+              _scratch(nImage) {
+        for (int bit = 0; bit < std::numeric_limits<image::MaskPixel>::digits; ++bit) {
+            double const threshold = sctrl.getMaskPropagationThreshold(bit);
+            if (threshold < 1.0) {  // we can't reject more than all the weight
+                _propagatedBits.push_back(bit);
+                _thresholds.push_back(threshold);
+            }
+        }
+        _rejectedWeights.resize(_propagatedBits.size());
+    }
+
+    PixelStacker(PixelStacker const &) = delete;
+    PixelStacker(PixelStacker &&) = delete;
+    PixelStacker &operator=(PixelStacker const &) = delete;
+    PixelStacker &operator=(PixelStacker &&) = delete;
+    ~PixelStacker() = default;
+
+    /**
+     * Stack one pixel
+     *
+     * The i'th input pixel is values[i*stride] (and similarly for masks, variances, and weights)
+     *
+     * @param values the input pixels' values
+     * @param masks the input pixels' masks
+     * @param variances the input pixels' variances
+     * @param weights the input pixels' (multiplicative) weights; ignored unless useWeights
+     * @param nImage number of input pixels
+     * @param stride spacing of the input pixels in the arrays
+     */
+    StackedPixel operator()(PixelT const *values, image::MaskPixel const *masks,
+                            image::VariancePixel const *variances, WeightPixel const *weights,
+                            int const nImage, int const stride) {
+        // A crude estimate of the mean, to use as the origin for the sums (cf. getStandard)
+        int nGood = 0;
+        double sumGood = 0.0;
+        for (int i = 0; i < nImage; ++i) {
+            if (isGood(values[i * stride], masks[i * stride])) {
+                ++nGood;
+                sumGood += values[i * stride];
+            }
+        }
+        double const meanCrude = (nGood > 0) ? sumGood / nGood : 0.0;
+
+        StackedPixel result = {NaN, NaN, 0x0, 0, 0};
+        Moments const standard =
+                accumulate<false>(values, masks, variances, weights, nImage, stride, meanCrude, 0.0, &result);
+        result.n = standard.n;
+
+        if (_prop == MEAN) {
+            result.value = standard.mean;
+            result.variance = standard.meanVariance;
+            return result;
+        }
+
+        // copy the good pixels for the quantiles
+        int nCopy = 0;
+        for (int i = 0; i < nImage; ++i) {
+            if (isGood(values[i * stride], masks[i * stride])) {
+                _scratch[nCopy++] = values[i * stride];
+            }
+        }
+        double const median = interpolatedQuantile(_scratch, nCopy, 0.5);
+        if (_prop == MEDIAN) {
+            result.value = median;
+            result.variance = geom::HALFPI * standard.variance / standard.n;
+            return result;
+        }
+
+        double const iqrange =
+                interpolatedQuantile(_scratch, nCopy, 0.75) - interpolatedQuantile(_scratch, nCopy, 0.25);
+        Moments clipped = standard;
+        for (int iter = 0; iter < _numIter; ++iter) {
+            double const center = (iter > 0) ? clipped.mean : median;
+            double const hwidth = (iter > 0 && standard.n > 1) ? _numSigmaClip * std::sqrt(clipped.variance)
+                                                                : _numSigmaClip * IQ_TO_STDEV * iqrange;
+            if (std::isnan(center) || std::isnan(hwidth)) {
+                clipped = Moments();
+            } else {
+                clipped = accumulate<true>(values, masks, variances, weights, nImage, stride, center, hwidth,
+                                           nullptr);
+            }
+        }
+        result.value = clipped.mean;
+        result.variance = clipped.meanVariance;
+        result.nClipped = standard.n - clipped.n;
+        return result;
+    }
+
+private:
+    /// The number of good pixels, and the (weighted) moments of their values
+    struct Moments {
+        Moments() : n(0), mean(NaN), variance(NaN), meanVariance(NaN) {}
+
+        int n;
+        double mean;
+        double variance;      // unbiased estimate of the population variance
+        double meanVariance;  // (standard error of the mean)^2
+    };
+
+    bool isGood(PixelT const value, image::MaskPixel const mask) const {
+        return (!_nanSafe || std::isfinite(static_cast<float>(value))) && !(mask & _andMask);
+    }
+
+    /*
+     * Compute the moments of the good pixels (within cliplimit of center, if doClip), as processPixels does
+     *
+     * If result is non-null, set its orMask (including any propagated mask bits)
+     */
+    template <bool doClip>
+    Moments accumulate(PixelT const *values, image::MaskPixel const *masks,
+                       image::VariancePixel const *variances, WeightPixel const *weights, int const nImage,
+                       int const stride, double const center, double const cliplimit, StackedPixel *result) {
+        int n = 0;
+        double sumw = 0.0;    // sum(weight)
+        double sumw2 = 0.0;   // sum(weight^2)
+        double sumx = 0.0;    // sum(data*weight)
+        double sumx2 = 0.0;   // sum(data*weight^2)
+        double sumvw2 = 0.0;  // sum(variance*weight^2)
+        image::MaskPixel orMask = 0x0;
+        std::fill(_rejectedWeights.begin(), _rejectedWeights.end(), 0.0);
+
+        for (int i = 0; i < nImage; ++i) {
+            PixelT const value = values[i * stride];
+            image::MaskPixel const mask = masks[i * stride];
+            double const weight = _useWeights ? static_cast<double>(weights[i * stride]) : 1.0;
+            if (isGood(value, mask) && (!doClip || std::fabs(value - center) <= cliplimit)) {
+                double const delta = value - center;
+                ++n;
+                sumw += weight;
+                sumw2 += weight * weight;
+                sumx += weight * delta;
+                sumx2 += weight * delta * delta;
+                if (_calcErrorFromInputVariance) {
+                    sumvw2 += variances[i * stride] * weight * weight;
+                }
+                orMask |= mask;
+            } else if (result) {
+                for (std::size_t j = 0; j != _propagatedBits.size(); ++j) {
+                    if (mask & (1 << _propagatedBits[j])) {
+                        _rejectedWeights[j] += weight;
+                    }
+                }
+            }
+        }
+
+        if (result) {
+            for (std::size_t j = 0; j != _propagatedBits.size(); ++j) {
+                if (_rejectedWeights[j] / (sumw + _rejectedWeights[j]) > _thresholds[j]) {
+                    orMask |= (1 << _propagatedBits[j]);
+                }
+            }
+            result->orMask = orMask;
+        }
+
+        // N.b. if sumw == 0 or sumw*sumw == sumw2 (e.g. n == 1) we'll get NaNs, just like Statistics
+        Moments moments;
+        moments.n = n;
+        double const mean = sumx / sumw;
+        moments.variance = (sumx2 / sumw - mean * mean) * sumw * sumw / (sumw * sumw - sumw2);
+        if (_calcErrorFromInputVariance) {
+            moments.meanVariance = sumvw2 / (sumw * sumw);
+        } else {
+            moments.meanVariance = moments.variance * sumw2 / (sumw * sumw);
+        }
+        moments.mean = mean + center;
+        return moments;
+    }
+
+    Property const _prop;                    // the statistic to compute
+    bool const _useWeights;                  // use the weights?
+    bool const _nanSafe;                     // reject NaNs and Infs?
+    bool const _calcErrorFromInputVariance;  // calculate the errors from the input variances?
+    int const _andMask;                      // mask bits that cause a pixel to be ignored
+    double const _numSigmaClip;              // number of standard deviations to clip at
+    int const _numIter;                      // number of clipping iterations
+    std::vector<int> _propagatedBits;        // mask bits with a propagation threshold
+    std::vector<double> _thresholds;         // the thresholds for _propagatedBits
+    std::vector<double> _rejectedWeights;    // workspace: rejected weight for each of _propagatedBits
+    std::vector<PixelT> _scratch;            // workspace: the good pixels' values
+};
+
+/**
+ * @internal Stack MaskedImages using a PixelStacker
+ *
+ * For each row we load STACK_TILE_WIDTH columns of every input into contiguous [nImage x tileWidth]
+ * buffers, and then stack each column of the buffers; there is no per-pixel allocation.  The rows are
+ * split into sctrl.getNumThreads() bands which are stacked in parallel.
+ */
+template <typename PixelT, bool isWeighted, bool useVariance>
+void computeMaskedImageStackTiled(image::MaskedImage<PixelT> &imgStack,
+                                  std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
+                                  Property flags, StatisticsControl const &sctrl,
+                                  image::MaskPixel const clipped,
+                                  std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                                  WeightVector const &wvector) {
+    int const nImage = images.size();
+    int const width = imgStack.getWidth();
+    int const tileWidth = std::max(1, std::min(width, STACK_TILE_WIDTH));
+
+    image::MaskPixel const noGoodPixelsMask = sctrl.getNoGoodPixelsMask();
+
+    // Each band of rows has its own buffers and PixelStacker
+    int const nThreads = detail::resolveNumThreads(sctrl.getNumThreads());
+    detail::parallelForChunks(0, imgStack.getHeight(), nThreads, [&](int y0, int y1, int) {
+        std::vector<PixelT> values(nImage * tileWidth);
+        std::vector<image::MaskPixel> masks(nImage * tileWidth);
+        std::vector<image::VariancePixel> variances(nImage * tileWidth);
+        std::vector<WeightPixel> weights(isWeighted ? nImage * tileWidth : 0);
+        if (isWeighted && !useVariance) {  // the weights are the same for every pixel
+            for (int i = 0; i < nImage; ++i) {
+                std::fill(weights.begin() + i * tileWidth, weights.begin() + (i + 1) * tileWidth, wvector[i]);
+            }
+        }
+
+        PixelStacker<PixelT> stacker(flags, sctrl, isWeighted, nImage);
+
+        for (int y = y0; y != y1; ++y) {
+            typename image::MaskedImage<PixelT>::x_iterator ptr = imgStack.row_begin(y);
+            for (int x0 = 0; x0 < width; x0 += tileWidth) {
+                int const nx = std::min(tileWidth, width - x0);
+                for (int i = 0; i < nImage; ++i) {
+                    image::MaskedImage<PixelT> const &mi = *images[i];
+                    std::copy_n(mi.getImage()->row_begin(y) + x0, nx, values.begin() + i * tileWidth);
+                    std::copy_n(mi.getMask()->row_begin(y) + x0, nx, masks.begin() + i * tileWidth);
+                    std::copy_n(mi.getVariance()->row_begin(y) + x0, nx, variances.begin() + i * tileWidth);
+                    if (useVariance) {  // we're weighting using the variance
+                        for (int j = i * tileWidth, end = j + nx; j != end; ++j) {
+                            weights[j] = 1.0 / variances[j];
+                        }
+                    }
+                }
+
+                for (int x = 0; x < nx; ++x, ++ptr) {
+                    StackedPixel const pixel = stacker(&values[x], &masks[x], &variances[x],
+                                                       isWeighted ? &weights[x] : nullptr, nImage, tileWidth);
+
+                    image::MaskPixel msk = pixel.orMask;
+                    if (pixel.n == 0) {
+                        msk = noGoodPixelsMask;
+                    }
+                    // Check to see if any pixels were rejected due to clipping
+                    if (pixel.nClipped > 0) {
+                        msk |= clipped;
+                    }
+                    // Check to see if any pixels were rejected by masking, and apply
+                    // any associated masks to the result.
+                    if (pixel.n < nImage) {
+                        image::MaskPixel allMasks = 0x0;
+                        for (int i = 0; i < nImage; ++i) {
+                            allMasks |= masks[i * tileWidth + x];
+                        }
+                        for (auto const &pair : maskMap) {
+                            if (allMasks & pair.first) {
+                                msk |= pair.second;
+                            }
+                        }
+                    }
+
+                    *ptr = typename image::MaskedImage<PixelT>::Pixel(pixel.value, msk, pixel.variance);
+                }
+            }
+        }
+    });
+}
+
 /* ************************************************************************** *
  *
  * stack MaskedImages
@@ -118,87 +468,103 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
                              Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
                              std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
                              WeightVector const &wvector = WeightVector()) {
-    // get a list of row_begin iterators
+    if (PixelStacker<PixelT>::handles(flags)) {
+        computeMaskedImageStackTiled<PixelT, isWeighted, useVariance>(imgStack, images, flags, sctrl, clipped,
+                                                                      maskMap, wvector);
+        return;
+    }
+
     typedef typename image::MaskedImage<PixelT>::x_iterator x_iterator;
-    std::vector<x_iterator> rows;
-    rows.reserve(images.size());
 
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
-    WeightVector weights;                          // weights; non-const version
-    //
     StatisticsControl sctrlTmp(sctrl);
-
+    if (isWeighted) {
+        sctrlTmp.setWeighted(true);
+    }
+    sctrlTmp.setNumThreads(1);  // we parallelise over pixels, not within each stack of pixels
     if (useVariance) {  // weight using the variance image
         assert(isWeighted);
         assert(wvector.empty());
+    }
 
-        weights.resize(images.size());
-
-        sctrlTmp.setWeighted(true);
-    } else if (isWeighted) {
-        weights.assign(wvector.begin(), wvector.end());
-
-        sctrlTmp.setWeighted(true);
+    // Each band of rows is stacked by a different thread, with its own MaskedVector (made here, as
+    // constructing Masks isn't thread safe)
+    int const nChunk = std::min(detail::resolveNumThreads(sctrl.getNumThreads()), imgStack.getHeight());
+    std::vector<std::unique_ptr<MaskedVector<PixelT>>> pixelSets;
+    for (int i = 0; i < std::max(1, nChunk); ++i) {
+        pixelSets.emplace_back(new MaskedVector<PixelT>(images.size()));  // a pixel from x,y for each image
     }
-    assert(weights.empty() || weights.size() == images.size());
 
-    // loop over x,y ... the loop over the stack to fill pixelSet
-    // - get the stats on pixelSet and put the value in the output image at x,y
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
-        for (unsigned int i = 0; i < images.size(); ++i) {
-            x_iterator ptr = images[i]->row_begin(y);
-            if (y == 0) {
-                rows.push_back(ptr);
-            } else {
-                rows[i] = ptr;
-            }
+    detail::parallelForChunks(0, imgStack.getHeight(), nChunk, [&](int y0, int y1, int iChunk) {
+        MaskedVector<PixelT> &pixelSet = *pixelSets[iChunk];
+        std::vector<x_iterator> rows;  // row_begin iterators for each image
+        rows.reserve(images.size());
+        WeightVector weights;  // weights; non-const version
+        if (useVariance) {
+            weights.resize(images.size());
+        } else if (isWeighted) {
+            weights.assign(wvector.begin(), wvector.end());
         }
-
-        for (x_iterator ptr = imgStack.row_begin(y), end = imgStack.row_end(y); ptr != end; ++ptr) {
-            typename MaskedVector<PixelT>::iterator psPtr = pixelSet.begin();
-            WeightVector::iterator wtPtr = weights.begin();
-            for (unsigned int i = 0; i < images.size(); ++rows[i], ++i, ++psPtr, ++wtPtr) {
-                *psPtr = *rows[i];
-                if (useVariance) {  // we're weighting using the variance
-                    *wtPtr = 1.0 / rows[i].variance();
+        assert(weights.empty() || weights.size() == images.size());
+
+        // loop over x,y ... the loop over the stack to fill pixelSet
+        // - get the stats on pixelSet and put the value in the output image at x,y
+        for (int y = y0; y != y1; ++y) {
+            for (unsigned int i = 0; i < images.size(); ++i) {
+                x_iterator ptr = images[i]->row_begin(y);
+                if (y == y0) {
+                    rows.push_back(ptr);
+                } else {
+                    rows[i] = ptr;
                 }
             }
 
-            Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
-            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
-                                         : makeStatistics(pixelSet, eflags, sctrlTmp);
-
-            PixelT variance = ::pow(stat.getError(flags), 2);
-            image::MaskPixel msk(stat.getOrMask());
-            int const npoint = stat.getValue(NPOINT);
-            if (npoint == 0) {
-                msk = sctrlTmp.getNoGoodPixelsMask();
-            } else if (npoint == 1) {
-                /*
-                 * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
-                 * getting a variance of NaN when you only have one input
-                 */
-            }
-            // Check to see if any pixels were rejected due to clipping
-            if (stat.getValue(NCLIPPED) > 0) {
-                msk |= clipped;
-            }
-            // Check to see if any pixels were rejected by masking, and apply
-            // any associated masks to the result.
-            if (stat.getValue(NMASKED) > 0) {
-                for (auto const &pair : maskMap) {
+            for (x_iterator ptr = imgStack.row_begin(y), end = imgStack.row_end(y); ptr != end; ++ptr) {
+                typename MaskedVector<PixelT>::iterator psPtr = pixelSet.begin();
+                WeightVector::iterator wtPtr = weights.begin();
+                for (unsigned int i = 0; i < images.size(); ++rows[i], ++i, ++psPtr, ++wtPtr) {
+                    *psPtr = *rows[i];
+                    if (useVariance) {  // we're weighting using the variance
+                        *wtPtr = 1.0 / rows[i].variance();
+                    }
+                }
+
+                Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
+                Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
+                                             : makeStatistics(pixelSet, eflags, sctrlTmp);
+
+                PixelT variance = ::pow(stat.getError(flags), 2);
+                image::MaskPixel msk(stat.getOrMask());
+                int const npoint = stat.getValue(NPOINT);
+                if (npoint == 0) {
+                    msk = sctrlTmp.getNoGoodPixelsMask();
+                } else if (npoint == 1) {
+                    /*
+                     * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
+                     * getting a variance of NaN when you only have one input
+                     */
+                }
+                // Check to see if any pixels were rejected due to clipping
+                if (stat.getValue(NCLIPPED) > 0) {
+                    msk |= clipped;
+                }
+                // Check to see if any pixels were rejected by masking, and apply
+                // any associated masks to the result.
+                if (stat.getValue(NMASKED) > 0) {
+                    image::MaskPixel allMasks = 0x0;
                     for (auto pp = pixelSet.begin(); pp != pixelSet.end(); ++pp) {
-                        if ((*pp).mask() & pair.first) {
+                        allMasks |= (*pp).mask();
+                    }
+                    for (auto const &pair : maskMap) {
+                        if (allMasks & pair.first) {
                             msk |= pair.second;
-                            break;
                         }
                     }
                 }
-            }
 
-            *ptr = typename image::MaskedImage<PixelT>::Pixel(stat.getValue(flags), msk, variance);
+                *ptr = typename image::MaskedImage<PixelT>::Pixel(stat.getValue(flags), msk, variance);
+            }
         }
-    }
+    });
 }
 template <typename PixelT, bool isWeighted, bool useVariance>
 void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
@@ -286,6 +652,67 @@ void statisticsStack(image::MaskedImage<PixelT> &out,
     }
 }
 
+template <typename PixelT>
+void statisticsStack(
+        image::MaskedImage<PixelT> &out, int nImage,
+        std::function<std::shared_ptr<image::MaskedImage<PixelT>>(int, lsst::geom::Box2I const &)> const
+                &readBand,
+        Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel clipped,
+        std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap, int bandHeight) {
+    if (nImage <= 0) {
+        throw LSST_EXCEPT(pexExcept::LengthError, "Please specify at least one image to stack");
+    }
+    if (bandHeight <= 0) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          str(boost::format("bandHeight must be positive, not %d") % bandHeight));
+    }
+    std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> bands(nImage);
+    checkObjectsAndWeights(bands, wvector);
+    checkOnlyOneFlag(flags);
+    /*
+     * The inputs are read on this thread, as readBand needn't be thread safe (e.g. it may call python);
+     * the stacking of each band is multithreaded as for the in-memory version
+     */
+    int const width = out.getWidth();
+    int const height = out.getHeight();
+    for (int y0 = 0; y0 < height; y0 += bandHeight) {
+        lsst::geom::Box2I const bbox(lsst::geom::Point2I(out.getX0(), out.getY0() + y0),
+                                     lsst::geom::Extent2I(width, std::min(bandHeight, height - y0)));
+        for (int i = 0; i < nImage; ++i) {
+            bands[i] = readBand(i, bbox);
+            if (!bands[i]) {
+                throw LSST_EXCEPT(pexExcept::NotFoundError,
+                                  str(boost::format("No pixels returned for image %d in band starting at "
+                                                    "row %d") % i % bbox.getMinY()));
+            }
+        }
+        image::MaskedImage<PixelT> outBand(out, bbox, image::PARENT);  // shares out's pixels
+        statisticsStack(outBand, bands, flags, sctrl, wvector, clipped, maskMap);
+        for (auto &band : bands) {  // release the inputs before reading the next band
+            band.reset();
+        }
+    }
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out, std::vector<std::string> const &fileNames,
+                     Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                     image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                     int bandHeight) {
+    // Open each file once, so its headers are parsed once rather than once per band
+    std::vector<std::unique_ptr<image::MaskedImageFitsReader>> readers;
+    readers.reserve(fileNames.size());
+    for (auto const &fileName : fileNames) {
+        readers.push_back(std::make_unique<image::MaskedImageFitsReader>(fileName));
+    }
+    auto readBand = [&readers](int i, lsst::geom::Box2I const &bbox) {
+        return std::make_shared<image::MaskedImage<PixelT>>(readers[i]->read<PixelT>(bbox, image::PARENT));
+    };
+    statisticsStack<PixelT>(out, fileNames.size(), readBand, flags, sctrl, wvector, clipped, maskMap,
+                            bandHeight);
+}
+
 namespace {
 /* ************************************************************************** *
  *
@@ -546,6 +973,16 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
             image::MaskedImage<TYPE> & out, std::vector<std::shared_ptr<image::MaskedImage<TYPE>>> & images, \
             Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &);                             \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out, int nImage,                                                      \
+            std::function<std::shared_ptr<image::MaskedImage<TYPE>>(int, lsst::geom::Box2I const &)> const & \
+                    readBand,                                                                                \
+            Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int bandHeight);             \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out, std::vector<std::string> const &fileNames, Property flags,       \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,                   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int bandHeight);             \
     template std::vector<TYPE> statisticsStack<TYPE>(                                       \
             std::vector<std::vector<TYPE>> & vectors, Property flags,                       \
             StatisticsControl const &sctrl, WeightVector const &wvector);                                    \
@@ -28,6 +28,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -37,6 +38,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/geom/Angle.h"
 
 using namespace std;
@@ -149,11 +151,262 @@ typedef std::tuple<int,                // n
         StandardReturn;
 
 /*
- * Functions which convert the booleans into calls to the proper templated types, one type per
- * recursion level
+ * Row accessors for the blocked inner loop.
+ *
+ * RowPointers<T>[y] returns something that may be indexed by column; the primary template is used
+ * for types whose rows can't be accessed that way, and such types always use the iterator-based loop.
+ */
+template <typename ImageT>
+class RowPointers {
+public:
+    static bool const isContiguous = false;
+};
+
+template <typename PixelT>
+class RowPointers<image::Image<PixelT> > {
+public:
+    static bool const isContiguous = true;
+    explicit RowPointers(image::Image<PixelT> const &img) : _array(img.getArray()) {}
+    PixelT const *operator[](int y) const { return _array[y].getData(); }
+
+private:
+    typename image::Image<PixelT>::ConstArray _array;
+};
+
+template <typename PixelT>
+class RowPointers<image::Mask<PixelT> > {
+public:
+    static bool const isContiguous = true;
+    explicit RowPointers(image::Mask<PixelT> const &msk) : _array(msk.getArray()) {}
+    PixelT const *operator[](int y) const { return _array[y].getData(); }
+
+private:
+    typename image::Mask<PixelT>::ConstArray _array;
+};
+
+template <typename ValueT>
+class RowPointers<ImageImposter<ValueT> > {
+public:
+    static bool const isContiguous = true;
+    explicit RowPointers(ImageImposter<ValueT> const &img) : _data(&*img.row_begin(0)) {}
+    ValueT const *operator[](int) const { return _data; }
+
+private:
+    ValueT const *_data;
+};
+
+/// @internal A row of a MaskImposter: every column has the same value
+template <typename ValueT>
+class ConstantRow {
+public:
+    explicit ConstantRow(ValueT val) : _val(val) {}
+    ValueT operator[](int) const { return _val; }
+
+private:
+    ValueT _val;
+};
+
+template <typename ValueT>
+class RowPointers<MaskImposter<ValueT> > {
+public:
+    static bool const isContiguous = true;
+    explicit RowPointers(MaskImposter<ValueT> const &msk) : _row(*msk.row_begin(0)) {}
+    ConstantRow<ValueT> operator[](int) const { return _row; }
+
+private:
+    ConstantRow<ValueT> _row;
+};
+
+int const BLOCK_SIZE = 8;  // number of independent accumulators in accumulateBlockedRow
+
+/**
+ * @internal Accumulate the unweighted sums for one row of pixels, BLOCK_SIZE pixels at a time
+ *
+ * Each lane of a block keeps its own partial sums, and the tests are evaluated as selects rather
+ * than as branches, so the compiler is able to keep the whole block in vector registers (SSE, AVX2
+ * or AVX-512, depending on the target flags; gcc also needs -fno-trapping-math, which is clang's
+ * default).  Even when it isn't vectorised, the independent lanes break the dependency chain of the
+ * sums.  The lanes are combined at the end of the row.
+ */
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          bool calcErrorFromInputVariance, typename PixelT, typename MaskRowT, typename VarianceRowT>
+void accumulateBlockedRow(PixelT const *ptr, MaskRowT const &mrow, VarianceRowT const &vrow, int const width,
+                          double const meanCrude, double const cliplimit, int const andMask, int &n,
+                          double &sumx, double &sumx2,
+                          double &sumvw2, double &min, double &max, image::MaskPixel &allPixelOrMask) {
+    int nLane[BLOCK_SIZE] = {0};
+    double sumxLane[BLOCK_SIZE] = {0.0};
+    double sumx2Lane[BLOCK_SIZE] = {0.0};
+    double sumvLane[BLOCK_SIZE] = {0.0};
+    double minLane[BLOCK_SIZE];
+    double maxLane[BLOCK_SIZE];
+    image::MaskPixel orMaskLane[BLOCK_SIZE] = {0x0};
+    std::fill(minLane, minLane + BLOCK_SIZE, min);
+    std::fill(maxLane, maxLane + BLOCK_SIZE, max);
+
+    int const nBlocked = width - width % BLOCK_SIZE;
+    for (int x0 = 0; x0 < nBlocked; x0 += BLOCK_SIZE) {
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            PixelT const val = ptr[x0 + i];
+            image::MaskPixel const mval = mrow[x0 + i];
+            // N.b. "&" not "&&", so there's no branch to stop the compiler vectorising the loop
+            bool const good = IsFinite()(val) & !(mval & andMask) & InClipRange()(val, meanCrude, cliplimit);
+            double const delta = good ? static_cast<double>(val) - meanCrude : 0.0;
+
+            nLane[i] += good ? 1 : 0;
+            sumxLane[i] += delta;
+            sumx2Lane[i] += delta * delta;
+            if (calcErrorFromInputVariance) {
+                sumvLane[i] += good ? static_cast<double>(vrow[x0 + i]) : 0.0;
+            }
+            orMaskLane[i] |= good ? mval : 0x0;
+            minLane[i] = (good & HasValueLtMin()(val, minLane[i])) ? static_cast<double>(val) : minLane[i];
+            maxLane[i] = (good & HasValueGtMax()(val, maxLane[i])) ? static_cast<double>(val) : maxLane[i];
+        }
+    }
+    for (int x = nBlocked; x < width; ++x) {  // the ragged end of the row
+        PixelT const val = ptr[x];
+        image::MaskPixel const mval = mrow[x];
+        if (IsFinite()(val) && !(mval & andMask) && InClipRange()(val, meanCrude, cliplimit)) {
+            double const delta = val - meanCrude;
+
+            ++nLane[0];
+            sumxLane[0] += delta;
+            sumx2Lane[0] += delta * delta;
+            if (calcErrorFromInputVariance) {
+                sumvLane[0] += vrow[x];
+            }
+            orMaskLane[0] |= mval;
+            if (HasValueLtMin()(val, minLane[0])) {
+                minLane[0] = val;
+            }
+            if (HasValueGtMax()(val, maxLane[0])) {
+                maxLane[0] = val;
+            }
+        }
+    }
+
+    for (int i = 0; i < BLOCK_SIZE; ++i) {
+        n += nLane[i];
+        sumx += sumxLane[i];
+        sumx2 += sumx2Lane[i];
+        sumvw2 += sumvLane[i];
+        allPixelOrMask |= orMaskLane[i];
+        if (HasValueLtMin()(minLane[i], min)) {
+            min = minLane[i];
+        }
+        if (HasValueGtMax()(maxLane[i], max)) {
+            max = maxLane[i];
+        }
+    }
+}
+
+int const MIN_PIXELS_PER_THREAD = 1 << 16;  // don't start another thread for fewer pixels than this
+
+/**
+ * @internal Choose the number of bands of rows to process in parallel
+ *
+ * @param nThreads the number of threads requested (0: one per hardware thread)
+ * @param nPix the number of pixels that will be processed
+ */
+int chooseNumChunks(int const nThreads, double const nPix) {
+    double const maxChunks = std::max(1.0, std::floor(nPix / MIN_PIXELS_PER_THREAD));
+    return static_cast<int>(std::min<double>(detail::resolveNumThreads(nThreads), maxChunks));
+}
+
+/**
+ * @internal The partial sums accumulated by processPixels over a band of rows
+ *
+ * Each thread accumulates its own PixelSums, and they are merged in order of increasing row
+ */
+struct PixelSums {
+    PixelSums(double const min_, double const max_, std::size_t const nBit)
+            : n(0),
+              sumw(0.0),
+              sumw2(0.0),
+              sumx(0.0),
+              sumx2(0.0),
+              sumvw2(0.0),
+              min(min_),
+              max(max_),
+              allPixelOrMask(0x0),
+              rejectedWeightsByBit(nBit, 0.0) {}
+
+    /// Add the sums from another band of rows into this one
+    template <typename HasValueLtMin, typename HasValueGtMax>
+    void merge(PixelSums const &other) {
+        n += other.n;
+        sumw += other.sumw;
+        sumw2 += other.sumw2;
+        sumx += other.sumx;
+        sumx2 += other.sumx2;
+        sumvw2 += other.sumvw2;
+        if (HasValueLtMin()(other.min, min)) {
+            min = other.min;
+        }
+        if (HasValueGtMax()(other.max, max)) {
+            max = other.max;
+        }
+        allPixelOrMask |= other.allPixelOrMask;
+        for (std::size_t bit = 0; bit != rejectedWeightsByBit.size(); ++bit) {
+            rejectedWeightsByBit[bit] += other.rejectedWeightsByBit[bit];
+        }
+    }
+
+    int n;
+    double sumw;    // sum(weight)  (N.b. only accumulated if useWeights)
+    double sumw2;   // sum(weight^2)
+    double sumx;    // sum(data*weight)
+    double sumx2;   // sum(data*weight^2)
+    double sumvw2;  // sum(variance*weight^2)
+    double min;
+    double max;
+    image::MaskPixel allPixelOrMask;
+    std::vector<double> rejectedWeightsByBit;
+};
+
+/// @internal Return the first row >= y that's a multiple of stride
+inline int firstStridedRow(int const y, int const stride) { return ((y + stride - 1) / stride) * stride; }
+
+/**
+ * @internal Accumulate the unweighted sums over every stride'th row in [y0, y1) using accumulateBlockedRow
+ *
+ * @returns false if the image, mask, or variance doesn't provide contiguous rows (in which
+ *          case nothing is done, and the caller must fall back to the iterator-based loop)
  */
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename ImageT, typename MaskT, typename VarianceT>
+bool accumulateBlocked(ImageT const &img, MaskT const &msk, VarianceT const &var, int const y0, int const y1,
+                       int const stride, double const meanCrude, double const cliplimit, int const andMask,
+                       bool const calcErrorFromInputVariance, PixelSums &sums, std::true_type) {
+    RowPointers<ImageT> const imgRows(img);
+    RowPointers<MaskT> const mskRows(msk);
+    RowPointers<VarianceT> const varRows(var);
+
+    int const width = img.getWidth();
+    for (int iY = firstStridedRow(y0, stride); iY < y1; iY += stride) {
+        if (calcErrorFromInputVariance) {
+            accumulateBlockedRow<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, true>(
+                    imgRows[iY], mskRows[iY], varRows[iY], width, meanCrude, cliplimit, andMask, sums.n,
+                    sums.sumx, sums.sumx2, sums.sumvw2, sums.min, sums.max, sums.allPixelOrMask);
+        } else {
+            accumulateBlockedRow<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
+                    imgRows[iY], mskRows[iY], varRows[iY], width, meanCrude, cliplimit, andMask, sums.n,
+                    sums.sumx, sums.sumx2, sums.sumvw2, sums.min, sums.max, sums.allPixelOrMask);
+        }
+    }
+    return true;
+}
+
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename ImageT, typename MaskT, typename VarianceT>
+bool accumulateBlocked(ImageT const &, MaskT const &, VarianceT const &, int const, int const, int const,
+                       double const, double const, int const, bool const, PixelSums &, std::false_type) {
+    return false;
+}
+
 /**
- * @internal This function handles the inner summation loop, with tests templated
+ * @internal Accumulate the sums over every stride'th row in [y0, y1), with tests templated
  *
  * The idea here is to allow different conditionals in the inner loop, but avoid repeating code.
  * Each test is actually a functor which is handled through a template.  If the
@@ -163,28 +416,24 @@ typedef std::tuple<int,                // n
  */
 template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
           bool useWeights, typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
-StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT const &var,
-                             WeightT const &weights, int const, int const nCrude, int const stride,
-                             double const meanCrude, double const cliplimit,
-                             bool const weightsAreMultiplicative, int const andMask,
-                             bool const calcErrorFromInputVariance,
-                             std::vector<double> const &maskPropagationThresholds) {
-    int n = 0;
-    double sumw = 0.0;   // sum(weight)  (N.b. weight will be 1.0 if !useWeights)
-    double sumw2 = 0.0;  // sum(weight^2)
-    double sumx = 0;     // sum(data*weight)
-    double sumx2 = 0;    // sum(data*weight^2)
-#if 1
-    double sumvw2 = 0.0;  // sum(variance*weight^2)
-#endif
-    double min = (nCrude) ? meanCrude : MAX_DOUBLE;
-    double max = (nCrude) ? meanCrude : -MAX_DOUBLE;
-
-    image::MaskPixel allPixelOrMask = 0x0;
-
-    std::vector<double> rejectedWeightsByBit(maskPropagationThresholds.size(), 0.0);
-
-    for (int iY = 0; iY < img.getHeight(); iY += stride) {
+void accumulatePixels(ImageT const &img, MaskT const &msk, VarianceT const &var, WeightT const &weights,
+                      int const y0, int const y1, int const stride, double const meanCrude,
+                      double const cliplimit, bool const weightsAreMultiplicative, int const andMask,
+                      bool const calcErrorFromInputVariance,
+                      std::vector<double> const &maskPropagationThresholds, PixelSums &sums) {
+    // Without weights or mask propagation we can use the blocked (vectorisable) loop
+    typedef std::integral_constant<bool, RowPointers<ImageT>::isContiguous &&
+                                                 RowPointers<MaskT>::isContiguous &&
+                                                 RowPointers<VarianceT>::isContiguous>
+            HasContiguousRows;
+    if (!useWeights && maskPropagationThresholds.empty() &&
+        accumulateBlocked<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange>(
+                img, msk, var, y0, y1, stride, meanCrude, cliplimit, andMask, calcErrorFromInputVariance,
+                sums, HasContiguousRows())) {
+        return;
+    }
+
+    for (int iY = firstStridedRow(y0, stride); iY < y1; iY += stride) {
         typename MaskT::x_iterator mptr = msk.row_begin(iY);
         typename VarianceT::x_iterator vptr = var.row_begin(iY);
         typename WeightT::x_iterator wptr = weights.row_begin(iY);
@@ -207,34 +456,34 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                         weight = 1 / weight;
                     }
 
-                    sumw += weight;
-                    sumw2 += weight * weight;
-                    sumx += weight * delta;
-                    sumx2 += weight * delta * delta;
+                    sums.sumw += weight;
+                    sums.sumw2 += weight * weight;
+                    sums.sumx += weight * delta;
+                    sums.sumx2 += weight * delta * delta;
 
                     if (calcErrorFromInputVariance) {
                         double const var = *vptr;
-                        sumvw2 += var * weight * weight;
+                        sums.sumvw2 += var * weight * weight;
                     }
                 } else {
-                    sumx += delta;
-                    sumx2 += delta * delta;
+                    sums.sumx += delta;
+                    sums.sumx2 += delta * delta;
 
                     if (calcErrorFromInputVariance) {
                         double const var = *vptr;
-                        sumvw2 += var;
+                        sums.sumvw2 += var;
                     }
                 }
 
-                allPixelOrMask |= *mptr;
+                sums.allPixelOrMask |= *mptr;
 
-                if (HasValueLtMin()(*ptr, min)) {
-                    min = *ptr;
+                if (HasValueLtMin()(*ptr, sums.min)) {
+                    sums.min = *ptr;
                 }
-                if (HasValueGtMax()(*ptr, max)) {
-                    max = *ptr;
+                if (HasValueGtMax()(*ptr, sums.max)) {
+                    sums.max = *ptr;
                 }
-                n++;
+                sums.n++;
             } else {  // pixel has been clipped, rejected, etc.
                 for (int bit = 0, nBits = maskPropagationThresholds.size(); bit < nBits; ++bit) {
                     image::MaskPixel mask = 1 << bit;
@@ -249,12 +498,60 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                                 weight = 1.0 / weight;
                             }
                         }
-                        rejectedWeightsByBit[bit] += weight;
+                        sums.rejectedWeightsByBit[bit] += weight;
                     }
                 }
             }
         }
     }
+}
+
+/*
+ * Functions which convert the booleans into calls to the proper templated types, one type per
+ * recursion level
+ */
+/**
+ * @internal This function handles the summation over the image, with tests templated (see accumulatePixels)
+ *
+ * The rows are split into up to nThreads bands which are summed in parallel; the partial sums are
+ * merged in order, so the results are reproducible for a given number of threads.
+ */
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          bool useWeights, typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
+StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT const &var,
+                             WeightT const &weights, int const, int const nCrude, int const stride,
+                             double const meanCrude, double const cliplimit,
+                             bool const weightsAreMultiplicative, int const andMask,
+                             bool const calcErrorFromInputVariance,
+                             std::vector<double> const &maskPropagationThresholds, int const nThreads) {
+    PixelSums const init((nCrude) ? meanCrude : MAX_DOUBLE, (nCrude) ? meanCrude : -MAX_DOUBLE,
+                         maskPropagationThresholds.size());
+
+    int const height = img.getHeight();
+    double const nPix = img.getWidth() * static_cast<double>((height + stride - 1) / stride);
+    int nChunk = chooseNumChunks(nThreads, nPix);
+    std::vector<PixelSums> partialSums(nChunk, init);
+    nChunk = detail::parallelForChunks(0, height, nChunk, [&](int y0, int y1, int iChunk) {
+        accumulatePixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, useWeights>(
+                img, msk, var, weights, y0, y1, stride, meanCrude, cliplimit, weightsAreMultiplicative,
+                andMask, calcErrorFromInputVariance, maskPropagationThresholds, partialSums[iChunk]);
+    });
+    for (int i = 1; i < nChunk; ++i) {
+        partialSums[0].merge<HasValueLtMin, HasValueGtMax>(partialSums[i]);
+    }
+    PixelSums const &sums = partialSums[0];
+
+    int const n = sums.n;
+    double sumw = sums.sumw;
+    double sumw2 = sums.sumw2;
+    double sumx = sums.sumx;
+    double const sumx2 = sums.sumx2;
+    double const sumvw2 = sums.sumvw2;
+    double min = sums.min;
+    double max = sums.max;
+    image::MaskPixel allPixelOrMask = sums.allPixelOrMask;
+    std::vector<double> rejectedWeightsByBit = sums.rejectedWeightsByBit;
+
     if (n == 0) {
         min = NaN;
         max = NaN;
@@ -290,8 +587,10 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
 
     double varVar = varianceError(variance, n);  // error in variance; incorrect if useWeights is true
 
-    sumx += sumw * meanCrude;
     mean += meanCrude;
+    if (sumw != 0) {
+        sumx = sumw * mean;  // guarantees that SUM == NPOINT*MEAN however the sums were accumulated
+    }
 
     return StandardReturn(n, sumx, Statistics::Value(mean, meanVar), Statistics::Value(variance, varVar), min,
                           max, allPixelOrMask);
@@ -304,15 +603,17 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                              double const meanCrude, double const cliplimit,
                              bool const weightsAreMultiplicative, int const andMask,
                              bool const calcErrorFromInputVariance, bool doGetWeighted,
-                             std::vector<double> const &maskPropagationThresholds) {
+                             std::vector<double> const &maskPropagationThresholds, int const nThreads) {
     if (doGetWeighted) {
         return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, true>(
-                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, maskPropagationThresholds);
+                img, msk, var, weights, flags, nCrude, stride, meanCrude, cliplimit,
+                weightsAreMultiplicative, andMask, calcErrorFromInputVariance, maskPropagationThresholds,
+                nThreads);
     } else {
         return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
-                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, maskPropagationThresholds);
+                img, msk, var, weights, flags, nCrude, stride, meanCrude, cliplimit,
+                weightsAreMultiplicative, andMask, calcErrorFromInputVariance, maskPropagationThresholds,
+                nThreads);
     }
 }
 
@@ -323,15 +624,17 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                              double const meanCrude, double const cliplimit,
                              bool const weightsAreMultiplicative, int const andMask,
                              bool const calcErrorFromInputVariance, bool doCheckFinite, bool doGetWeighted,
-                             std::vector<double> const &maskPropagationThresholds) {
+                             std::vector<double> const &maskPropagationThresholds, int const nThreads) {
     if (doCheckFinite) {
         return processPixels<CheckFinite, HasValueLtMin, HasValueGtMax, InClipRange, useWeights>(
-                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, doGetWeighted, maskPropagationThresholds);
+                img, msk, var, weights, flags, nCrude, stride, meanCrude, cliplimit,
+                weightsAreMultiplicative, andMask, calcErrorFromInputVariance, doGetWeighted,
+                maskPropagationThresholds, nThreads);
     } else {
         return processPixels<AlwaysTrue, HasValueLtMin, HasValueGtMax, InClipRange, useWeights>(
-                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, doGetWeighted, maskPropagationThresholds);
+                img, msk, var, weights, flags, nCrude, stride, meanCrude, cliplimit,
+                weightsAreMultiplicative, andMask, calcErrorFromInputVariance, doGetWeighted,
+                maskPropagationThresholds, nThreads);
     }
 }
 
@@ -349,6 +652,7 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
  * @param doCheckFinite check for NaN/Inf
  * @param doGetWeighted use the weights
  * @param maskPropagationThresholds
+ * @param nThreads number of threads to use (0: one per hardware thread)
  *
  * @note An overloaded version below is used to get clipped versions
  */
@@ -356,7 +660,7 @@ template <typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
 StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const &var, WeightT const &weights,
                            int const flags, bool const weightsAreMultiplicative, int const andMask,
                            bool const calcErrorFromInputVariance, bool doCheckFinite, bool doGetWeighted,
-                           std::vector<double> const &maskPropagationThresholds) {
+                           std::vector<double> const &maskPropagationThresholds, int const nThreads) {
     // =====================================================
     // a crude estimate of the mean, used for numerical stability of variance
     int nCrude = 0;
@@ -375,7 +679,7 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
     StandardReturn values = processPixels<ChkFin, AlwaysF, AlwaysF, AlwaysT, true>(
             img, msk, var, weights, flags, nCrude, strideCrude, meanCrude, cliplimit,
             weightsAreMultiplicative, andMask, calcErrorFromInputVariance, doCheckFinite, doGetWeighted,
-            maskPropagationThresholds);
+            maskPropagationThresholds, nThreads);
     nCrude = std::get<0>(values);
     double sumCrude = std::get<1>(values);
 
@@ -391,11 +695,13 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
     if (flags & (MIN | MAX)) {
         return processPixels<ChkFin, ChkMin, ChkMax, AlwaysT, true>(
                 img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, true, doGetWeighted, maskPropagationThresholds);
+                andMask, calcErrorFromInputVariance, true, doGetWeighted, maskPropagationThresholds,
+                nThreads);
     } else {
         return processPixels<ChkFin, AlwaysF, AlwaysF, AlwaysT, true>(
                 img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, doCheckFinite, doGetWeighted, maskPropagationThresholds);
+                andMask, calcErrorFromInputVariance, doCheckFinite, doGetWeighted, maskPropagationThresholds,
+                nThreads);
     }
 }
 
@@ -416,6 +722,7 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
  *   @param doCheckFinite check for NaN/Inf
  *   @param doGetWeighted use the weights,
  *   @param maskPropagationThresholds
+ *   @param nThreads number of threads to use (0: one per hardware thread)
  */
 template <typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
 StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const &var, WeightT const &weights,
@@ -423,7 +730,7 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
 
                            bool const weightsAreMultiplicative, int const andMask,
                            bool const calcErrorFromInputVariance, bool doCheckFinite, bool doGetWeighted,
-                           std::vector<double> const &maskPropagationThresholds) {
+                           std::vector<double> const &maskPropagationThresholds, int const nThreads) {
     double const center = clipinfo.first;
     double const cliplimit = clipinfo.second;
 
@@ -440,11 +747,13 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
     if (flags & (MIN | MAX)) {
         return processPixels<ChkFin, ChkMin, ChkMax, ChkClip, true>(
                 img, msk, var, weights, flags, nCrude, stride, center, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, true, doGetWeighted, maskPropagationThresholds);
+                andMask, calcErrorFromInputVariance, true, doGetWeighted, maskPropagationThresholds,
+                nThreads);
     } else {  // fast loop ... just the mean & variance
         return processPixels<ChkFin, AlwaysF, AlwaysF, ChkClip, true>(
                 img, msk, var, weights, flags, nCrude, stride, center, cliplimit, weightsAreMultiplicative,
-                andMask, calcErrorFromInputVariance, doCheckFinite, doGetWeighted, maskPropagationThresholds);
+                andMask, calcErrorFromInputVariance, doCheckFinite, doGetWeighted, maskPropagationThresholds,
+                nThreads);
     }
 }
 
@@ -722,11 +1031,382 @@ std::shared_ptr<std::vector<typename ImageT::Pixel> > makeVectorCopy(ImageT cons
 
     return imgcp;
 }
+
+/*
+ * Radix selection of quantiles
+ *
+ * RadixKey<Pixel> maps pixel values onto unsigned integers which sort in the same order as the values,
+ * so we can find the k'th smallest pixel by building histograms of successive digits of the keys.
+ */
+template <typename Pixel>
+struct RadixKey;
+
+template <>
+struct RadixKey<float> {
+    typedef std::uint32_t Type;
+    static Type fromValue(float val) {
+        Type bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);  // flip negatives; set sign of positives
+    }
+    static float toValue(Type key) {
+        Type const bits = (key & 0x80000000u) ? (key & ~0x80000000u) : ~key;
+        float val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return val;
+    }
+};
+
+template <>
+struct RadixKey<double> {
+    typedef std::uint64_t Type;
+    static Type fromValue(double val) {
+        Type const signBit = Type(1) << 63;
+        Type bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    static double toValue(Type key) {
+        Type const signBit = Type(1) << 63;
+        Type const bits = (key & signBit) ? (key & ~signBit) : ~key;
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return val;
+    }
+};
+
+template <>
+struct RadixKey<int> {
+    typedef std::uint32_t Type;
+    static Type fromValue(int val) { return static_cast<Type>(val) ^ 0x80000000u; }
+    static int toValue(Type key) { return static_cast<int>(key ^ 0x80000000u); }
+};
+
+template <>
+struct RadixKey<std::uint16_t> {
+    typedef std::uint16_t Type;
+    static Type fromValue(std::uint16_t val) { return val; }
+    static std::uint16_t toValue(Type key) { return key; }
+};
+
+template <>
+struct RadixKey<std::uint64_t> {
+    typedef std::uint64_t Type;
+    static Type fromValue(std::uint64_t val) { return val; }
+    static std::uint64_t toValue(Type key) { return key; }
+};
+
+int const RADIX_DIGIT_BITS = 16;                       // number of bits of the key handled per pass
+std::size_t const RADIX_NDIGIT = 1 << RADIX_DIGIT_BITS;  // number of bins in each histogram
+
+/// @internal One of the order statistics found by radixSelect
+template <typename Pixel>
+struct OrderStatistic {
+    Pixel value;         // value of the pixel with the desired rank
+    std::size_t nBelow;  // number of pixels with smaller values
+    std::size_t nEqual;  // number of pixels with this value
+};
+
+/**
+ * @internal Find the pixels whose ranks bracket the desired quantiles, without copying the image
+ *
+ * For each fraction f we find the pixels with (0-indexed) ranks int(f*(n - 1)) and the one after
+ * that (the same pixel if there is no next one), where n is the number of good pixels.
+ *
+ * We make one pass through the image for each RADIX_DIGIT_BITS of the pixel keys, starting with the
+ * most significant digit; each pass histograms the next digit of those pixels whose more significant
+ * digits match a pixel that we're looking for, and the cumulative histograms tell us the value of
+ * that digit.  The work is O(N) per pass, and the memory needed is one histogram per distinct prefix
+ * (at most 2 per fraction).
+ *
+ * @param img the image
+ * @param msk its mask
+ * @param andMask mask of bad pixels
+ * @param fractions the desired quantiles
+ * @param[out] lower the pixels with rank int(f*(n - 1)), one per fraction
+ * @param[out] upper the pixels with the following rank, one per fraction
+ * @param nThreads number of threads to use (0: one per hardware thread); each histograms a band of rows
+ *
+ * @returns the number of good pixels, n; if 0, lower and upper are empty
+ */
+template <typename IsFinite, typename ImageT, typename MaskT>
+std::size_t radixSelect(ImageT const &img, MaskT const &msk, int const andMask,
+                        std::vector<double> const &fractions,
+                        std::vector<OrderStatistic<typename ImageT::Pixel> > &lower,
+                        std::vector<OrderStatistic<typename ImageT::Pixel> > &upper, int const nThreads) {
+    typedef typename ImageT::Pixel Pixel;
+    typedef typename RadixKey<Pixel>::Type Key;
+    int const nBits = std::numeric_limits<Key>::digits;
+
+    struct Sought {           // a pixel we're looking for
+        std::size_t rank;     // the desired rank
+        Key prefix;           // the digits of its key that we've found so far
+        std::size_t nBelow;   // the number of pixels known to be smaller
+        std::size_t nEqual;   // the number of pixels with the same prefix (and current digit)
+        std::size_t group;    // index of prefix in the list of distinct prefixes
+    };
+    std::vector<Sought> sought;
+    std::vector<Key> prefixes;                      // the distinct values of Sought.prefix
+    std::vector<std::vector<std::uint32_t> > hists;  // the histograms for each prefix
+
+    lower.clear();
+    upper.clear();
+    std::size_t n = 0;                              // number of good pixels
+    for (int shift = nBits - RADIX_DIGIT_BITS; shift >= 0; shift -= RADIX_DIGIT_BITS) {
+        bool const isFirstPass = (shift == nBits - RADIX_DIGIT_BITS);
+
+        prefixes.clear();
+        if (isFirstPass) {
+            prefixes.push_back(0);
+        } else {
+            for (auto &sp : sought) {
+                sp.group = std::find(prefixes.begin(), prefixes.end(), sp.prefix) - prefixes.begin();
+                if (sp.group == prefixes.size()) {
+                    prefixes.push_back(sp.prefix);
+                }
+            }
+        }
+        hists.assign(prefixes.size(), std::vector<std::uint32_t>(RADIX_NDIGIT, 0));
+
+        // Each band of rows has its own histograms; as they're integers the order of summation is irrelevant
+        int nChunk = chooseNumChunks(nThreads, img.getWidth() * static_cast<double>(img.getHeight()));
+        std::vector<std::vector<std::vector<std::uint32_t> > > chunkHists(nChunk - 1, hists);
+        nChunk = detail::parallelForChunks(0, img.getHeight(), nChunk, [&](int y0, int y1, int iChunk) {
+            std::vector<std::vector<std::uint32_t> > &hs = (iChunk == 0) ? hists : chunkHists[iChunk - 1];
+            for (int iY = y0; iY < y1; ++iY) {
+                typename MaskT::x_iterator mptr = msk.row_begin(iY);
+                for (typename ImageT::x_iterator ptr = img.row_begin(iY), end = img.row_end(iY); ptr != end;
+                     ++ptr, ++mptr) {
+                    if (IsFinite()(*ptr) && !(*mptr & andMask)) {
+                        Key const key = RadixKey<Pixel>::fromValue(*ptr);
+                        std::size_t const digit = (key >> shift) & (RADIX_NDIGIT - 1);
+                        if (isFirstPass) {
+                            ++hs[0][digit];
+                        } else {
+                            Key const prefix = key >> (shift + RADIX_DIGIT_BITS);
+                            for (std::size_t i = 0; i != prefixes.size(); ++i) {
+                                if (prefix == prefixes[i]) {
+                                    ++hs[i][digit];
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+        for (int iChunk = 1; iChunk < nChunk; ++iChunk) {
+            for (std::size_t i = 0; i != hists.size(); ++i) {
+                for (std::size_t digit = 0; digit != RADIX_NDIGIT; ++digit) {
+                    hists[i][digit] += chunkHists[iChunk - 1][i][digit];
+                }
+            }
+        }
+
+        if (isFirstPass) {  // now we know how many good pixels there are, we know what we're looking for
+            for (auto count : hists[0]) {
+                n += count;
+            }
+            if (n == 0) {
+                return 0;
+            }
+            for (auto fraction : fractions) {
+                std::size_t const rank = static_cast<std::size_t>(fraction * (n - 1));
+                sought.push_back(Sought{rank, 0, 0, 0, 0});
+                sought.push_back(Sought{std::min(rank + 1, n - 1), 0, 0, 0, 0});
+            }
+        }
+        // Find the bin of the cumulative histogram that contains each desired rank
+        for (auto &sp : sought) {
+            std::vector<std::uint32_t> const &hist = hists[sp.group];
+            std::size_t digit = 0;
+            while (sp.nBelow + hist[digit] <= sp.rank) {
+                sp.nBelow += hist[digit];
+                ++digit;
+            }
+            sp.prefix = (isFirstPass ? 0 : (sp.prefix << RADIX_DIGIT_BITS)) | digit;
+            sp.nEqual = hist[digit];
+        }
+    }
+
+    for (std::size_t i = 0; i < sought.size(); i += 2) {
+        for (int j = 0; j != 2; ++j) {
+            Sought const &sp = sought[i + j];
+            OrderStatistic<Pixel> const stat = {RadixKey<Pixel>::toValue(sp.prefix), sp.nBelow, sp.nEqual};
+            (j == 0 ? lower : upper).push_back(stat);
+        }
+    }
+    return n;
+}
+
+/**
+ * @internal Compute a quantile from the order statistics found by radixSelect
+ *
+ * Specialisation for non-integral types; interpolate linearly between the adjacent values (cf. percentile)
+ */
+template <typename Pixel>
+typename enable_if<!is_integral<Pixel>::value, double>::type quantileFromOrderStatistics(
+        OrderStatistic<Pixel> const &lower, OrderStatistic<Pixel> const &upper, std::size_t const n,
+        double const fraction) {
+    double const idx = fraction * (n - 1);
+    int const q1 = static_cast<int>(idx);
+    int const q2 = q1 + 1;
+
+    double const w1 = (static_cast<double>(q2) - idx);
+    double const w2 = (idx - static_cast<double>(q1));
+    return w1 * static_cast<double>(lower.value) + w2 * static_cast<double>(upper.value);
+}
+
+/**
+ * @internal Compute a quantile from the order statistics found by radixSelect
+ *
+ * Specialisation for integral types, where we have to handle ties (cf. computeQuantile)
+ */
+template <typename Pixel>
+typename enable_if<is_integral<Pixel>::value, double>::type quantileFromOrderStatistics(
+        OrderStatistic<Pixel> const &lower, OrderStatistic<Pixel> const &, std::size_t const n,
+        double const fraction) {
+    if (n == 1) {
+        return lower.value;
+    }
+    return lower.value - 0.5 + (fraction * n - lower.nBelow) / lower.nEqual;
+}
+
+/**
+ * @internal Compute the median and (if !medianOnly) the quartiles using radixSelect
+ *
+ * Templated over the NaN test, as is makeVectorCopy
+ */
+template <typename IsFinite, typename ImageT, typename MaskT>
+MedianQuartileReturn radixMedianAndQuartiles(ImageT const &img, MaskT const &msk, int const andMask,
+                                             bool const medianOnly, int const nThreads) {
+    typedef typename ImageT::Pixel Pixel;
+
+    std::vector<double> fractions = {0.50};
+    if (!medianOnly) {
+        fractions.push_back(0.25);
+        fractions.push_back(0.75);
+    }
+    std::vector<OrderStatistic<Pixel> > lower, upper;
+    std::size_t const n = radixSelect<IsFinite>(img, msk, andMask, fractions, lower, upper, nThreads);
+    if (n == 0) {
+        return MedianQuartileReturn(NaN, NaN, NaN);
+    }
+
+    double const median = quantileFromOrderStatistics(lower[0], upper[0], n, fractions[0]);
+    if (medianOnly) {
+        return MedianQuartileReturn(median, NaN, NaN);
+    }
+    return MedianQuartileReturn(median, quantileFromOrderStatistics(lower[1], upper[1], n, fractions[1]),
+                                quantileFromOrderStatistics(lower[2], upper[2], n, fractions[2]));
+}
+
+/**
+ * @internal Sigma-clipped statistics computed from a sorted copy of the good pixels
+ *
+ * The pixels within a clipping range are a contiguous run of the sorted values, so each iteration
+ * only has to move the ends of the run, adding or subtracting the pixels that enter or leave it.
+ * After the first iteration this is O(rejected) work rather than a pass through the image (and its
+ * mask and variance).  Only unweighted statistics with errors from the sample variance are supported.
+ */
+template <typename Pixel>
+class IncrementalClipper {
+public:
+    /**
+     * @param values the good pixels; sorted in place, after removing NaNs and infinities (which are
+     *               never within a clipping range)
+     */
+    explicit IncrementalClipper(std::vector<Pixel> &values)
+            : _values(values), _ref(0.0), _begin(0), _end(0), _sumx(0.0), _sumx2(0.0) {
+        values.erase(std::remove_if(values.begin(), values.end(),
+                                    [](Pixel val) { return !CheckFinite()(val); }),
+                     values.end());
+        std::sort(values.begin(), values.end());
+        if (!values.empty()) {  // the sums are relative to the median, for numerical stability
+            _ref = values[values.size() / 2];
+        }
+    }
+
+    IncrementalClipper(IncrementalClipper const &) = delete;
+    IncrementalClipper &operator=(IncrementalClipper const &) = delete;
+
+    /**
+     * Return the statistics of the pixels within clipinfo.second of clipinfo.first
+     *
+     * Only the number of pixels, mean, and variance are set, as for the clipped getStandard
+     * that this replaces
+     */
+    StandardReturn clip(std::pair<double, double> const &clipinfo) {
+        double const center = clipinfo.first;
+        double const cliplimit = clipinfo.second;
+
+        if (std::isnan(center) || std::isnan(cliplimit)) {
+            return StandardReturn(0, NaN, Statistics::Value(NaN, NaN), Statistics::Value(NaN, NaN), NaN, NaN,
+                                  ~0x0);
+        }
+        // N.b. use the same test as CheckClipRange, so we choose exactly the same pixels
+        auto const first = std::partition_point(_values.begin(), _values.end(), [&](Pixel val) {
+            return val < center && !CheckClipRange()(val, center, cliplimit);
+        });
+        auto const last = std::partition_point(first, _values.end(), [&](Pixel val) {
+            return val < center || CheckClipRange()(val, center, cliplimit);
+        });
+        std::size_t const newBegin = first - _values.begin();
+        std::size_t const newEnd = last - _values.begin();
+
+        if (newBegin >= _end || newEnd <= _begin) {  // the runs don't overlap; start again
+            _begin = _end = newBegin;
+            _sumx = _sumx2 = 0.0;
+        }
+        while (_begin > newBegin) {
+            _add(_values[--_begin]);
+        }
+        while (_begin < newBegin) {
+            _subtract(_values[_begin++]);
+        }
+        while (_end < newEnd) {
+            _add(_values[_end++]);
+        }
+        while (_end > newEnd) {
+            _subtract(_values[--_end]);
+        }
+
+        // cf. processPixels with unit weights
+        int const n = _end - _begin;
+        double const sumw = n;
+        double mean = _sumx / sumw;
+        double variance = _sumx2 / sumw - ::pow(mean, 2);  // biased estimator
+        variance *= sumw * sumw / (sumw * sumw - sumw);     // debias
+        double const meanVar = variance / sumw;
+
+        mean += _ref;
+        return StandardReturn(n, sumw * mean, Statistics::Value(mean, meanVar),
+                              Statistics::Value(variance, varianceError(variance, n)), NaN, NaN, 0x0);
+    }
+
+private:
+    void _add(Pixel val) {
+        double const delta = val - _ref;
+        _sumx += delta;
+        _sumx2 += delta * delta;
+    }
+    void _subtract(Pixel val) {
+        double const delta = val - _ref;
+        _sumx -= delta;
+        _sumx2 -= delta * delta;
+    }
+
+    std::vector<Pixel> const &_values;  // the sorted good pixels
+    double _ref;                        // the reference value for the sums
+    std::size_t _begin, _end;           // the current run of pixels is [_begin, _end)
+    double _sumx;                       // sum(value - _ref) over the run
+    double _sumx2;                      // sum((value - _ref)^2) over the run
+};
 }  // namespace
 
 double StatisticsControl::getMaskPropagationThreshold(int bit) const {
     int oldSize = _maskPropagationThresholds.size();
-    if (oldSize < bit) {
+    if (oldSize <= bit) {
         return 1.0;
     }
     return _maskPropagationThresholds[bit];
@@ -867,7 +1547,7 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
     StandardReturn standard =
             getStandard(img, msk, var, weights, flags, _weightsAreMultiplicative, _sctrl.getAndMask(),
                         _sctrl.getCalcErrorFromInputVariance(), _sctrl.getNanSafe(), _sctrl.getWeighted(),
-                        _sctrl._maskPropagationThresholds);
+                        _sctrl._maskPropagationThresholds, _sctrl.getNumThreads());
 
     _n = std::get<0>(standard);
     _sum = std::get<1>(standard);
@@ -884,26 +1564,57 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
         _nMasked = num - _n;
     }
 
-    // copy the image for any routines that will use median or quantiles
+    // find the median and quartiles for any routines that will use them
     if (flags & (MEDIAN | IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
-        // make a vector copy of the image to get the median and quartiles (will move values)
+        // if we *only* want the median, we needn't find the quartiles
+        bool const medianOnly =
+                (flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP));
+
+        // A vector copy of the good pixels, if we need one for the quantiles or the clipping
         std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
-        if (_sctrl.getNanSafe()) {
-            imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
-        } else {
-            imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
-        }
 
-        // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
-        if ((flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP))) {
-            _median = Value(percentile(*imgcp, 0.5), NaN);
-        } else {
-            MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
+        if (_sctrl.getQuantileAlgorithm() == StatisticsControl::QUANTILE_RADIX_SELECT) {
+            MedianQuartileReturn mq;
+            if (_sctrl.getNanSafe()) {
+                mq = radixMedianAndQuartiles<ChkFin>(img, msk, _sctrl.getAndMask(), medianOnly,
+                                                     _sctrl.getNumThreads());
+            } else {
+                mq = radixMedianAndQuartiles<AlwaysT>(img, msk, _sctrl.getAndMask(), medianOnly,
+                                                      _sctrl.getNumThreads());
+            }
             _median = Value(std::get<0>(mq), NaN);
-            _iqrange = std::get<2>(mq) - std::get<1>(mq);
+            if (!medianOnly) {
+                _iqrange = std::get<2>(mq) - std::get<1>(mq);
+            }
+        } else {
+            // make a vector copy of the image to get the median and quartiles (will move values)
+            if (_sctrl.getNanSafe()) {
+                imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
+            } else {
+                imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
+            }
+
+            // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
+            if (medianOnly) {
+                _median = Value(percentile(*imgcp, 0.5), NaN);
+            } else {
+                MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
+                _median = Value(std::get<0>(mq), NaN);
+                _iqrange = std::get<2>(mq) - std::get<1>(mq);
+            }
         }
 
         if (flags & (MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
+            // Clip a sorted copy of the pixels, if we can
+            std::unique_ptr<IncrementalClipper<typename ImageT::Pixel> > clipper;
+            if (_sctrl.getIncrementalClip() && !_sctrl.getWeighted() &&
+                !_sctrl.getCalcErrorFromInputVariance()) {
+                if (!imgcp) {
+                    imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
+                }
+                clipper.reset(new IncrementalClipper<typename ImageT::Pixel>(*imgcp));
+            }
+
             for (int i_i = 0; i_i < _sctrl.getNumIter(); ++i_i) {
                 double const center = ((i_i > 0) ? _meanclip : _median).first;
                 double const hwidth = (i_i > 0 && _n > 1)
@@ -911,10 +1622,13 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
                                               : _sctrl.getNumSigmaClip() * IQ_TO_STDEV * _iqrange;
                 std::pair<double, double> const clipinfo(center, hwidth);
 
-                StandardReturn clipped = getStandard(
-                        img, msk, var, weights, flags, clipinfo, _weightsAreMultiplicative,
-                        _sctrl.getAndMask(), _sctrl.getCalcErrorFromInputVariance(), _sctrl.getNanSafe(),
-                        _sctrl.getWeighted(), _sctrl._maskPropagationThresholds);
+                StandardReturn clipped =
+                        clipper ? clipper->clip(clipinfo)
+                                : getStandard(img, msk, var, weights, flags, clipinfo,
+                                              _weightsAreMultiplicative, _sctrl.getAndMask(),
+                                              _sctrl.getCalcErrorFromInputVariance(), _sctrl.getNanSafe(),
+                                              _sctrl.getWeighted(), _sctrl._maskPropagationThresholds,
+                                              _sctrl.getNumThreads());
 
                 int const nClip = std::get<0>(clipped);             // number after clipping
                 _nClipped = _n - nClip;                             // number clipped
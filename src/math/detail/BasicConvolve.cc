@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdint>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 #include "lsst/pex/exceptions.h"
@@ -131,6 +132,165 @@ inline OutPixelT kernelDotProduct(
     }
     return outPixel;
 }
+
+// Number of x-convolved pixels to buffer when convolving with a separable kernel, chosen so that the
+// buffer stays in cache while it is dotted with the kernel y vector
+int const SEPARABLE_BUFFER_SIZE = 32768;
+int const SEPARABLE_MIN_BLOCK_WIDTH = 64;  // minimum number of columns to convolve at once
+
+/**
+ * @internal The nonzero elements of a separable kernel's x or y vector
+ *
+ * Zero elements are skipped (as in kernelDotProduct), so that non-finite pixels that they would multiply
+ * don't affect the result.
+ */
+struct KernelTaps {
+    KernelTaps(std::vector<lsst::afw::math::Kernel::Pixel> const& kernelVec, bool squared)
+            : length(kernelVec.size()) {
+        for (int i = 0; i < length; ++i) {
+            if (kernelVec[i] != 0) {
+                offsets.push_back(i);
+                weights.push_back(squared ? kernelVec[i] * kernelVec[i] : kernelVec[i]);
+            }
+        }
+    }
+
+    int length;                   ///< @internal length of the kernel vector
+    std::vector<int> offsets;     ///< @internal indices of the nonzero elements
+    std::vector<double> weights;  ///< @internal the nonzero elements (or their squares)
+};
+
+/**
+ * @internal Set out[x] to the sum over i of weights[i]*rows[i][x], for x in [0, width)
+ *
+ * The sum runs over whole rows one weight at a time, rather than one output pixel at a time, so that the
+ * inner loop is over contiguous pixels and can be vectorized.  The terms are accumulated in the same
+ * order and with the same type as kernelDotProduct.
+ */
+struct WeightedRowSum {
+    template <typename OutPixelT, typename InPixelT>
+    void operator()(OutPixelT* out, std::vector<InPixelT const*> const& rows,
+                    std::vector<double> const& weights, int width) const {
+        std::fill(out, out + width, OutPixelT(0));
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            InPixelT const* in = rows[i];
+            double const weight = weights[i];
+            for (int x = 0; x < width; ++x) {
+                out[x] += static_cast<OutPixelT>(in[x] * weight);
+            }
+        }
+    }
+};
+
+/**
+ * @internal Set out[x] to the bitwise OR over i of rows[i][x], for x in [0, width)
+ */
+struct OrRowSum {
+    template <typename PixelT>
+    void operator()(PixelT* out, std::vector<PixelT const*> const& rows, std::vector<double> const&,
+                    int width) const {
+        std::fill(out, out + width, PixelT(0));
+        for (auto in : rows) {
+            for (int x = 0; x < width; ++x) {
+                out[x] |= in[x];
+            }
+        }
+    }
+};
+
+/**
+ * @internal Convolve one image plane with a spatially invariant separable kernel
+ *
+ * The good region is processed in blocks of columns.  Within a block, each input row is convolved with
+ * the kernel x vector into a circular buffer of kernel-height rows; each output row is then a weighted sum
+ * of whole buffer rows, so neither pass needs to transpose the data or walk down columns.
+ */
+template <typename OutImageT, typename InImageT, typename RowSum>
+void convolvePlaneByRows(OutImageT& outImage, InImageT const& inImage, int ctrY,
+                         lsst::geom::Box2I const& goodBBox, KernelTaps const& xTaps, KernelTaps const& yTaps,
+                         RowSum const& rowSum) {
+    typedef typename OutImageT::Pixel OutPixel;
+    typedef typename InImageT::Pixel InPixel;
+
+    typename OutImageT::Array const outArray = outImage.getArray();
+    typename InImageT::ConstArray const inArray = inImage.getArray();
+    int const kHeight = yTaps.length;
+    int const goodWidth = goodBBox.getWidth();
+    int const blockWidth =
+            std::min(goodWidth, std::max(SEPARABLE_MIN_BLOCK_WIDTH, SEPARABLE_BUFFER_SIZE / kHeight));
+
+    std::vector<OutPixel> buffer(static_cast<std::size_t>(blockWidth) * kHeight);
+    std::vector<InPixel const*> inRows(xTaps.offsets.size());
+    std::vector<OutPixel const*> bufferRows(yTaps.offsets.size());
+    for (int x0 = 0; x0 < goodWidth; x0 += blockWidth) {
+        int const width = std::min(blockWidth, goodWidth - x0);
+        // x-convolve input row inY into the buffer; the convolution of column x0 starts at input column x0
+        auto convolveRow = [&](int inY) {
+            InPixel const* inRow = inArray[inY].getData() + x0;
+            for (std::size_t i = 0; i < inRows.size(); ++i) {
+                inRows[i] = inRow + xTaps.offsets[i];
+            }
+            rowSum(&buffer[(inY % kHeight) * blockWidth], inRows, xTaps.weights, width);
+        };
+
+        for (int inY = 0; inY < kHeight - 1; ++inY) {
+            convolveRow(inY);
+        }
+        for (int cnvY = goodBBox.getMinY(); cnvY <= goodBBox.getMaxY(); ++cnvY) {
+            int const inY0 = cnvY - ctrY;  // first input row under the kernel
+            convolveRow(inY0 + kHeight - 1);
+            for (std::size_t i = 0; i < bufferRows.size(); ++i) {
+                bufferRows[i] = &buffer[((inY0 + yTaps.offsets[i]) % kHeight) * blockWidth];
+            }
+            rowSum(outArray[cnvY].getData() + goodBBox.getMinX() + x0, bufferRows, yTaps.weights, width);
+        }
+    }
+}
+
+/**
+ * @internal Convolve with a spatially invariant separable kernel one image plane at a time
+ *
+ * @returns true if the convolution was done; false (doing nothing) if the pixel types aren't supported,
+ * in which case the caller must convolve one pixel at a time.
+ *
+ * Supported are Images and MaskedImages whose output pixels are floating point.
+ */
+template <typename OutImageT, typename InImageT>
+bool convolveSeparableByRows(OutImageT&, InImageT const&, int, lsst::geom::Box2I const&,
+                             std::vector<lsst::afw::math::Kernel::Pixel> const&,
+                             std::vector<lsst::afw::math::Kernel::Pixel> const&) {
+    return false;
+}
+
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<std::is_floating_point<OutPixelT>::value, bool>::type
+convolveSeparableByRows(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                        lsst::afw::image::Image<InPixelT> const& inImage, int ctrY,
+                        lsst::geom::Box2I const& goodBBox,
+                        std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                        std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec) {
+    convolvePlaneByRows(convolvedImage, inImage, ctrY, goodBBox, KernelTaps(kernelXVec, false),
+                        KernelTaps(kernelYVec, false), WeightedRowSum());
+    return true;
+}
+
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<std::is_floating_point<OutPixelT>::value, bool>::type
+convolveSeparableByRows(lsst::afw::image::MaskedImage<OutPixelT>& convolvedImage,
+                        lsst::afw::image::MaskedImage<InPixelT> const& inImage, int ctrY,
+                        lsst::geom::Box2I const& goodBBox,
+                        std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                        std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec) {
+    KernelTaps const xTaps(kernelXVec, false);
+    KernelTaps const yTaps(kernelYVec, false);
+    convolvePlaneByRows(*convolvedImage.getImage(), *inImage.getImage(), ctrY, goodBBox, xTaps, yTaps,
+                        WeightedRowSum());
+    convolvePlaneByRows(*convolvedImage.getVariance(), *inImage.getVariance(), ctrY, goodBBox,
+                        KernelTaps(kernelXVec, true), KernelTaps(kernelYVec, true), WeightedRowSum());
+    convolvePlaneByRows(*convolvedImage.getMask(), *inImage.getMask(), ctrY, goodBBox, xTaps, yTaps,
+                        OrRowSum());
+    return true;
+}
 }  // anonymous namespace
 
 namespace lsst {
@@ -165,7 +325,10 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Ker
         return;
     }
     // OK, use general (and slower) form
-    if (kernel.isSpatiallyVarying() && (convolutionControl.getMaxInterpolationDistance() > 1)) {
+    if (shouldConvolveWithFft(convolvedImage, inImage, kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve", "generic basicConvolve: using FFTs");
+        convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (kernel.isSpatiallyVarying() && (convolutionControl.getMaxInterpolationDistance() > 1)) {
         // use linear interpolation
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "generic basicConvolve: using linear interpolation");
@@ -210,11 +373,20 @@ template <typename OutImageT, typename InImageT>
 void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
                    math::LinearCombinationKernel const& kernel,
                    math::ConvolutionControl const& convolutionControl) {
-    if (!kernel.isSpatiallyVarying()) {
+    if (kernel.isSpatiallyVarying() &&
+        convolutionControl.getLinearCombinationAlgorithm() == math::ConvolutionControl::BASIS_IMAGES) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: convolving with each basis kernel");
+        return convolveWithBasis(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (shouldConvolveWithFft(convolvedImage, inImage, kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: using FFTs");
+        return convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (!kernel.isSpatiallyVarying()) {
         // use the standard algorithm for the spatially invariant case
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "basicConvolve for LinearCombinationKernel: spatially invariant; using brute force");
-        return convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl.getDoNormalize());
+        return convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl);
     } else {
         // refactor the kernel if this is reasonable and possible;
         // then use the standard algorithm for the spatially varying case
@@ -237,8 +409,7 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
             LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                        "basicConvolve for LinearCombinationKernel: maxInterpolationError < 0; using brute "
                        "force");
-            return convolveWithBruteForce(convolvedImage, inImage, *refKernelPtr,
-                                          convolutionControl.getDoNormalize());
+            return convolveWithBruteForce(convolvedImage, inImage, *refKernelPtr, convolutionControl);
         }
     }
 }
@@ -257,6 +428,15 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
 
     assertDimensionsOK(convolvedImage, inImage, kernel);
 
+    if (convolutionControl.getNumThreads() != 1) {
+        return convolveInBands(convolvedImage, inImage, kernel, convolutionControl,
+                               [](OutImageT& outBand, InImageT const& inBand,
+                                  math::SeparableKernel const& bandKernel,
+                                  math::ConvolutionControl const& bandControl) {
+                                   basicConvolve(outBand, inBand, bandKernel, bandControl);
+                               });
+    }
+
     lsst::geom::Box2I const fullBBox = inImage.getBBox(image::LOCAL);
     lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(fullBBox);
 
@@ -300,6 +480,10 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
                    "SeparableKernel basicConvolve: kernel is spatially invariant");
 
         kernel.computeVectors(kernelXVec, kernelYVec, convolutionControl.getDoNormalize());
+        if (convolveSeparableByRows(convolvedImage, inImage, kernel.getCtrY(), goodBBox, kernelXVec,
+                                    kernelYVec)) {
+            return;
+        }
         KernelIterator const kernelXVecBegin = kernelXVec.begin();
         KernelIterator const kernelYVecBegin = kernelYVec.begin();
 
@@ -369,6 +553,14 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
 
     assertDimensionsOK(convolvedImage, inImage, kernel);
 
+    if (convolutionControl.getNumThreads() != 1) {
+        return convolveInBands(convolvedImage, inImage, kernel, convolutionControl,
+                               [](OutImageT& outBand, InImageT const& inBand, math::Kernel const& bandKernel,
+                                  math::ConvolutionControl const& bandControl) {
+                                   convolveWithBruteForce(outBand, inBand, bandKernel, bandControl);
+                               });
+    }
+
     int const inImageWidth = inImage.getWidth();
     int const inImageHeight = inImage.getHeight();
     int const kWidth = kernel.getWidth();
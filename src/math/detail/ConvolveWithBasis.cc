@@ -0,0 +1,356 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/*
+ * Definition of convolveWithBasis declared in detail/Convolve.h
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/log/Log.h"
+#include "lsst/geom.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+namespace {
+
+int const MAX_BAND_HEIGHT = 256;  // maximum number of output rows to convolve at once
+
+/*
+ * The kernels to convolve with: the basis kernels, and the products of pairs of basis kernels (for
+ * the variance).  Each thread needs its own copy, as evaluating Functions isn't thread safe.
+ */
+struct BasisKernels {
+    struct CrossTerm {
+        int i, j;                               // indices of the basis kernels
+        std::shared_ptr<math::Kernel> product;  // kernel whose image is the product of their images
+    };
+
+    explicit BasisKernels(math::LinearCombinationKernel const &lcKernel)
+            : kernel(std::dynamic_pointer_cast<math::LinearCombinationKernel>(lcKernel.clone())),
+              sums(lcKernel.getKernelSumList()) {
+        lsst::geom::Point2I const ctr = lcKernel.getCtr();
+        std::vector<std::shared_ptr<image::Image<math::Kernel::Pixel>>> images;
+        for (auto const &basisKernel : kernel->getKernelList()) {
+            if (basisKernel->isSpatiallyVarying()) {
+                throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                                  "Cannot convolve with each basis kernel; one is spatially varying");
+            }
+            auto basisImage = std::make_shared<image::Image<math::Kernel::Pixel>>(lcKernel.getDimensions());
+            (void)basisKernel->computeImage(*basisImage, false);
+            images.push_back(basisImage);
+            if (basisKernel->getCtr() == ctr) {
+                basis.push_back(basisKernel);
+            } else {  // the basis images are combined about the centre of the LinearCombinationKernel
+                basis.push_back(std::make_shared<math::FixedKernel>(*basisImage));
+                basis.back()->setCtr(ctr);
+            }
+        }
+
+        int const nBasis = basis.size();
+        for (int i = 0; i < nBasis; ++i) {
+            for (int j = i + 1; j < nBasis; ++j) {
+                image::Image<math::Kernel::Pixel> product(*images[i], true);
+                product *= *images[j];
+                bool isZero = true;
+                for (int y = 0; y < product.getHeight() && isZero; ++y) {
+                    isZero = std::all_of(product.row_begin(y), product.row_end(y),
+                                         [](math::Kernel::Pixel value) { return value == 0; });
+                }
+                if (!isZero) {
+                    auto productKernel = std::make_shared<math::FixedKernel>(product);
+                    productKernel->setCtr(ctr);
+                    crossTerms.push_back(CrossTerm{i, j, productKernel});
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<math::LinearCombinationKernel> kernel;  // for the spatial model
+    std::vector<double> sums;                               // sums of the basis kernel images
+    std::vector<std::shared_ptr<math::Kernel>> basis;
+    std::vector<CrossTerm> crossTerms;
+};
+
+/*
+ * The type of image to hold the convolution with one basis kernel; double, so that
+ * integer outputs aren't rounded before the convolutions are summed
+ */
+template <typename ImageT>
+struct DoubleImage;
+
+template <typename PixelT>
+struct DoubleImage<image::Image<PixelT>> {
+    using type = image::Image<double>;
+};
+
+template <typename PixelT>
+struct DoubleImage<image::MaskedImage<PixelT>> {
+    using type = image::MaskedImage<double>;
+};
+
+/*
+ * Weighted sums of the convolutions with each basis kernel, for a band of output pixels
+ */
+struct BandSums {
+    explicit BandSums(int nPixel) : image(nPixel, 0.0), variance(nPixel, 0.0), mask(nPixel, 0) {}
+
+    std::vector<double> image;
+    std::vector<double> variance;
+    std::vector<image::MaskPixel> mask;
+};
+
+/*
+ * Add weights[k]*(pixel k of box in convolved) to sums, for an Image or a MaskedImage
+ */
+template <typename PixelT>
+void addBasis(BandSums &sums, image::Image<PixelT> const &convolved, std::vector<double> const &weights,
+              lsst::geom::Box2I const &box) {
+    int k = 0;
+    for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+        auto ptr = convolved.x_at(box.getMinX(), y);
+        for (int x = 0; x < box.getWidth(); ++x, ++k, ++ptr) {
+            sums.image[k] += weights[k] * (*ptr);
+        }
+    }
+}
+
+template <typename PixelT>
+void addBasis(BandSums &sums, image::MaskedImage<PixelT> const &convolved, std::vector<double> const &weights,
+              lsst::geom::Box2I const &box) {
+    int k = 0;
+    for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+        auto ptr = convolved.x_at(box.getMinX(), y);
+        for (int x = 0; x < box.getWidth(); ++x, ++k, ++ptr) {
+            double const weight = weights[k];
+            sums.image[k] += weight * ptr.image();
+            sums.variance[k] += weight * weight * ptr.variance();
+            if (weight != 0) {
+                sums.mask[k] |= ptr.mask();
+            }
+        }
+    }
+}
+
+/*
+ * Add the cross terms of the variance to sums; there are none for an Image
+ */
+template <typename OutPixelT, typename InPixelT>
+void addCrossVariance(BandSums &, image::Image<OutPixelT> const &, image::Image<InPixelT> const &,
+                      BasisKernels const &, std::vector<std::vector<double>> const &,
+                      lsst::geom::Box2I const &, math::ConvolutionControl const &) {}
+
+template <typename OutPixelT, typename InPixelT>
+void addCrossVariance(BandSums &sums, image::MaskedImage<OutPixelT> const &,
+                      image::MaskedImage<InPixelT> const &inImage, BasisKernels const &basisKernels,
+                      std::vector<std::vector<double>> const &weights, lsst::geom::Box2I const &box,
+                      math::ConvolutionControl const &basisControl) {
+    image::Image<double> convolved(inImage.getDimensions());
+    for (auto const &term : basisKernels.crossTerms) {
+        basicConvolve(convolved, *inImage.getVariance(), *term.product, basisControl);
+        std::vector<double> const &weightsI = weights[term.i];
+        std::vector<double> const &weightsJ = weights[term.j];
+        int k = 0;
+        for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+            auto ptr = convolved.x_at(box.getMinX(), y);
+            for (int x = 0; x < box.getWidth(); ++x, ++k, ++ptr) {
+                sums.variance[k] += 2.0 * weightsI[k] * weightsJ[k] * (*ptr);
+            }
+        }
+    }
+}
+
+/*
+ * Set the pixels of box in out to the normalised sums
+ */
+template <typename PixelT>
+void setBand(image::Image<PixelT> &out, BandSums const &sums, std::vector<double> const &norms,
+             lsst::geom::Box2I const &box) {
+    int k = 0;
+    for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+        auto ptr = out.x_at(box.getMinX(), y);
+        for (int x = 0; x < box.getWidth(); ++x, ++k, ++ptr) {
+            *ptr = static_cast<PixelT>(sums.image[k] / norms[k]);
+        }
+    }
+}
+
+template <typename PixelT>
+void setBand(image::MaskedImage<PixelT> &out, BandSums const &sums, std::vector<double> const &norms,
+             lsst::geom::Box2I const &box) {
+    int k = 0;
+    for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+        auto ptr = out.x_at(box.getMinX(), y);
+        for (int x = 0; x < box.getWidth(); ++x, ++k, ++ptr) {
+            ptr.image() = static_cast<PixelT>(sums.image[k] / norms[k]);
+            ptr.mask() = sums.mask[k];
+            ptr.variance() = static_cast<image::VariancePixel>(sums.variance[k] / (norms[k] * norms[k]));
+        }
+    }
+}
+
+/*
+ * Convolve the pixels of convolvedImage in bandBBox
+ */
+template <typename OutImageT, typename InImageT>
+void convolveBandWithBasis(OutImageT &convolvedImage, InImageT const &inImage,
+                           BasisKernels const &basisKernels, math::ConvolutionControl const &basisControl,
+                           bool doNormalize, lsst::geom::Box2I const &bandBBox) {
+    math::LinearCombinationKernel const &kernel = *basisKernels.kernel;
+    int const nBasis = basisKernels.basis.size();
+    int const nPixel = bandBBox.getArea();
+
+    // the input pixels needed for this band, and the band's pixels in the convolution of those pixels
+    lsst::geom::Box2I const inBBox(lsst::geom::Point2I(0, bandBBox.getMinY() - kernel.getCtrY()),
+                                   lsst::geom::Extent2I(inImage.getWidth(),
+                                                        bandBBox.getHeight() + kernel.getHeight() - 1));
+    InImageT const inBand(inImage, inBBox, image::LOCAL);
+    lsst::geom::Box2I const box(lsst::geom::Point2I(bandBBox.getMinX(), kernel.getCtrY()),
+                                bandBBox.getDimensions());
+
+    std::vector<std::vector<double>> weights(nBasis, std::vector<double>(nPixel));
+    std::vector<double> norms(nPixel, 1.0);
+    std::vector<double> params(nBasis);
+    int k = 0;
+    for (int y = bandBBox.getMinY(); y <= bandBBox.getMaxY(); ++y) {
+        double const rowPos = inImage.indexToPosition(y, image::Y);
+        for (int x = bandBBox.getMinX(); x <= bandBBox.getMaxX(); ++x, ++k) {
+            double const colPos = inImage.indexToPosition(x, image::X);
+            kernel.computeKernelParametersFromSpatialModel(params, colPos, rowPos);
+            double norm = 0.0;
+            for (int i = 0; i < nBasis; ++i) {
+                weights[i][k] = params[i];
+                norm += params[i] * basisKernels.sums[i];
+            }
+            if (doNormalize) {
+                if (norm == 0) {
+                    throw LSST_EXCEPT(pexExcept::OverflowError, "Cannot normalize; kernel sum is 0");
+                }
+                norms[k] = norm;
+            }
+        }
+    }
+
+    BandSums sums(nPixel);
+    typename DoubleImage<OutImageT>::type convolved(inBand.getDimensions());
+    for (int i = 0; i < nBasis; ++i) {
+        basicConvolve(convolved, inBand, *basisKernels.basis[i], basisControl);
+        addBasis(sums, convolved, weights[i], box);
+    }
+    addCrossVariance(sums, convolved, inBand, basisKernels, weights, box, basisControl);
+
+    setBand(convolvedImage, sums, norms, bandBBox);
+}
+
+}  // namespace
+
+template <typename OutImageT, typename InImageT>
+void convolveWithBasis(OutImageT &convolvedImage, InImageT const &inImage,
+                       math::LinearCombinationKernel const &kernel,
+                       math::ConvolutionControl const &convolutionControl) {
+    if (convolvedImage.getDimensions() != inImage.getDimensions()) {
+        std::ostringstream os;
+        os << "convolvedImage dimensions = ( " << convolvedImage.getWidth() << ", "
+           << convolvedImage.getHeight() << ") != (" << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") = inImage dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (inImage.getWidth() < kernel.getWidth() || inImage.getHeight() < kernel.getHeight()) {
+        std::ostringstream os;
+        os << "inImage dimensions = ( " << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") smaller than (" << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") = kernel dimensions in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+
+    lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(convolvedImage.getBBox(image::LOCAL));
+    int const goodHeight = goodBBox.getHeight();
+
+    // the basis kernels are convolved one at a time, without normalisation
+    math::ConvolutionControl basisControl(convolutionControl);
+    basisControl.setDoNormalize(false);
+    basisControl.setNumThreads(1);
+
+    int const nThreads = resolveNumThreads(convolutionControl.getNumThreads());
+    int const nBand =
+            std::min(goodHeight, std::max(nThreads, (goodHeight + MAX_BAND_HEIGHT - 1) / MAX_BAND_HEIGHT));
+    LOGL_DEBUG("TRACE2.afw.math.convolve.convolveWithBasis",
+               "convolveWithBasis: %d basis kernels; %d bands of rows; %d threads", kernel.getNBasisKernels(),
+               nBand, nThreads);
+
+    parallelForChunks(0, nBand, nThreads, [&](int band0, int band1, int) {
+        BasisKernels const basisKernels(kernel);
+        for (int band = band0; band < band1; ++band) {
+            int const y0 = goodBBox.getMinY() + static_cast<long>(goodHeight) * band / nBand;
+            int const y1 = goodBBox.getMinY() + static_cast<long>(goodHeight) * (band + 1) / nBand;
+            lsst::geom::Box2I const bandBBox(lsst::geom::Point2I(goodBBox.getMinX(), y0),
+                                             lsst::geom::Extent2I(goodBBox.getWidth(), y1 - y0));
+            convolveBandWithBasis(convolvedImage, inImage, basisKernels, basisControl,
+                                  convolutionControl.getDoNormalize(), bandBBox);
+        }
+    });
+}
+
+/*
+ * Explicit instantiation
+ */
+/// @cond
+#define IMAGE(PIXTYPE) image::Image<PIXTYPE>
+#define MASKEDIMAGE(PIXTYPE) image::MaskedImage<PIXTYPE, image::MaskPixel, image::VariancePixel>
+#define NL /* */
+// Instantiate Image or MaskedImage versions
+#define INSTANTIATE_IM_OR_MI(IMGMACRO, OUTPIXTYPE, INPIXTYPE)                         \
+    template void convolveWithBasis(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &, \
+                                    math::LinearCombinationKernel const &, math::ConvolutionControl const &);
+// Instantiate both Image and MaskedImage versions
+#define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)             \
+    INSTANTIATE_IM_OR_MI(IMAGE, OUTPIXTYPE, INPIXTYPE) \
+    INSTANTIATE_IM_OR_MI(MASKEDIMAGE, OUTPIXTYPE, INPIXTYPE)
+
+INSTANTIATE(double, double)
+INSTANTIATE(double, float)
+INSTANTIATE(double, int)
+INSTANTIATE(double, std::uint16_t)
+INSTANTIATE(float, float)
+INSTANTIATE(float, int)
+INSTANTIATE(float, std::uint16_t)
+INSTANTIATE(int, int)
+INSTANTIATE(std::uint16_t, std::uint16_t)
+/// @endcond
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
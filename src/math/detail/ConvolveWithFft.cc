@@ -0,0 +1,635 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/*
+ * Definition of convolveWithFft and shouldConvolveWithFft declared in detail/Convolve.h
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fftw3.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/log/Log.h"
+#include "lsst/geom.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/Convolve.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+namespace {
+
+typedef math::Kernel::Pixel KernelPixel;
+typedef std::vector<double> KernelArray;  // a kernel image, stored by rows
+typedef std::vector<std::complex<double>> Spectrum;
+/*
+ * Compute weights for the results of convolving a tile with each of a set of kernels:
+ * weights[(i*height + y)*width + x] is the weight of kernel i at pixel (x0 + x, y0 + y) of the good
+ * region of the output.  An empty function means that there is a single kernel with unit weight
+ */
+typedef std::function<void(int x0, int y0, int width, int height, std::vector<double> &weights)>
+        WeightFunction;
+
+int const MIN_FFT_LENGTH = 256;         // smallest FFT length to use for images larger than this
+int const FFT_COST_PER_TRANSFORM = 32;  // cost per pixel of one more inverse FFT, in multiply-adds
+
+std::mutex fftwPlannerMutex;  // FFTW's planner isn't thread safe
+
+/*
+ * Return the smallest integer >= n whose only prime factors are 2, 3, 5 and 7, for which FFTs are fast
+ */
+int nextFastLength(int n) {
+    for (int m = std::max(n, 1);; ++m) {
+        int r = m;
+        for (int p : {2, 3, 5, 7}) {
+            while (r % p == 0) {
+                r /= p;
+            }
+        }
+        if (r == 1) {
+            return m;
+        }
+    }
+}
+
+/*
+ * Return the FFT length to use along one axis: long enough that the wrap-around of the kernel doesn't
+ * waste most of each tile, but no longer than needed to cover the whole image
+ */
+int fftLength(int kSize, int imageSize) {
+    return nextFastLength(std::min(imageSize, std::max(4 * kSize, MIN_FFT_LENGTH)));
+}
+
+/*
+ * Convolve image planes tile by tile using FFTs of a single size
+ *
+ * Each tile of the good region of the output, and the input pixels that it depends on, fits in one FFT;
+ * the input is zero-padded and the part of the result contaminated by wrap-around is discarded
+ * (the "overlap-save" method).
+ */
+class FftTiler final {
+public:
+    FftTiler(lsst::geom::Extent2I const &inDimensions, lsst::geom::Extent2I const &kDimensions)
+            : _kWidth(kDimensions.getX()),
+              _kHeight(kDimensions.getY()),
+              _cnvWidth(inDimensions.getX() + 1 - _kWidth),
+              _cnvHeight(inDimensions.getY() + 1 - _kHeight),
+              _nx(fftLength(_kWidth, inDimensions.getX())),
+              _ny(fftLength(_kHeight, inDimensions.getY())),
+              _nSpectrum(_ny * (_nx / 2 + 1)),
+              _tileWidth(_nx + 1 - _kWidth),
+              _tileHeight(_ny + 1 - _kHeight),
+              _real(fftw_alloc_real(_nx * _ny)),
+              _result(fftw_alloc_real(_nx * _ny)),
+              _spectrum(fftw_alloc_complex(_nSpectrum)),
+              _product(fftw_alloc_complex(_nSpectrum)) {
+        if (!_real || !_result || !_spectrum || !_product) {
+            _free();
+            throw std::bad_alloc();
+        }
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+        _forward = fftw_plan_dft_r2c_2d(_ny, _nx, _real, _spectrum, FFTW_ESTIMATE);
+        _backward = fftw_plan_dft_c2r_2d(_ny, _nx, _product, _result, FFTW_ESTIMATE);
+    }
+
+    FftTiler(FftTiler const &) = delete;
+    FftTiler &operator=(FftTiler const &) = delete;
+
+    ~FftTiler() {
+        {
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+            fftw_destroy_plan(_forward);
+            fftw_destroy_plan(_backward);
+        }
+        _free();
+    }
+
+    /*
+     * Return the transform of a kernel, scaled so that inverse transforms are normalised
+     *
+     * The kernel is reflected through the origin, as the convolution in BasicConvolve.cc,
+     * out(x + ctrX, y + ctrY) = sum(in(x + i, y + j)*kernel(i, j)), is a cross-correlation.
+     */
+    Spectrum transform(KernelArray const &kernel) {
+        std::fill(_real, _real + _nx * _ny, 0.0);
+        for (int j = 0; j < _kHeight; ++j) {
+            for (int i = 0; i < _kWidth; ++i) {
+                _real[((_ny - j) % _ny) * _nx + (_nx - i) % _nx] = kernel[j * _kWidth + i];
+            }
+        }
+        fftw_execute(_forward);
+
+        double const scale = 1.0 / (static_cast<double>(_nx) * _ny);
+        Spectrum spectrum(_nSpectrum);
+        for (int i = 0; i < _nSpectrum; ++i) {
+            spectrum[i] = std::complex<double>(_spectrum[i][0], _spectrum[i][1]) * scale;
+        }
+        return spectrum;
+    }
+
+    /*
+     * Set the good region of out to the weighted sum of the convolutions of in with each kernel
+     *
+     * @param[out] out  Output image plane; the border isn't touched
+     * @param[in] in  Input image plane
+     * @param[in] spectra  Transforms of the kernels, from transform()
+     * @param[in] ctr  Centre of the kernels
+     * @param[in] computeWeights  Weights of the kernels at each pixel; if empty, spectra must have a single
+     *                            element
+     */
+    template <typename OutPixelT, typename InPixelT>
+    void convolve(image::Image<OutPixelT> &out, image::Image<InPixelT> const &in,
+                  std::vector<Spectrum> const &spectra, lsst::geom::Point2I const &ctr,
+                  WeightFunction const &computeWeights) {
+        int const nKernel = spectra.size();
+        assert(computeWeights || nKernel == 1);
+        std::vector<double> weights;
+        std::vector<double> sum(computeWeights ? _tileWidth * _tileHeight : 0);
+
+        for (int y0 = 0; y0 < _cnvHeight; y0 += _tileHeight) {
+            int const height = std::min(_tileHeight, _cnvHeight - y0);
+            for (int x0 = 0; x0 < _cnvWidth; x0 += _tileWidth) {
+                int const width = std::min(_tileWidth, _cnvWidth - x0);
+                // load the input pixels that this tile depends on, padding with zeros
+                std::fill(_real, _real + _nx * _ny, 0.0);
+                for (int y = 0; y < height + _kHeight - 1; ++y) {
+                    std::copy_n(in.x_at(x0, y0 + y), width + _kWidth - 1, _real + y * _nx);
+                }
+                fftw_execute(_forward);
+
+                if (computeWeights) {
+                    computeWeights(x0, y0, width, height, weights);
+                    std::fill(sum.begin(), sum.end(), 0.0);
+                }
+                for (int i = 0; i < nKernel; ++i) {
+                    Spectrum const &kernelSpectrum = spectra[i];
+                    for (int j = 0; j < _nSpectrum; ++j) {
+                        std::complex<double> const product =
+                                std::complex<double>(_spectrum[j][0], _spectrum[j][1]) * kernelSpectrum[j];
+                        _product[j][0] = product.real();
+                        _product[j][1] = product.imag();
+                    }
+                    fftw_execute(_backward);
+
+                    if (!computeWeights) {
+                        for (int y = 0; y < height; ++y) {
+                            double const *resultPtr = _result + y * _nx;
+                            typename image::Image<OutPixelT>::x_iterator outPtr =
+                                    out.x_at(x0 + ctr.getX(), y0 + y + ctr.getY());
+                            for (int x = 0; x < width; ++x, ++outPtr, ++resultPtr) {
+                                *outPtr = static_cast<OutPixelT>(*resultPtr);
+                            }
+                        }
+                    } else {
+                        double const *weightPtr = &weights[i * width * height];
+                        for (int y = 0; y < height; ++y) {
+                            double const *resultPtr = _result + y * _nx;
+                            double *sumPtr = &sum[y * width];
+                            for (int x = 0; x < width; ++x) {
+                                sumPtr[x] += (*weightPtr++) * resultPtr[x];
+                            }
+                        }
+                    }
+                }
+                if (computeWeights) {
+                    for (int y = 0; y < height; ++y) {
+                        std::copy_n(&sum[y * width], width, out.x_at(x0 + ctr.getX(), y0 + y + ctr.getY()));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    void _free() {
+        fftw_free(_real);
+        fftw_free(_result);
+        fftw_free(_spectrum);
+        fftw_free(_product);
+    }
+
+    int const _kWidth, _kHeight;
+    int const _cnvWidth, _cnvHeight;  // size of the good region of the output
+    int const _nx, _ny;               // dimensions of the FFTs
+    int const _nSpectrum;             // number of complex elements in a transform
+    int const _tileWidth, _tileHeight;
+    double *_real;             // input of the forward transform
+    double *_result;           // output of the backward transform
+    fftw_complex *_spectrum;   // output of the forward transform
+    fftw_complex *_product;    // input of the backward transform (overwritten by FFTW)
+    fftw_plan _forward;
+    fftw_plan _backward;
+};
+
+/*
+ * The kernel images, and the weights to use for each, needed to convolve with a Kernel using FFTs
+ *
+ * For a spatially invariant kernel there is one kernel image (and its square, for the variance); for
+ * a spatially varying LinearCombinationKernel there's one image for each basis kernel (and one for each
+ * product of a pair of basis kernels, for the variance).
+ */
+class FftKernel final {
+public:
+    FftKernel(math::Kernel const &kernel, bool doNormalize, lsst::geom::Point2I const &xy0)
+            : _kernel(kernel),
+              _doNormalize(doNormalize),
+              _xy0(xy0),
+              _basisKernel(nullptr),
+              _footprint(kernel.getWidth() * kernel.getHeight(), false) {
+        image::Image<KernelPixel> kernelImage(kernel.getDimensions());
+        if (!kernel.isSpatiallyVarying()) {
+            (void)kernel.computeImage(kernelImage, doNormalize);
+            _images.push_back(_toArray(kernelImage));
+        } else {
+            _basisKernel = dynamic_cast<math::LinearCombinationKernel const *>(&kernel);
+            if (!_basisKernel) {
+                throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                                  "A spatially varying kernel must be a LinearCombinationKernel to use FFTs");
+            }
+            for (auto const &basis : _basisKernel->getKernelList()) {
+                _sums.push_back(basis->computeImage(kernelImage, false));
+                _images.push_back(_toArray(kernelImage));
+            }
+        }
+
+        int const nImage = _images.size();
+        for (int i = 0; i < nImage; ++i) {
+            for (int j = i; j < nImage; ++j) {
+                KernelArray product(_images[i].size());
+                std::transform(_images[i].begin(), _images[i].end(), _images[j].begin(), product.begin(),
+                               std::multiplies<double>());
+                _varianceImages.push_back(product);
+            }
+            for (std::size_t k = 0; k < _footprint.size(); ++k) {
+                _footprint[k] = _footprint[k] || (_images[i][k] != 0);
+            }
+        }
+    }
+
+    /// Kernel images to convolve the image plane with
+    std::vector<KernelArray> const &getImages() const { return _images; }
+
+    /// Kernel images to convolve the variance plane with
+    std::vector<KernelArray> const &getVarianceImages() const { return _varianceImages; }
+
+    /// Which kernel pixels are nonzero (and thus smear the mask), stored by rows
+    std::vector<bool> const &getFootprint() const { return _footprint; }
+
+    /// Return a function computing the weights of getImages() (or getVarianceImages()) at each pixel
+    WeightFunction getWeightFunction(bool forVariance) const {
+        if (!_basisKernel) {
+            return WeightFunction();
+        }
+        return [this, forVariance](int x0, int y0, int width, int height, std::vector<double> &weights) {
+            _computeWeights(x0, y0, width, height, forVariance, weights);
+        };
+    }
+
+private:
+    KernelArray _toArray(image::Image<KernelPixel> const &kernelImage) const {
+        KernelArray array;
+        array.reserve(kernelImage.getWidth() * kernelImage.getHeight());
+        for (int y = 0; y < kernelImage.getHeight(); ++y) {
+            array.insert(array.end(), kernelImage.row_begin(y), kernelImage.row_end(y));
+        }
+        return array;
+    }
+
+    void _computeWeights(int x0, int y0, int width, int height, bool forVariance,
+                         std::vector<double> &weights) const {
+        int const nBasis = _images.size();
+        int const nWeight = forVariance ? _varianceImages.size() : nBasis;
+        int const nPixel = width * height;
+        weights.resize(nWeight * nPixel);
+        std::vector<double> params(nBasis);
+        for (int y = 0; y < height; ++y) {
+            double const rowPos = _xy0.getY() + y0 + y + _kernel.getCtrY();
+            for (int x = 0; x < width; ++x) {
+                double const colPos = _xy0.getX() + x0 + x + _kernel.getCtrX();
+                _kernel.computeKernelParametersFromSpatialModel(params, colPos, rowPos);
+                double norm = 1.0;
+                if (_doNormalize) {
+                    norm = 0.0;
+                    for (int i = 0; i < nBasis; ++i) {
+                        norm += params[i] * _sums[i];
+                    }
+                    if (norm == 0) {
+                        throw LSST_EXCEPT(pexExcept::OverflowError, "Cannot normalize; kernel sum is 0");
+                    }
+                }
+                double *weightPtr = &weights[y * width + x];
+                if (!forVariance) {
+                    for (int i = 0; i < nBasis; ++i, weightPtr += nPixel) {
+                        *weightPtr = params[i] / norm;
+                    }
+                } else {
+                    for (int i = 0; i < nBasis; ++i) {
+                        for (int j = i; j < nBasis; ++j, weightPtr += nPixel) {
+                            *weightPtr = (i == j ? 1.0 : 2.0) * params[i] * params[j] / (norm * norm);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    math::Kernel const &_kernel;
+    bool const _doNormalize;
+    lsst::geom::Point2I const _xy0;
+    math::LinearCombinationKernel const *_basisKernel;  // null if the kernel is spatially invariant
+    std::vector<KernelArray> _images;
+    std::vector<double> _sums;  // sums of the basis kernel images
+    std::vector<KernelArray> _varianceImages;
+    std::vector<bool> _footprint;
+};
+
+/*
+ * Set pixels out[x] to the OR of in[x], ..., in[x + width - 1] for x = 0, ..., n - width
+ *
+ * This is the van Herk/Gil-Werman algorithm, which needs three ORs per pixel whatever the width.
+ */
+void windowedOr(image::MaskPixel const *in, int n, int width, image::MaskPixel *out,
+                std::vector<image::MaskPixel> &prefix, std::vector<image::MaskPixel> &suffix) {
+    prefix.resize(n);
+    suffix.resize(n);
+    for (int x = 0; x < n; ++x) {
+        prefix[x] = (x % width == 0) ? in[x] : (prefix[x - 1] | in[x]);
+    }
+    for (int x = n - 1; x >= 0; --x) {
+        suffix[x] = (x % width == width - 1 || x == n - 1) ? in[x] : (in[x] | suffix[x + 1]);
+    }
+    for (int x = 0; x <= n - width; ++x) {
+        out[x] = suffix[x] | prefix[x + width - 1];
+    }
+}
+
+/*
+ * Set the good region of outMask to the OR of the inMask pixels under the footprint of the kernel
+ *
+ * Each row of the footprint is split into runs of nonzero pixels, and the OR over a run is computed
+ * for all positions at once using windowedOr, so the cost doesn't grow as the square of the kernel size.
+ */
+void smearMask(image::Mask<image::MaskPixel> &outMask, image::Mask<image::MaskPixel> const &inMask,
+               std::vector<bool> const &footprint, lsst::geom::Extent2I const &kDimensions,
+               lsst::geom::Point2I const &ctr) {
+    int const kWidth = kDimensions.getX();
+    int const kHeight = kDimensions.getY();
+    int const inWidth = inMask.getWidth();
+    int const inHeight = inMask.getHeight();
+    int const cnvWidth = inWidth + 1 - kWidth;
+    int const cnvHeight = inHeight + 1 - kHeight;
+
+    std::map<int, std::vector<std::pair<int, int>>> runsByWidth;  // width: [(row, start)]
+    for (int j = 0; j < kHeight; ++j) {
+        for (int i = 0; i < kWidth;) {
+            if (!footprint[j * kWidth + i]) {
+                ++i;
+                continue;
+            }
+            int const start = i;
+            while (i < kWidth && footprint[j * kWidth + i]) {
+                ++i;
+            }
+            runsByWidth[i - start].emplace_back(j, start);
+        }
+    }
+
+    std::vector<image::MaskPixel> smeared(cnvWidth * cnvHeight, 0);
+    std::vector<image::MaskPixel> windowed(inWidth * inHeight);
+    std::vector<image::MaskPixel> row(inWidth), prefix, suffix;
+    for (auto const &widthRuns : runsByWidth) {
+        int const width = widthRuns.first;
+        for (int y = 0; y < inHeight; ++y) {
+            std::copy(inMask.row_begin(y), inMask.row_end(y), row.begin());
+            windowedOr(row.data(), inWidth, width, &windowed[y * inWidth], prefix, suffix);
+        }
+        for (auto const &run : widthRuns.second) {
+            for (int y = 0; y < cnvHeight; ++y) {
+                image::MaskPixel const *windowedPtr = &windowed[(y + run.first) * inWidth + run.second];
+                image::MaskPixel *smearedPtr = &smeared[y * cnvWidth];
+                for (int x = 0; x < cnvWidth; ++x) {
+                    smearedPtr[x] |= windowedPtr[x];
+                }
+            }
+        }
+    }
+
+    for (int y = 0; y < cnvHeight; ++y) {
+        std::copy_n(&smeared[y * cnvWidth], cnvWidth, outMask.x_at(ctr.getX(), y + ctr.getY()));
+    }
+}
+
+std::vector<Spectrum> transformAll(FftTiler &tiler, std::vector<KernelArray> const &kernels) {
+    std::vector<Spectrum> spectra;
+    spectra.reserve(kernels.size());
+    for (auto const &kernel : kernels) {
+        spectra.push_back(tiler.transform(kernel));
+    }
+    return spectra;
+}
+
+template <typename OutPixelT, typename InPixelT>
+void convolvePlanesWithFft(image::Image<OutPixelT> &convolvedImage, image::Image<InPixelT> const &inImage,
+                           FftKernel const &fftKernel, math::Kernel const &kernel) {
+    FftTiler tiler(inImage.getDimensions(), kernel.getDimensions());
+    tiler.convolve(convolvedImage, inImage, transformAll(tiler, fftKernel.getImages()), kernel.getCtr(),
+                   fftKernel.getWeightFunction(false));
+}
+
+template <typename OutPixelT, typename InPixelT>
+void convolvePlanesWithFft(image::MaskedImage<OutPixelT> &convolvedImage,
+                           image::MaskedImage<InPixelT> const &inImage, FftKernel const &fftKernel,
+                           math::Kernel const &kernel) {
+    FftTiler tiler(inImage.getDimensions(), kernel.getDimensions());
+    tiler.convolve(*convolvedImage.getImage(), *inImage.getImage(),
+                   transformAll(tiler, fftKernel.getImages()), kernel.getCtr(),
+                   fftKernel.getWeightFunction(false));
+    tiler.convolve(*convolvedImage.getVariance(), *inImage.getVariance(),
+                   transformAll(tiler, fftKernel.getVarianceImages()), kernel.getCtr(),
+                   fftKernel.getWeightFunction(true));
+    smearMask(*convolvedImage.getMask(), *inImage.getMask(), fftKernel.getFootprint(), kernel.getDimensions(),
+              kernel.getCtr());
+}
+
+/*
+ * Traits of Images and MaskedImages needed to decide whether to use FFTs
+ */
+template <typename PixelT>
+bool isFloatingPoint(image::Image<PixelT> const &) {
+    return std::is_floating_point<PixelT>::value;
+}
+
+template <typename PixelT>
+bool isFloatingPoint(image::MaskedImage<PixelT> const &) {
+    return std::is_floating_point<PixelT>::value;
+}
+
+template <typename PixelT>
+bool allFinite(image::Image<PixelT> const &img) {
+    for (int y = 0; y < img.getHeight(); ++y) {
+        for (auto ptr = img.row_begin(y), end = img.row_end(y); ptr != end; ++ptr) {
+            if (!std::isfinite(static_cast<double>(*ptr))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename PixelT>
+bool allFinite(image::MaskedImage<PixelT> const &mimg) {
+    return allFinite(*mimg.getImage()) && allFinite(*mimg.getVariance());
+}
+
+template <typename PixelT>
+int getNPlanes(image::Image<PixelT> const &) {
+    return 1;
+}
+
+template <typename PixelT>
+int getNPlanes(image::MaskedImage<PixelT> const &) {
+    return 2;  // the mask isn't convolved using FFTs
+}
+
+}  // namespace
+
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT &convolvedImage, InImageT const &inImage, math::Kernel const &kernel,
+                     math::ConvolutionControl const &convolutionControl) {
+    if (convolvedImage.getDimensions() != inImage.getDimensions()) {
+        std::ostringstream os;
+        os << "convolvedImage dimensions = ( " << convolvedImage.getWidth() << ", "
+           << convolvedImage.getHeight() << ") != (" << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") = inImage dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if ((kernel.getWidth() < 1) || (kernel.getHeight() < 1)) {
+        std::ostringstream os;
+        os << "kernel dimensions = ( " << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") smaller than (1, 1) in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (inImage.getWidth() < kernel.getWidth() || inImage.getHeight() < kernel.getHeight()) {
+        std::ostringstream os;
+        os << "inImage dimensions = ( " << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") smaller than (" << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") = kernel dimensions in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+
+    if (convolutionControl.getNumThreads() != 1) {
+        return convolveInBands(convolvedImage, inImage, kernel, convolutionControl,
+                               [](OutImageT &outBand, InImageT const &inBand, math::Kernel const &bandKernel,
+                                  math::ConvolutionControl const &bandControl) {
+                                   convolveWithFft(outBand, inBand, bandKernel, bandControl);
+                               });
+    }
+
+    LOGL_DEBUG("TRACE2.afw.math.convolve.convolveWithFft", "convolveWithFft: kernel is spatially %s",
+               kernel.isSpatiallyVarying() ? "varying" : "invariant");
+
+    FftKernel const fftKernel(kernel, convolutionControl.getDoNormalize(), inImage.getXY0());
+    convolvePlanesWithFft(convolvedImage, inImage, fftKernel, kernel);
+}
+
+template <typename OutImageT, typename InImageT>
+bool shouldConvolveWithFft(OutImageT const &convolvedImage, InImageT const &inImage,
+                           math::Kernel const &kernel, math::ConvolutionControl const &convolutionControl) {
+    int const fftMinKernelSize = convolutionControl.getFftMinKernelSize();
+    if (fftMinKernelSize <= 0 || kernel.getWidth() < fftMinKernelSize ||
+        kernel.getHeight() < fftMinKernelSize) {
+        return false;
+    }
+    if (inImage.getWidth() < kernel.getWidth() || inImage.getHeight() < kernel.getHeight()) {
+        return false;  // let the real-space code report the error
+    }
+    /*
+     * Compare the cost of the inverse FFTs with that of the real-space sums; the forward FFTs
+     * are cheaper than either for the kernel sizes that we consider
+     */
+    int const nPlanes = getNPlanes(inImage);
+    int nTransforms = nPlanes;
+    if (kernel.isSpatiallyVarying()) {
+        auto const *basisKernel = dynamic_cast<math::LinearCombinationKernel const *>(&kernel);
+        if (!basisKernel) {
+            return false;
+        }
+        int const nBasis = basisKernel->getNBasisKernels();
+        nTransforms = (nPlanes == 1) ? nBasis : nBasis + nBasis * (nBasis + 1) / 2;
+    }
+    if (static_cast<long>(nTransforms) * FFT_COST_PER_TRANSFORM >
+        static_cast<long>(nPlanes) * kernel.getWidth() * kernel.getHeight()) {
+        return false;
+    }
+
+    return isFloatingPoint(convolvedImage) && allFinite(inImage);
+}
+
+/*
+ * Explicit instantiation
+ */
+/// @cond
+#define IMAGE(PIXTYPE) image::Image<PIXTYPE>
+#define MASKEDIMAGE(PIXTYPE) image::MaskedImage<PIXTYPE, image::MaskPixel, image::VariancePixel>
+#define NL /* */
+// Instantiate Image or MaskedImage versions
+#define INSTANTIATE_IM_OR_MI(IMGMACRO, OUTPIXTYPE, INPIXTYPE)                                          \
+    template void convolveWithFft(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,                  \
+                                  math::Kernel const &, math::ConvolutionControl const &);             \
+    NL template bool shouldConvolveWithFft(IMGMACRO(OUTPIXTYPE) const &, IMGMACRO(INPIXTYPE) const &,  \
+                                           math::Kernel const &, math::ConvolutionControl const &);
+// Instantiate both Image and MaskedImage versions
+#define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)             \
+    INSTANTIATE_IM_OR_MI(IMAGE, OUTPIXTYPE, INPIXTYPE) \
+    INSTANTIATE_IM_OR_MI(MASKEDIMAGE, OUTPIXTYPE, INPIXTYPE)
+
+INSTANTIATE(double, double)
+INSTANTIATE(double, float)
+INSTANTIATE(double, int)
+INSTANTIATE(double, std::uint16_t)
+INSTANTIATE(float, float)
+INSTANTIATE(float, int)
+INSTANTIATE(float, std::uint16_t)
+INSTANTIATE(int, int)
+INSTANTIATE(std::uint16_t, std::uint16_t)
+/// @endcond
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -60,34 +60,59 @@ void convolveWithInterpolation(OutImageT &outImage, InImageT const &inImage, mat
     lsst::geom::Box2I fullBBox = lsst::geom::Box2I(
             lsst::geom::Point2I(0, 0), lsst::geom::Extent2I(outImage.getWidth(), outImage.getHeight()));
     lsst::geom::Box2I goodBBox = kernel.shrinkBBox(fullBBox);
-    KernelImagesForRegion goodRegion(KernelImagesForRegion(kernel.clone(), goodBBox, inImage.getXY0(),
-                                                           convolutionControl.getDoNormalize()));
     LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: full bbox minimum=(%d, %d), extent=(%d, %d)", fullBBox.getMinX(),
                fullBBox.getMinY(), fullBBox.getWidth(), fullBBox.getHeight());
     LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: goodRegion bbox minimum=(%d, %d), extent=(%d, %d)",
-               goodRegion.getBBox().getMinX(), goodRegion.getBBox().getMinY(),
-               goodRegion.getBBox().getWidth(), goodRegion.getBBox().getHeight());
+               goodBBox.getMinX(), goodBBox.getMinY(), goodBBox.getWidth(), goodBBox.getHeight());
 
     // divide good region into subregions small enough to interpolate over
     int nx = 1 + (goodBBox.getWidth() / convolutionControl.getMaxInterpolationDistance());
     int ny = 1 + (goodBBox.getHeight() / convolutionControl.getMaxInterpolationDistance());
     LOGL_DEBUG("TRACE3.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: divide into %d x %d subregions", nx, ny);
+    std::vector<int> const widths = KernelImagesForRegion::computeSubregionLengths(goodBBox.getWidth(), nx);
+    std::vector<int> const heights = KernelImagesForRegion::computeSubregionLengths(goodBBox.getHeight(), ny);
+    std::vector<int> rowStarts(1, goodBBox.getMinY());
+    for (int height : heights) {
+        rowStarts.push_back(rowStarts.back() + height);
+    }
 
-    ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
-    RowOfKernelImagesForRegion regionRow(nx, ny);
-    while (goodRegion.computeNextRow(regionRow)) {
-        for (RowOfKernelImagesForRegion::ConstIterator rgnIter = regionRow.begin(), rgnEnd = regionRow.end();
-             rgnIter != rgnEnd; ++rgnIter) {
-            LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
-                       "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
-                       (*rgnIter)->getBBox().getMinX(), (*rgnIter)->getBBox().getMinY(),
-                       (*rgnIter)->getBBox().getWidth(), (*rgnIter)->getBBox().getHeight());
-            convolveRegionWithInterpolation(outImage, inImage, **rgnIter, workingImages);
+    // Each thread convolves a range of rows of subregions.  Kernel images at the corners of the subregions
+    // are shared with neighbouring subregions, as computeNextRow does, except along the bottom of the
+    // range, where the images are computed again rather than shared between threads.
+    int const nThreads = resolveNumThreads(convolutionControl.getNumThreads());
+    parallelForChunks(0, ny, nThreads, [&](int yInd0, int yInd1, int) {
+        KernelImagesForRegion::KernelConstPtr const kernelPtr = kernel.clone();
+        ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+        std::vector<KernelImagesForRegion::ImagePtr> bottomImages(nx + 1);  // along the bottom of the row
+        std::vector<KernelImagesForRegion::ImagePtr> topImages(nx + 1);     // along the top of the row
+        for (int yInd = yInd0; yInd < yInd1; ++yInd) {
+            int x0 = goodBBox.getMinX();
+            for (int xInd = 0; xInd < nx; ++xInd) {
+                KernelImagesForRegion region(
+                        kernelPtr,
+                        lsst::geom::Box2I(lsst::geom::Point2I(x0, rowStarts[yInd]),
+                                          lsst::geom::Extent2I(widths[xInd], heights[yInd])),
+                        inImage.getXY0(), convolutionControl.getDoNormalize(), bottomImages[xInd],
+                        bottomImages[xInd + 1], topImages[xInd], topImages[xInd + 1]);
+                LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
+                           "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
+                           region.getBBox().getMinX(), region.getBBox().getMinY(),
+                           region.getBBox().getWidth(), region.getBBox().getHeight());
+                convolveRegionWithInterpolation(outImage, inImage, region, workingImages);
+
+                bottomImages[xInd] = region.getImage(KernelImagesForRegion::BOTTOM_LEFT);
+                bottomImages[xInd + 1] = region.getImage(KernelImagesForRegion::BOTTOM_RIGHT);
+                topImages[xInd] = region.getImage(KernelImagesForRegion::TOP_LEFT);
+                topImages[xInd + 1] = region.getImage(KernelImagesForRegion::TOP_RIGHT);
+                x0 += widths[xInd];
+            }
+            bottomImages.swap(topImages);
+            std::fill(topImages.begin(), topImages.end(), KernelImagesForRegion::ImagePtr());
         }
-    }
+    });
 }
 
 template <typename OutImageT, typename InImageT>
@@ -0,0 +1,74 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+#include "lsst/afw/math/warpExposure.h"
+#include "lsst/afw/math/detail/TabulatedLanczosKernel.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+TabulatedLanczosKernel::TabulatedLanczosKernel(int order, int tableSize)
+        : _order(order), _tableSize(tableSize), _weights() {
+    if (order < 1 || tableSize < 1) {
+        std::ostringstream os;
+        os << "order = " << order << " and tableSize = " << tableSize << " must both be >= 1";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    // Evaluate the same function as LanczosWarpingKernel, whose center is at index order - 1
+    LanczosFunction1<double> func(order);
+    int const width = getWidth();
+    _weights.reserve((tableSize + 1) * width);
+    for (int ind = 0; ind <= tableSize; ++ind) {
+        func.setParameter(0, static_cast<double>(ind) / static_cast<double>(tableSize));
+        for (int i = 0; i < width; ++i) {
+            _weights.push_back(func(static_cast<double>(i + 1 - order)));
+        }
+    }
+}
+
+std::shared_ptr<TabulatedLanczosKernel const> TabulatedLanczosKernel::make(SeparableKernel const &kernel,
+                                                                           int tableSize) {
+    auto const lanczosKernel = dynamic_cast<LanczosWarpingKernel const *>(&kernel);
+    if (tableSize <= 0 || !lanczosKernel) {
+        return nullptr;
+    }
+    int const order = lanczosKernel->getOrder();
+    if (kernel.getCtr() != lsst::geom::Point2I(order - 1, order - 1)) {
+        return nullptr;  // the table assumes the default kernel center
+    }
+    return std::make_shared<TabulatedLanczosKernel const>(order, tableSize);
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -25,11 +25,13 @@
  * Support for warping an %image to a new Wcs.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -48,6 +50,8 @@
 #include "lsst/afw/geom.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/PhotoCalib.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/math/detail/TabulatedLanczosKernel.h"
 #include "lsst/afw/math/detail/WarpAtOnePoint.h"
 
 namespace pexExcept = lsst::pex::exceptions;
@@ -220,6 +224,33 @@ void WarpingControl::setMaskWarpingKernel(SeparableKernel const &maskWarpingKern
     _maskWarpingKernelPtr = std::static_pointer_cast<SeparableKernel>(maskWarpingKernel.clone());
 }
 
+void WarpingControl::setNumThreads(int numThreads) {
+    if (numThreads < 0) {
+        std::ostringstream os;
+        os << "numThreads = " << numThreads << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    _numThreads = numThreads;
+}
+
+void WarpingControl::setLanczosTableSize(int lanczosTableSize) {
+    if (lanczosTableSize < 0) {
+        std::ostringstream os;
+        os << "lanczosTableSize = " << lanczosTableSize << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    _lanczosTableSize = lanczosTableSize;
+}
+
+void WarpingControl::setInterpTolerance(double interpTolerance) {
+    if (!(interpTolerance >= 0)) {
+        std::ostringstream os;
+        os << "interpTolerance = " << interpTolerance << " must be >= 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    _interpTolerance = interpTolerance;
+}
+
 void WarpingControl::_testWarpingKernels(SeparableKernel const &warpingKernel,
                                          SeparableKernel const &maskWarpingKernel) const {
     lsst::geom::Box2I kernelBBox =
@@ -265,6 +296,22 @@ inline lsst::geom::Point2D computeSrcPos(
     return srcWcs.skyToPixel(destWcs.pixelToSky(destPix));
 }
 
+int const ROWS_PER_THREAD = 16;  // rows warped by each thread per batch when not interpolating
+int const GRID_POINTS_PER_BATCH = 1 << 16;  // interpolation grid points transformed per batch
+
+/*
+ * Return a copy of control with its own copies of the warping kernels, for use by one thread
+ * (as warping sets the kernel parameters)
+ */
+WarpingControl copyWithOwnKernels(WarpingControl const &control) {
+    WarpingControl copy(control);
+    copy.setWarpingKernel(*control.getWarpingKernel());
+    if (control.hasMaskWarpingKernel()) {
+        copy.setMaskWarpingKernel(*control.getMaskWarpingKernel());
+    }
+    return copy;
+}
+
 inline double computeRelativeArea(
         lsst::geom::Point2D const &srcPos,  /// @internal source position at desired destination pixel
         lsst::geom::Point2D const
@@ -277,20 +324,204 @@ inline double computeRelativeArea(
     return std::abs(dSrcA.getX() * dSrcB.getY() - dSrcA.getY() * dSrcB.getX());
 }
 
-}  // namespace
+/*
+ * A cell of the destination image over which source positions are linearly interpolated
+ *
+ * The cell contains pixels x0 < x <= x1, y0 < y <= y1 (in local indices), matching the convention
+ * for the edges of interpolation bands, and the source positions at its corners are exact.
+ */
+struct InterpCell {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    lsst::geom::Point2D src00;  // source position at (x0, y0)
+    lsst::geom::Point2D src10;  // source position at (x1, y0)
+    lsst::geom::Point2D src01;  // source position at (x0, y1)
+    lsst::geom::Point2D src11;  // source position at (x1, y1)
+
+    // Return the bilinearly interpolated source position at destination pixel (x, y)
+    lsst::geom::Point2D interpolate(double x, double y) const {
+        double const xFrac = (x - x0) / static_cast<double>(x1 - x0);
+        double const yFrac = (y - y0) / static_cast<double>(y1 - y0);
+        lsst::geom::Point2D const bottom = src00 + (src10 - src00) * xFrac;
+        lsst::geom::Point2D const top = src01 + (src11 - src01) * xFrac;
+        return bottom + (top - bottom) * yFrac;
+    }
+};
 
-template <typename DestImageT, typename SrcImageT>
-int warpImage(DestImageT &destImage, geom::SkyWcs const &destWcs, SrcImageT const &srcImage,
-              geom::SkyWcs const &srcWcs, WarpingControl const &control,
-              typename DestImageT::SinglePixel padValue) {
-    auto srcToDest = geom::makeWcsPairTransform(srcWcs, destWcs);
-    return warpImage(destImage, srcImage, *srcToDest, control, padValue);
+/*
+ * Split interpolation cells until interpolation is accurate to within a tolerance
+ *
+ * Each pass transforms the points at which every remaining cell would be split (the midpoints of its
+ * edges and its center, omitting axes that are only one pixel long) with one call to the transform,
+ * compares them to the interpolated positions, and splits the cells whose largest error exceeds
+ * the tolerance; these points are the corners of the new cells.
+ *
+ * @returns a list of cells that cover the same pixels as cellList
+ */
+std::vector<InterpCell> refineInterpCells(std::vector<InterpCell> cellList,
+                                          geom::TransformPoint2ToPoint2 const &localDestToParentSrc,
+                                          double tolerance) {
+    std::vector<InterpCell> leafList;
+    std::vector<InterpCell> childList;
+    std::vector<lsst::geom::Point2D> destPosList;
+    while (!cellList.empty()) {
+        destPosList.clear();
+        for (auto const &cell : cellList) {
+            int const xMid = cell.x0 + (cell.x1 - cell.x0) / 2;
+            int const yMid = cell.y0 + (cell.y1 - cell.y0) / 2;
+            bool const splitX = cell.x1 - cell.x0 > 1;
+            bool const splitY = cell.y1 - cell.y0 > 1;
+            if (splitX) {
+                destPosList.emplace_back(lsst::geom::Point2D(xMid, cell.y0));
+                destPosList.emplace_back(lsst::geom::Point2D(xMid, cell.y1));
+            }
+            if (splitY) {
+                destPosList.emplace_back(lsst::geom::Point2D(cell.x0, yMid));
+                destPosList.emplace_back(lsst::geom::Point2D(cell.x1, yMid));
+            }
+            if (splitX && splitY) {
+                destPosList.emplace_back(lsst::geom::Point2D(xMid, yMid));
+            }
+        }
+        std::vector<lsst::geom::Point2D> const srcPosList =
+                localDestToParentSrc.applyForward(destPosList);
+
+        childList.clear();
+        auto srcPosIter = srcPosList.begin();
+        for (auto const &cell : cellList) {
+            int const xMid = cell.x0 + (cell.x1 - cell.x0) / 2;
+            int const yMid = cell.y0 + (cell.y1 - cell.y0) / 2;
+            bool const splitX = cell.x1 - cell.x0 > 1;
+            bool const splitY = cell.y1 - cell.y0 > 1;
+            if (!splitX && !splitY) {
+                leafList.push_back(cell);
+                continue;
+            }
+            // compute the maximum error of interpolation while collecting the new corners
+            double maxErrSq = 0.0;
+            auto checkPoint = [&](double x, double y) {
+                lsst::geom::Point2D const srcPos = *srcPosIter++;
+                lsst::geom::Extent2D const err = srcPos - cell.interpolate(x, y);
+                maxErrSq = std::max(maxErrSq, err.computeSquaredNorm());
+                return srcPos;
+            };
+            lsst::geom::Point2D srcBottom, srcTop, srcLeft, srcRight, srcCenter;
+            if (splitX) {
+                srcBottom = checkPoint(xMid, cell.y0);
+                srcTop = checkPoint(xMid, cell.y1);
+            }
+            if (splitY) {
+                srcLeft = checkPoint(cell.x0, yMid);
+                srcRight = checkPoint(cell.x1, yMid);
+            }
+            if (splitX && splitY) {
+                srcCenter = checkPoint(xMid, yMid);
+            }
+            if (!(maxErrSq > tolerance * tolerance)) {
+                leafList.push_back(cell);
+            } else if (splitX && splitY) {
+                childList.push_back(
+                        {cell.x0, cell.y0, xMid, yMid, cell.src00, srcBottom, srcLeft, srcCenter});
+                childList.push_back(
+                        {xMid, cell.y0, cell.x1, yMid, srcBottom, cell.src10, srcCenter, srcRight});
+                childList.push_back({cell.x0, yMid, xMid, cell.y1, srcLeft, srcCenter, cell.src01, srcTop});
+                childList.push_back({xMid, yMid, cell.x1, cell.y1, srcCenter, srcRight, srcTop, cell.src11});
+            } else if (splitX) {
+                childList.push_back(
+                        {cell.x0, cell.y0, xMid, cell.y1, cell.src00, srcBottom, cell.src01, srcTop});
+                childList.push_back(
+                        {xMid, cell.y0, cell.x1, cell.y1, srcBottom, cell.src10, srcTop, cell.src11});
+            } else {
+                childList.push_back(
+                        {cell.x0, cell.y0, cell.x1, yMid, cell.src00, cell.src10, srcLeft, srcRight});
+                childList.push_back(
+                        {cell.x0, yMid, cell.x1, cell.y1, srcLeft, srcRight, cell.src01, cell.src11});
+            }
+        }
+        swap(cellList, childList);
+    }
+    return leafList;
 }
 
+/*
+ * Warp the pixels of one interpolation cell
+ *
+ * @param[in,out] coverage  if not null, set noDataBit for each pixel that cannot be computed
+ * @returns the number of good pixels
+ */
+template <typename DestImageT, typename WarpAtOnePointT>
+int warpInterpCell(DestImageT &destImage, WarpAtOnePointT &warpAtOnePoint, InterpCell const &cell,
+                   image::Mask<image::MaskPixel> *coverage, image::MaskPixel noDataBit) {
+    int numGoodPixels = 0;
+    double const invWidth = 1.0 / static_cast<double>(cell.x1 - cell.x0);
+    double const invHeight = 1.0 / static_cast<double>(cell.y1 - cell.y0);
+    lsst::geom::Extent2D const leftDelta = (cell.src01 - cell.src00) * invHeight;
+    lsst::geom::Extent2D const rightDelta = (cell.src11 - cell.src10) * invHeight;
+
+    // source positions along the left edge of the cell, and the change per column, for the previous row
+    lsst::geom::Point2D prevLeftSrcPos = cell.src00;
+    lsst::geom::Extent2D prevXDeltaSrcPos = (cell.src10 - cell.src00) * invWidth;
+    for (int row = cell.y0 + 1; row <= cell.y1; ++row) {
+        lsst::geom::Point2D const leftSrcPos = cell.src00 + leftDelta * (row - cell.y0);
+        lsst::geom::Point2D const rightSrcPos = cell.src10 + rightDelta * (row - cell.y0);
+        lsst::geom::Extent2D const xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidth;
+
+        typename DestImageT::x_iterator destXIter = destImage.x_at(cell.x0 + 1, row);
+        for (int i = 1, width = cell.x1 - cell.x0; i <= width; ++i, ++destXIter) {
+            lsst::geom::Point2D const srcPos = leftSrcPos + xDeltaSrcPos * i;
+            double const relativeArea = computeRelativeArea(srcPos, srcPos - xDeltaSrcPos,
+                                                            prevLeftSrcPos + prevXDeltaSrcPos * i);
+            if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                               typename image::detail::image_traits<DestImageT>::image_category())) {
+                ++numGoodPixels;
+            } else if (coverage) {
+                (*coverage)(cell.x0 + i, row) |= noDataBit;
+            }
+        }
+        prevLeftSrcPos = leftSrcPos;
+        prevXDeltaSrcPos = xDeltaSrcPos;
+    }
+    return numGoodPixels;
+}
+
+/*
+ * Make the transform from local destination pixels to parent source pixels that warpImageImpl evaluates
+ *
+ * The result is a deep copy that shares no AST objects with srcToDest, so it may be evaluated on another
+ * thread; as AST objects are not thread safe, this must be called on the thread that owns srcToDest.
+ *
+ * @param[in] srcToDest  transform from parent source pixels to parent destination pixels
+ * @param[in] destXY0  xy0 of the destination image
+ */
+std::shared_ptr<geom::TransformPoint2ToPoint2> makeLocalDestToParentSrc(
+        geom::TransformPoint2ToPoint2 const &srcToDest, lsst::geom::Point2I const &destXY0) {
+    auto const parentDestToParentSrc = srcToDest.inverted();
+    std::vector<double> const localDestToParentDestVec = {static_cast<double>(destXY0.getX()),
+                                                          static_cast<double>(destXY0.getY())};
+    auto const localDestToParentDest = geom::TransformPoint2ToPoint2(ast::ShiftMap(localDestToParentDestVec));
+    auto const localDestToParentSrc = localDestToParentDest.then(*parentDestToParentSrc);
+    // then() may share AST objects with its inputs; copy without simplifying to get independent objects
+    return std::make_shared<geom::TransformPoint2ToPoint2>(*localDestToParentSrc->getMapping(), false);
+}
+
+/*
+ * Implement warpImage, optionally recording which pixels could be computed
+ *
+ * Only localDestToParentSrc is evaluated; no transforms are made or combined here, so this may be called
+ * on any thread with a transform made by makeLocalDestToParentSrc.
+ *
+ * @param[in] localDestToParentSrc  transform from local destination pixels to parent source pixels
+ * @param[in,out] coverage  if not null, a mask the size of destImage, initially zero, in which
+ *                          noDataBit is set for each destination pixel that could not be computed
+ * @param[in] noDataBit  mask bit to set in coverage
+ */
 template <typename DestImageT, typename SrcImageT>
-int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
-              geom::TransformPoint2ToPoint2 const &srcToDest, WarpingControl const &control,
-              typename DestImageT::SinglePixel padValue) {
+int warpImageImpl(DestImageT &destImage, SrcImageT const &srcImage,
+                  geom::TransformPoint2ToPoint2 const &localDestToParentSrc, WarpingControl const &control,
+                  typename DestImageT::SinglePixel padValue, image::Mask<image::MaskPixel> *coverage,
+                  image::MaskPixel noDataBit) {
     if (imagesOverlap(destImage, srcImage)) {
         throw LSST_EXCEPT(pexExcept::InvalidParameterError, "destImage overlaps srcImage; cannot warp");
     }
@@ -308,21 +539,14 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
                 *destPtr = padValue;
             }
         }
+        if (coverage) {
+            *coverage |= noDataBit;
+        }
         return 0;
     }
     int interpLength = control.getInterpLength();
-
-    std::shared_ptr<LanczosWarpingKernel const> const lanczosKernelPtr =
-            std::dynamic_pointer_cast<LanczosWarpingKernel>(warpingKernelPtr);
-
-    int numGoodPixels = 0;
-
-    // compute a transform from local destination pixels to parent source pixels
-    auto const parentDestToParentSrc = srcToDest.inverted();
-    std::vector<double> const localDestToParentDestVec = {static_cast<double>(destImage.getX0()),
-                                                          static_cast<double>(destImage.getY0())};
-    auto const localDestToParentDest = geom::TransformPoint2ToPoint2(ast::ShiftMap(localDestToParentDestVec));
-    auto const localDestToParentSrc = localDestToParentDest.then(*parentDestToParentSrc);
+    double const interpTolerance = control.getInterpTolerance();
+    int const nThreads = detail::resolveNumThreads(control.getNumThreads());
 
     // Get the source MaskedImage and a pixel accessor to it.
     int const srcWidth = srcImage.getWidth();
@@ -331,7 +555,8 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
 
     int const destWidth = destImage.getWidth();
     int const destHeight = destImage.getHeight();
-    LOGL_DEBUG("TRACE2.afw.math.warp", "remap image width=%d; height=%d", destWidth, destHeight);
+    LOGL_DEBUG("TRACE2.afw.math.warp", "remap image width=%d; height=%d; %d threads", destWidth, destHeight,
+               nThreads);
 
     // Set each pixel of destExposure's MaskedImage
     LOGL_DEBUG("TRACE3.afw.math.warp", "Remapping masked image");
@@ -339,7 +564,28 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
     int const maxCol = destWidth - 1;
     int const maxRow = destHeight - 1;
 
-    detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
+    // Tabulated kernels (if wanted) are not modified by warping, so are shared between threads
+    int const lanczosTableSize = control.getLanczosTableSize();
+    auto const kernelTable = detail::TabulatedLanczosKernel::make(*warpingKernelPtr, lanczosTableSize);
+    std::shared_ptr<detail::TabulatedLanczosKernel const> maskKernelTable;
+    if (control.hasMaskWarpingKernel()) {
+        maskKernelTable =
+                detail::TabulatedLanczosKernel::make(*control.getMaskWarpingKernel(), lanczosTableSize);
+    }
+
+    // One WarpAtOnePoint per thread, as each sets the parameters of its own warping kernels
+    typedef detail::WarpAtOnePoint<DestImageT, SrcImageT> WarpAtOnePoint;
+    std::vector<std::unique_ptr<WarpAtOnePoint>> warpAtOnePointList;
+    if (nThreads == 1) {
+        warpAtOnePointList.push_back(std::make_unique<WarpAtOnePoint>(srcImage, control, padValue,
+                                                                      kernelTable, maskKernelTable));
+    } else {
+        for (int i = 0; i < nThreads; ++i) {
+            warpAtOnePointList.push_back(std::make_unique<WarpAtOnePoint>(
+                    srcImage, copyWithOwnKernels(control), padValue, kernelTable, maskKernelTable));
+        }
+    }
+    std::vector<int> numGoodPixelsList(nThreads, 0);  // number of good pixels found by each thread
 
     if (interpLength > 0) {
         // Use interpolation. Note that 1 produces the same result as no interpolation
@@ -372,138 +618,287 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
         }
         assert(edgeColList.back() == maxCol);
 
-        // A list of delta source positions along the edge columns of the horizontal interpolation bands
-        std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
-
-        // A cache of pixel positions on the source corresponding to the previous or current row
-        // of the destination image.
-        // The first value is for column -1 because the previous source position is used to compute relative
-        // area To simplify the indexing, use an iterator that starts at begin+1, thus: srcPosView =
-        // srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row srcPosView[col] and
-        // higher indices are for the previous row
-        std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
-        std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
-
-        std::vector<lsst::geom::Point2D> endColPosList;
-        endColPosList.reserve(numColEdges);
-
-        // Initialize srcPosList for row -1
-        for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-            int const endCol = edgeColList[colBand];
-            endColPosList.emplace_back(lsst::geom::Point2D(endCol, -1));
-        }
-        auto rightSrcPosList = localDestToParentSrc->applyForward(endColPosList);
-        srcPosView[-1] = rightSrcPosList[0];
-        for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-            int const prevEndCol = edgeColList[colBand - 1];
-            int const endCol = edgeColList[colBand];
-            lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-
-            lsst::geom::Extent2D xDeltaSrcPos =
-                    (rightSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
-
-            for (int col = prevEndCol + 1; col <= endCol; ++col) {
-                srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
-            }
+        // A list of edge row indices for interpolation bands, defined like edgeColList
+        std::vector<int> edgeRowList(1, -1);
+        for (int prevEndRow = -1; prevEndRow < maxRow; prevEndRow += interpLength) {
+            edgeRowList.push_back(std::min(prevEndRow + interpLength, maxRow));
         }
 
-        int endRow = -1;
-        while (endRow < maxRow) {
-            // Next horizontal interpolation band
-
-            int prevEndRow = endRow;
-            endRow = prevEndRow + interpLength;
-            if (endRow > maxRow) {
-                endRow = maxRow;
-            }
-            assert(endRow - prevEndRow > 0);
-            double interpInvHeight = 1.0 / static_cast<double>(endRow - prevEndRow);
-
-            // Set yDeltaSrcPosList for this horizontal interpolation band
-            std::vector<lsst::geom::Point2D> destRowPosList;
-            destRowPosList.reserve(edgeColList.size());
-            for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                int endCol = edgeColList[colBand];
-                destRowPosList.emplace_back(lsst::geom::Point2D(endCol, endRow));
+        // Source positions on the grid of edge rows and edge columns are computed in this thread
+        // (transforms must not be shared between threads) for a batch of horizontal interpolation bands
+        // at a time, using one call to the transform per batch to minimize the overhead of each call.
+        // srcGridPosList[(edgeRow - batchStart) * numEdgeCols + colBand] is the source position
+        // of edge row edgeRow and edge column colBand.
+        int const numEdgeCols = edgeColList.size();
+        int const numBands = edgeRowList.size() - 1;
+        int const bandsPerBatch = std::max(1, GRID_POINTS_PER_BATCH / numEdgeCols - 1);
+        std::vector<lsst::geom::Point2D> destGridPosList;
+        destGridPosList.reserve((1 + std::min(bandsPerBatch, numBands)) * numEdgeCols);
+        std::vector<lsst::geom::Point2D> srcGridPosList;
+
+        for (int batchStart = 0; batchStart < numBands; batchStart += bandsPerBatch) {
+            int const batchEnd = std::min(batchStart + bandsPerBatch, numBands);
+            destGridPosList.clear();
+            for (int edgeRow = batchStart; edgeRow <= batchEnd; ++edgeRow) {
+                for (int endCol : edgeColList) {
+                    destGridPosList.emplace_back(lsst::geom::Point2D(endCol, edgeRowList[edgeRow]));
+                }
             }
-            auto bottomSrcPosList = localDestToParentSrc->applyForward(destRowPosList);
-            for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                int endCol = edgeColList[colBand];
-                yDeltaSrcPosList[colBand] =
-                        (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
+            srcGridPosList = localDestToParentSrc.applyForward(destGridPosList);
+
+            if (interpTolerance > 0) {
+                // Adaptive interpolation: split the cells of this batch as needed, then warp them
+                std::vector<InterpCell> cellList;
+                cellList.reserve((batchEnd - batchStart) * (numEdgeCols - 1));
+                for (int band = batchStart; band < batchEnd; ++band) {
+                    lsst::geom::Point2D const *bottomSrcPosList =
+                            srcGridPosList.data() + (band - batchStart) * numEdgeCols;
+                    lsst::geom::Point2D const *topSrcPosList = bottomSrcPosList + numEdgeCols;
+                    for (int colBand = 1; colBand < numEdgeCols; ++colBand) {
+                        cellList.push_back({edgeColList[colBand - 1], edgeRowList[band], edgeColList[colBand],
+                                            edgeRowList[band + 1], bottomSrcPosList[colBand - 1],
+                                            bottomSrcPosList[colBand], topSrcPosList[colBand - 1],
+                                            topSrcPosList[colBand]});
+                    }
+                }
+                cellList = refineInterpCells(std::move(cellList), localDestToParentSrc, interpTolerance);
+                detail::parallelForChunks(0, cellList.size(), nThreads, [&](int cell0, int cell1,
+                                                                            int iChunk) {
+                    WarpAtOnePoint &warpAtOnePoint = *warpAtOnePointList[iChunk];
+                    int numGoodPixels = 0;
+                    for (int i = cell0; i < cell1; ++i) {
+                        numGoodPixels +=
+                                warpInterpCell(destImage, warpAtOnePoint, cellList[i], coverage, noDataBit);
+                    }
+                    numGoodPixelsList[iChunk] += numGoodPixels;
+                });
+                continue;
             }
 
-            for (int row = prevEndRow + 1; row <= endRow; ++row) {
-                typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-                srcPosView[-1] += yDeltaSrcPosList[0];
-                for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                    // Next vertical interpolation band
-
-                    int const prevEndCol = edgeColList[colBand - 1];
-                    int const endCol = edgeColList[colBand];
+            // Warp each horizontal interpolation band; they are independent, so are split between threads
+            detail::parallelForChunks(batchStart, batchEnd, nThreads, [&](int band0, int band1, int iChunk) {
+                WarpAtOnePoint &warpAtOnePoint = *warpAtOnePointList[iChunk];
+                int numGoodPixels = 0;
+
+                // A list of delta source positions along the edge columns
+                // of the horizontal interpolation bands
+                std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
+
+                // A cache of pixel positions on the source corresponding to the previous or current row
+                // of the destination image.
+                // The first value is for column -1 because the previous source position is used to compute
+                // relative area To simplify the indexing, use an iterator that starts at begin+1, thus:
+                // srcPosView = srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row
+                // srcPosView[col] and higher indices are for the previous row
+                std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
+                std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
+
+                for (int band = band0; band < band1; ++band) {
+                    // Next horizontal interpolation band
+                    int const prevEndRow = edgeRowList[band];
+                    int const endRow = edgeRowList[band + 1];
+                    assert(endRow - prevEndRow > 0);
+                    double interpInvHeight = 1.0 / static_cast<double>(endRow - prevEndRow);
+
+                    // Initialize srcPosList for row prevEndRow
+                    lsst::geom::Point2D const *topSrcPosList =
+                            srcGridPosList.data() + (band - batchStart) * numEdgeCols;
+                    srcPosView[-1] = topSrcPosList[0];
+                    for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+                        int const prevEndCol = edgeColList[colBand - 1];
+                        int const endCol = edgeColList[colBand];
+                        lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+
+                        lsst::geom::Extent2D xDeltaSrcPos =
+                                (topSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
+
+                        for (int col = prevEndCol + 1; col <= endCol; ++col) {
+                            srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
+                        }
+                    }
+
+                    // Set yDeltaSrcPosList for this horizontal interpolation band
+                    lsst::geom::Point2D const *bottomSrcPosList = topSrcPosList + numEdgeCols;
+                    for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+                        int endCol = edgeColList[colBand];
+                        yDeltaSrcPosList[colBand] =
+                                (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
+                    }
+
+                    for (int row = prevEndRow + 1; row <= endRow; ++row) {
+                        typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+                        srcPosView[-1] += yDeltaSrcPosList[0];
+                        for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+                            // Next vertical interpolation band
+
+                            int const prevEndCol = edgeColList[colBand - 1];
+                            int const endCol = edgeColList[colBand];
+
+                            // Compute xDeltaSrcPos; remember that srcPosView contains
+                            // positions for this row in prevEndCol and smaller indices,
+                            // and positions for the previous row for larger indices (including endCol)
+                            lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+                            lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
+                            lsst::geom::Extent2D xDeltaSrcPos =
+                                    (rightSrcPos - leftSrcPos) * invWidthList[colBand];
+
+                            for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
+                                lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
+                                lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
+                                double relativeArea =
+                                        computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
+
+                                srcPosView[col] = srcPos;
+
+                                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                                                   typename image::detail::image_traits<
+                                                           DestImageT>::image_category())) {
+                                    ++numGoodPixels;
+                                } else if (coverage) {
+                                    (*coverage)(col, row) |= noDataBit;
+                                }
+                            }  // for col
+                        }      // for col band
+                    }          // for row
+                }              // for band
+                numGoodPixelsList[iChunk] += numGoodPixels;
+            });
+        }  // for batch
 
-                    // Compute xDeltaSrcPos; remember that srcPosView contains
-                    // positions for this row in prevEndCol and smaller indices,
-                    // and positions for the previous row for larger indices (including endCol)
-                    lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-                    lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
-                    lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
+    } else {
+        // No interpolation
 
-                    for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
-                        lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
-                        lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
-                        double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
+        // Source positions are computed in this thread (transforms must not be shared between threads)
+        // for a stripe of rows at a time, which are then warped in parallel.
+        // srcPosRowList[0] holds the positions for the row before the stripe; these are used to compute
+        // pixel area; to begin, compute source positions corresponding to destination row = -1
+        int const stripeHeight = nThreads == 1 ? 1 : nThreads * ROWS_PER_THREAD;
+        std::vector<std::vector<lsst::geom::Point2D>> srcPosRowList(1 + stripeHeight);
+        std::vector<lsst::geom::Point2D> destPosList;
+        destPosList.reserve(1 + destWidth);
+        auto computeSrcPosRow = [&](int row) {
+            destPosList.clear();
+            for (int col = -1; col < destWidth; ++col) {
+                destPosList.emplace_back(lsst::geom::Point2D(col, row));
+            }
+            return localDestToParentSrc.applyForward(destPosList);
+        };
+        srcPosRowList[0] = computeSrcPosRow(-1);
+
+        for (int stripeStart = 0; stripeStart < destHeight; stripeStart += stripeHeight) {
+            int const stripeEnd = std::min(stripeStart + stripeHeight, destHeight);
+            for (int row = stripeStart; row < stripeEnd; ++row) {
+                srcPosRowList[1 + row - stripeStart] = computeSrcPosRow(row);
+            }
 
-                        srcPosView[col] = srcPos;
+            detail::parallelForChunks(stripeStart, stripeEnd, nThreads, [&](int row0, int row1, int iChunk) {
+                WarpAtOnePoint &warpAtOnePoint = *warpAtOnePointList[iChunk];
+                int numGoodPixels = 0;
+                for (int row = row0; row < row1; ++row) {
+                    // the first entry in each list of positions is for column -1
+                    std::vector<lsst::geom::Point2D> const &prevSrcPosList = srcPosRowList[row - stripeStart];
+                    std::vector<lsst::geom::Point2D> const &srcPosList = srcPosRowList[1 + row - stripeStart];
+
+                    typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+                    for (int col = 0; col < destWidth; ++col, ++destXIter) {
+                        // column index = column + 1 because the first entry in srcPosList is for column -1
+                        auto srcPos = srcPosList[col + 1];
+                        double relativeArea =
+                                computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
 
                         if (warpAtOnePoint(
                                     destXIter, srcPos, relativeArea,
                                     typename image::detail::image_traits<DestImageT>::image_category())) {
                             ++numGoodPixels;
+                        } else if (coverage) {
+                            (*coverage)(col, row) |= noDataBit;
                         }
                     }  // for col
-                }      // for col band
-            }          // for row
-        }              // while next row band
+                }      // for row
+                numGoodPixelsList[iChunk] += numGoodPixels;
+            });
+            // the last row of this stripe is the previous row of the next
+            swap(srcPosRowList[0], srcPosRowList[stripeEnd - stripeStart]);
+        }  // for stripe
+    }      // if interp
 
-    } else {
-        // No interpolation
+    return std::accumulate(numGoodPixelsList.begin(), numGoodPixelsList.end(), 0);
+}
 
-        // prevSrcPosList = source positions from the previous row; these are used to compute pixel area;
-        // to begin, compute sources positions corresponding to destination row = -1
-        std::vector<lsst::geom::Point2D> destPosList;
-        destPosList.reserve(1 + destWidth);
-        for (int col = -1; col < destWidth; ++col) {
-            destPosList.emplace_back(lsst::geom::Point2D(col, -1));
-        }
-        auto prevSrcPosList = localDestToParentSrc->applyForward(destPosList);
+}  // namespace
 
-        for (int row = 0; row < destHeight; ++row) {
-            destPosList.clear();
-            for (int col = -1; col < destWidth; ++col) {
-                destPosList.emplace_back(lsst::geom::Point2D(col, row));
-            }
-            auto srcPosList = localDestToParentSrc->applyForward(destPosList);
-
-            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-            for (int col = 0; col < destWidth; ++col, ++destXIter) {
-                // column index = column + 1 because the first entry in srcPosList is for column -1
-                auto srcPos = srcPosList[col + 1];
-                double relativeArea =
-                        computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
-
-                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
-                                   typename image::detail::image_traits<DestImageT>::image_category())) {
-                    ++numGoodPixels;
-                }
-            }  // for col
-            // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
-            // because it will be reallocated anyway)
-            swap(srcPosList, prevSrcPosList);
-        }  // for row
-    }      // if interp
+template <typename DestImageT, typename SrcImageT>
+int warpImage(DestImageT &destImage, geom::SkyWcs const &destWcs, SrcImageT const &srcImage,
+              geom::SkyWcs const &srcWcs, WarpingControl const &control,
+              typename DestImageT::SinglePixel padValue) {
+    auto srcToDest = geom::makeWcsPairTransform(srcWcs, destWcs);
+    return warpImage(destImage, srcImage, *srcToDest, control, padValue);
+}
 
-    return numGoodPixels;
+template <typename DestImageT, typename SrcImageT>
+int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
+              geom::TransformPoint2ToPoint2 const &srcToDest, WarpingControl const &control,
+              typename DestImageT::SinglePixel padValue) {
+    auto const localDestToParentSrc = makeLocalDestToParentSrc(srcToDest, destImage.getXY0());
+    return warpImageImpl(destImage, srcImage, *localDestToParentSrc, control, padValue, nullptr, 0);
+}
+
+template <typename DestExposureT, typename SrcExposureT>
+std::vector<WarpedExposure<DestExposureT>> warpExposures(
+        std::shared_ptr<geom::SkyWcs const> const &destWcs, lsst::geom::Box2I const &destBBox,
+        std::vector<std::shared_ptr<SrcExposureT>> const &srcExposures, WarpingControl const &control,
+        typename DestExposureT::MaskedImageT::SinglePixel padValue) {
+    if (!destWcs) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, "destWcs is empty");
+    }
+    int const numExposures = srcExposures.size();
+    for (int i = 0; i < numExposures; ++i) {
+        if (!srcExposures[i] || !srcExposures[i]->hasWcs()) {
+            std::ostringstream os;
+            os << "srcExposures[" << i << "] is empty or has no Wcs";
+            throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+        }
+    }
+
+    // Make every transform the warping threads evaluate on this thread, as independent deep copies,
+    // so the threads never make, invert or combine transforms, nor share AST objects
+    auto const destInverse = destWcs->getTransform()->inverted();
+    std::vector<std::shared_ptr<geom::TransformPoint2ToPoint2>> localDestToParentSrcList;
+    localDestToParentSrcList.reserve(numExposures);
+
+    // Allocate all outputs up front; the warped exposures share destWcs
+    std::vector<WarpedExposure<DestExposureT>> resultList;
+    resultList.reserve(numExposures);
+    for (auto const &srcExposure : srcExposures) {
+        auto const srcToDest = srcExposure->getWcs()->getTransform()->then(*destInverse);
+        localDestToParentSrcList.push_back(makeLocalDestToParentSrc(*srcToDest, destBBox.getMin()));
+        auto destExposure = std::make_shared<DestExposureT>(destBBox, destWcs);
+        destExposure->setPhotoCalib(srcExposure->getPhotoCalib());
+        destExposure->setFilter(srcExposure->getFilter());
+        destExposure->getInfo()->setVisitInfo(srcExposure->getInfo()->getVisitInfo());
+        auto coverage = std::make_shared<image::Mask<image::MaskPixel>>(destBBox);
+        resultList.push_back(WarpedExposure<DestExposureT>{destExposure, coverage, 0});
+    }
+    if (numExposures == 0) {
+        return resultList;
+    }
+    image::MaskPixel const noDataBit = image::Mask<image::MaskPixel>::getPlaneBitMask("NO_DATA");
+
+    // Warp whole exposures in parallel; threads beyond one per exposure warp bands of rows.
+    // Each chunk reuses one copy of the warping kernels (and their caches) for all of its exposures.
+    int const nThreads = detail::resolveNumThreads(control.getNumThreads());
+    int const nChunks = std::min(nThreads, numExposures);
+    detail::parallelForChunks(0, numExposures, nChunks, [&](int begin, int end, int) {
+        WarpingControl chunkControl = copyWithOwnKernels(control);
+        chunkControl.setNumThreads(std::max(1, nThreads / nChunks));
+        for (int i = begin; i < end; ++i) {
+            typename DestExposureT::MaskedImageT destImage = resultList[i].exposure->getMaskedImage();
+            resultList[i].numGoodPixels =
+                    warpImageImpl(destImage, srcExposures[i]->getMaskedImage(), *localDestToParentSrcList[i],
+                                  chunkControl, padValue, resultList[i].coverage.get(), noDataBit);
+        }
+    });
+    return resultList;
 }
 
 template <typename DestImageT, typename SrcImageT>
@@ -586,7 +981,11 @@ int warpCenteredImage(DestImageT &destImage, SrcImageT const &srcImage,
                               MASKEDIMAGE(DESTIMAGEPIXELT)::SinglePixel padValue);                           \
     NL template int warpExposure(EXPOSURE(DESTIMAGEPIXELT) & destExposure,                                   \
                                  EXPOSURE(SRCIMAGEPIXELT) const &srcExposure, WarpingControl const &control, \
-                                 EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);
+                                 EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);             \
+    NL template std::vector<WarpedExposure<EXPOSURE(DESTIMAGEPIXELT)>> warpExposures(                        \
+            std::shared_ptr<geom::SkyWcs const> const &destWcs, lsst::geom::Box2I const &destBBox,           \
+            std::vector<std::shared_ptr<EXPOSURE(SRCIMAGEPIXELT)>> const &srcExposures,                      \
+            WarpingControl const &control, EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);
 
 INSTANTIATE(double, double)
 INSTANTIATE(double, float)
@@ -1,6 +1,9 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <new>
 
 #include "boost/shared_ptr.hpp"  // only for ndarray
 
@@ -42,7 +45,7 @@ public:
     // the entire block goes out of scope.
     static void reclaim(std::size_t recordSize, void *data, ndarray::Manager::Ptr const &manager) {
         Ptr block = boost::static_pointer_cast<Block>(manager);
-        if (reinterpret_cast<char *>(data) + recordSize == block->_next) {
+        if (!block->_owner && reinterpret_cast<char *>(data) + recordSize == block->_next) {
             block->_next -= recordSize;
         }
     }
@@ -57,17 +60,35 @@ public:
         }
     }
 
+    // Install a block that doles out existing record data owned by another manager, instead of
+    // allocating and zeroing its own memory.
+    static void adopt(char *data, std::size_t recordSize, std::size_t recordCount,
+                      ndarray::Manager::Ptr const &owner, ndarray::Manager::Ptr &manager) {
+        manager = Ptr(new Block(data, recordSize * recordCount, owner));
+    }
+
+    // Return true if the chunks of the block already hold valid record data.
+    static bool isInitialized(ndarray::Manager::Ptr const &manager) {
+        return boost::static_pointer_cast<Block>(manager)->_owner != nullptr;
+    }
+
     static std::size_t getBufferSize(std::size_t recordSize, ndarray::Manager::Ptr const &manager) {
         Ptr block = boost::static_pointer_cast<Block>(manager);
         return static_cast<std::size_t>(block->_end - block->_next) / recordSize;
     }
 
-    // Get the next chunk from the block, making a new block and installing it into the table
-    // if we're all out of space.
-    static void *get(std::size_t recordSize, ndarray::Manager::Ptr &manager) {
+    // Return true if there is no block, or no space left in it.
+    static bool isFull(ndarray::Manager::Ptr const &manager) {
+        Ptr block = boost::static_pointer_cast<Block>(manager);
+        return !block || block->_next == block->_end;
+    }
+
+    // Get the next chunk from the block, making a new block with the given number of records
+    // and installing it into the table if we're all out of space.
+    static void *get(std::size_t recordSize, std::size_t recordCount, ndarray::Manager::Ptr &manager) {
         Ptr block = boost::static_pointer_cast<Block>(manager);
         if (!block || block->_next == block->_end) {
-            block = Ptr(new Block(recordSize, BaseTable::nRecordsPerBlock));
+            block = Ptr(new Block(recordSize, recordCount));
             manager = block;
         }
         void *r = block->_next;
@@ -99,7 +120,11 @@ private:
         std::fill(_next, _end, 0);  // initialize to zero; we'll later initialize floats to NaN.
     }
 
+    Block(char *data, std::size_t size, ndarray::Manager::Ptr const &owner)
+            : _owner(owner), _next(data), _end(data + size) {}
+
     std::unique_ptr<AllocType[]> _mem;
+    ndarray::Manager::Ptr _owner;  // owner of externally-allocated memory; null if we own _mem
     char *_next;
     char *_end;
 };
@@ -181,17 +206,86 @@ struct RecordDestroyer {
     char *data;
 };
 
+// A Schema functor used to move variable-length array fields to a new copy of a record (whose other
+// fields have already been copied), destroying the originals.  All other fields are ignored.
+struct RecordMover {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {}
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const &item) const {
+        typedef ndarray::Array<T, 1, 1> Element;
+        if (item.key.isVariableLength()) {
+            move<Element>(item.key.getOffset());
+        }
+    }
+
+    void operator()(SchemaItem<std::string> const &item) const {
+        if (item.key.isVariableLength()) {
+            move<std::string>(item.key.getOffset());
+        }
+    }
+
+    template <typename T>
+    void move(int offset) const {
+        T *original = reinterpret_cast<T *>(from + offset);
+        new (to + offset) T(std::move(*original));
+        original->~T();
+    }
+
+    char *from;
+    char *to;
+};
+
 }  // namespace
 
 detail::RecordData BaseTable::_makeNewRecordData() {
-    auto data = Block::get(_schema.getRecordSize(), _manager);
+    std::size_t const recordSize = _schema.getRecordSize();
+    if (Block::isFull(_manager)) {
+        // Grow blocks geometrically, as std::vector does, so building a catalog a record at a time
+        // needs only a logarithmic number of blocks.
+        std::size_t const minCount = static_cast<std::size_t>(std::max(nRecordsPerBlock, 1));
+        std::size_t const maxCount =
+                std::max(maxBytesPerBlock / std::max(recordSize, std::size_t(1)), minCount);
+        _blockRecordCount = _blockRecordCount == 0 ? minCount : std::min(2 * _blockRecordCount, maxCount);
+    }
+    auto data = Block::get(recordSize, _blockRecordCount, _manager);
     return detail::RecordData{
         data,
         shared_from_this(),
-        _manager  // manager always points to the most recently-used block.
+        _manager,  // manager always points to the most recently-used block.
+        Block::isInitialized(_manager)
     };
 }
 
+void BaseTable::_compact(std::vector<BaseRecord *> const &records) {
+    // CatalogT::compact has already checked that the records belong to this table
+    std::vector<BaseRecord *> sorted(records);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError,
+                          "Cannot compact a catalog that holds the same record more than once.");
+    }
+    std::size_t const recordSize = _schema.getRecordSize();
+    ndarray::Manager::Ptr manager;
+    Block::preallocate(recordSize, records.size(), manager);
+    for (BaseRecord *record : records) {
+        void *data = Block::get(recordSize, records.size(), manager);
+        std::memcpy(data, record->_data, recordSize);
+        RecordMover f = {reinterpret_cast<char *>(record->_data), reinterpret_cast<char *>(data)};
+        _schema.forEach(f);
+        record->_data = data;
+        record->_manager = manager;
+    }
+    // The new block is full, so new records will get a block of their own either way; installing it
+    // just lets go of the old one.
+    _manager = manager;
+}
+
+void BaseTable::_useRecordData(void *data, std::size_t nRecords, ndarray::Manager::Ptr const &owner) {
+    Block::adopt(reinterpret_cast<char *>(data), _schema.getRecordSize(), nRecords, owner, _manager);
+}
+
 void BaseTable::_destroy(BaseRecord &record) {
     assert(record._table.get() == this);
     RecordDestroyer f = {reinterpret_cast<char *>(record._data)};
@@ -207,6 +301,8 @@ void BaseTable::_destroy(BaseRecord &record) {
  */
 int BaseTable::nRecordsPerBlock = 100;
 
+std::size_t BaseTable::maxBytesPerBlock = 1 << 20;  // bounds what one surviving record can pin
+
 // =============== BaseCatalog instantiation =================================================================
 
 template class CatalogT<BaseRecord>;
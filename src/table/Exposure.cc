@@ -330,6 +330,10 @@ public:
     }
 
     bool usesArchive(int ioFlags) const override { return true; }
+
+    std::set<std::string> getRequiredFields(int ioFlags) const override {
+        return ExposureTable::makeMinimalSchema().getNames();
+    }
 };
 
 static ExposureFitsReader const exposureFitsReader;
@@ -59,6 +59,10 @@ public:
         table->setMetadata(metadata);
         return table;
     }
+
+    std::set<std::string> getRequiredFields(int ioFlags) const override {
+        return SimpleTable::makeMinimalSchema().getNames();
+    }
 };
 
 // registers the reader so FitsReader::make can use it.
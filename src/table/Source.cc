@@ -352,6 +352,10 @@ public:
     }
 
     bool usesArchive(int ioFlags) const override { return !(ioFlags & SOURCE_IO_NO_FOOTPRINTS); }
+
+    std::set<std::string> getRequiredFields(int ioFlags) const override {
+        return SourceTable::makeMinimalSchema().getNames();
+    }
 };
 
 // registers the reader so FitsReader::make can use it.
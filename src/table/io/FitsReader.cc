@@ -1,5 +1,7 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+
 #include "lsst/afw/table/io/FitsReader.h"
 
 namespace lsst {
@@ -21,6 +23,15 @@ static FitsReader const ampInfoFitsReader("AMPINFO");
 
 }  // namespace
 
+bool FitsReadSelection::selectsField(std::string const& name) const {
+    if (selectsAllFields() || std::find(fields.begin(), fields.end(), name) != fields.end()) {
+        return true;
+    }
+    return std::any_of(prefixes.begin(), prefixes.end(), [&name](std::string const& prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
 std::shared_ptr<BaseTable> FitsReader::makeTable(FitsSchemaInputMapper& mapper,
                                                  std::shared_ptr<daf::base::PropertyList> metadata,
                                                  int ioFlags, bool stripMetadata) const {
@@ -43,6 +54,14 @@ FitsReader const* FitsReader::_lookupFitsReader(daf::base::PropertyList const& m
     return i->second;
 }
 
+void FitsReader::_setupSelection(FitsSchemaInputMapper& mapper, FitsReadSelection const& selection,
+                                 int ioFlags) const {
+    std::set<std::string> required = getRequiredFields(ioFlags);
+    mapper.select([selection, required](std::string const& name) {
+        return required.count(name) > 0 || selection.selectsField(name);
+    });
+}
+
 void FitsReader::_setupArchive(afw::fits::Fits& fits, FitsSchemaInputMapper& mapper,
                                std::shared_ptr<InputArchive> archive, int ioFlags) const {
     if (usesArchive(ioFlags)) {
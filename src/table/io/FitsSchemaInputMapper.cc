@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <cctype>
@@ -18,6 +19,7 @@
 #include "lsst/log/Log.h"
 #include "lsst/geom.h"
 #include "lsst/afw/table/io/FitsSchemaInputMapper.h"
+#include "lsst/afw/table/io/detail/FitsElements.h"
 #include "lsst/afw/table/aggregates.h"
 
 namespace lsst {
@@ -92,7 +94,15 @@ public:
     std::unique_ptr<bool[]> flagWorkspace;
     std::shared_ptr<io::InputArchive> archive;
     InputContainer inputs;
+    std::function<bool(std::string const &)> selection;  // which regular fields to read; all if empty
     std::size_t nRowsToPrep = 1;
+    std::size_t nRawRowsToPrep = 1;  // nRowsToPrep when reading raw rows, which include unselected columns
+    std::size_t preppedFirstRow = 0;  // the rows most recently passed to the readers' prepRead[Rows]
+    std::size_t preppedEndRow = 0;
+    bool checkedRows = false;        // whether rowBlock.columnOffsets has been read from the file
+    bool canReadRows = false;        // whether blocks of rows are read as raw bytes
+    FitsRowBlock rowBlock;           // the rows most recently read as raw bytes
+    std::vector<char> rowBuffer;     // storage for rowBlock
 };
 
 std::size_t FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = 1 << 15;  // determined empirically; see DM-19461.
@@ -361,12 +371,64 @@ void FitsSchemaInputMapper::erase(int column) {
 
 void erase(int column);
 
+void FitsSchemaInputMapper::select(std::function<bool(std::string const &)> predicate) {
+    _impl->selection = std::move(predicate);
+}
+
 void FitsSchemaInputMapper::customize(std::unique_ptr<FitsColumnReader> reader) {
     _impl->readers.push_back(std::move(reader));
 }
 
 namespace {
 
+using detail::decodeElements;
+
+// The TFORM type code of the columns whose raw values decodeElements<T> decodes; other columns need
+// the conversions cfitsio does when they are read with readTableArray
+template <typename T>
+struct RawColumnType;
+template <>
+struct RawColumnType<std::uint8_t> {
+    static char const CODE = 'B';
+};
+template <>
+struct RawColumnType<std::uint16_t> {
+    static char const CODE = 'I';
+};
+template <>
+struct RawColumnType<std::int32_t> {
+    static char const CODE = 'J';
+};
+template <>
+struct RawColumnType<std::int64_t> {
+    static char const CODE = 'K';
+};
+template <>
+struct RawColumnType<float> {
+    static char const CODE = 'E';
+};
+template <>
+struct RawColumnType<double> {
+    static char const CODE = 'D';
+};
+
+// Return whether a column's values can be decoded from raw rows with the given layout as nElements
+// values of exactly the given TFORM type code
+bool isRawColumn(FitsRowBlock const &layout, int column, char typeCode, std::size_t nElements) {
+    return column >= 0 && static_cast<std::size_t>(column) < layout.columnOffsets.size() &&
+           layout.columnOffsets[column] >= 0 && layout.columnFormats.size() == layout.columnOffsets.size() &&
+           layout.columnFormats[column] == std::make_pair(typeCode, nElements);
+}
+
+// Return the position of a column's values in the first row of a block, or nullptr if they can't be
+// decoded from the raw bytes (see isRawColumn)
+char const *findColumn(FitsRowBlock const &block, int column, char typeCode, std::size_t nElements) {
+    if (!isRawColumn(block, column, typeCode, nElements)) {
+        return nullptr;
+    }
+    return block.data + block.columnOffsets[column];
+}
+
 template <typename T>
 class StandardReader : public FitsColumnReader {
 public:
@@ -392,22 +454,43 @@ public:
         }
     }
 
+    void prepReadRows(FitsRowBlock const &block, fits::Fits &fits) override {
+        std::size_t const nElements = _key.getElementCount();
+        char const *values = findColumn(block, _column, RawColumnType<Element>::CODE, nElements);
+        if (!values) {
+            prepRead(block.firstRow, block.nRows, fits);
+            return;
+        }
+        // Unlike prepRead, this can cache array-valued columns too, as the rows are already in order
+        _cache.resize(block.nRows * nElements);
+        _cacheFirstRow = block.firstRow;
+        for (std::size_t i = 0; i < block.nRows; ++i, values += block.rowSize) {
+            decodeElements(values, nElements, &_cache[i * nElements]);
+        }
+    }
+
+    bool canReadRows(FitsRowBlock const &layout) const override {
+        return isRawColumn(layout, _column, RawColumnType<Element>::CODE, _key.getElementCount());
+    }
+
     void readCell(BaseRecord &record, std::size_t row, afw::fits::Fits &fits,
                   std::shared_ptr<InputArchive> const &archive) const override {
         if (_cache.empty()) {
             fits.readTableArray(row, _column, _key.getElementCount(), record.getElement(_key));
         } else {
             assert(row >= _cacheFirstRow);
-            std::size_t offset = row - _cacheFirstRow;
+            std::size_t offset = (row - _cacheFirstRow) * _key.getElementCount();
             assert(offset < _cache.size());
             std::copy_n(_cache.begin() + offset, _key.getElementCount(), record.getElement(_key));
         }
     }
 
 private:
+    typedef typename FieldBase<T>::Element Element;
+
     int _column;
     Key<T> _key;
-    std::vector<typename FieldBase<T>::Element> _cache;
+    std::vector<Element> _cache;
     std::size_t _cacheFirstRow;
     std::size_t _nRowsToPrep;
 };
@@ -439,6 +522,23 @@ public:
         fits.readTableArray(firstRow, _column, nRows, &_cache.front());
     }
 
+    void prepReadRows(FitsRowBlock const &block, fits::Fits &fits) override {
+        char const *values = findColumn(block, _column, RawColumnType<double>::CODE, 1);
+        if (!values) {
+            prepRead(block.firstRow, block.nRows, fits);
+            return;
+        }
+        _cache.resize(block.nRows);
+        _cacheFirstRow = block.firstRow;
+        for (std::size_t i = 0; i < block.nRows; ++i, values += block.rowSize) {
+            decodeElements(values, 1, &_cache[i]);
+        }
+    }
+
+    bool canReadRows(FitsRowBlock const &layout) const override {
+        return isRawColumn(layout, _column, RawColumnType<double>::CODE, 1);
+    }
+
     void readCell(BaseRecord &record, std::size_t row, afw::fits::Fits &fits,
                   std::shared_ptr<InputArchive> const &archive) const override {
         if (_cache.empty()) {
@@ -605,14 +705,14 @@ public:
             : _column(item.column),
               _size(names.size()),
               _key(CovarianceMatrixKey<T, N>::addFields(schema, item.ttype, names, guessUnits(item.tunit))),
-              _buffer(new T[detail::computeCovariancePackedSize(names.size())]) {}
+              _buffer(new T[table::detail::computeCovariancePackedSize(names.size())]) {}
 
     void readCell(BaseRecord &record, std::size_t row, afw::fits::Fits &fits,
                   std::shared_ptr<InputArchive> const &archive) const override {
-        fits.readTableArray(row, _column, detail::computeCovariancePackedSize(_size), _buffer.get());
+        fits.readTableArray(row, _column, table::detail::computeCovariancePackedSize(_size), _buffer.get());
         for (int i = 0; i < _size; ++i) {
             for (int j = i; j < _size; ++j) {
-                _key.setElement(record, i, j, _buffer[detail::indexCovariance(i, j)]);
+                _key.setElement(record, i, j, _buffer[table::detail::indexCovariance(i, j)]);
             }
         }
     }
@@ -846,6 +946,9 @@ Schema FitsSchemaInputMapper::finalize() {
         }
     }
     for (auto iter = _impl->asList().begin(); iter != _impl->asList().end(); ++iter) {
+        if (_impl->selection && !_impl->selection(iter->ttype)) {
+            continue;
+        }
         if (iter->bit < 0) {  // not a Flag column
             std::unique_ptr<FitsColumnReader> reader = makeColumnReader(_impl->schema, *iter);
             if (reader) {
@@ -866,6 +969,10 @@ Schema FitsSchemaInputMapper::finalize() {
         }
     }
     _impl->asList().clear();
+    if (std::none_of(_impl->flagKeys.begin(), _impl->flagKeys.end(),
+                     [](Key<Flag> const &key) { return key.isValid(); })) {
+        _impl->flagKeys.clear();  // no need to read the flag column at all
+    }
     if (_impl->schema.getRecordSize() <= 0) {
         throw LSST_EXCEPT(
             pex::exceptions::LengthError,
@@ -878,18 +985,69 @@ Schema FitsSchemaInputMapper::finalize() {
 }
 
 void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits, std::size_t row) {
-    if (!_impl->flagKeys.empty()) {
-        fits.readTableArray<bool>(row, _impl->flagColumn, _impl->flagKeys.size(), _impl->flagWorkspace.get());
-        for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
-            record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+    FitsRowBlock &block = _impl->rowBlock;
+    if (_impl->nRowsToPrep != 1 && (row < _impl->preppedFirstRow || row >= _impl->preppedEndRow)) {
+        if (!_impl->checkedRows) {
+            block.columnOffsets = fits.getTableColumnOffsets();
+            block.columnFormats = fits.getTableColumnFormats();
+            block.rowSize = fits.getTableRowSize();
+            // Read whole rows at once only if the flags or the columns of the selected fields can be
+            // decoded from them; otherwise the readers would read the same rows again with cfitsio
+            _impl->canReadRows =
+                    block.rowSize > 0 &&
+                    ((!_impl->flagKeys.empty() &&
+                      isRawColumn(block, _impl->flagColumn, 'X', _impl->flagKeys.size())) ||
+                     std::any_of(_impl->readers.begin(), _impl->readers.end(),
+                                 [&block](std::unique_ptr<FitsColumnReader> const &reader) {
+                                     return reader->canReadRows(block);
+                                 }));
+            if (_impl->canReadRows) {
+                // The row buffer holds whole rows, so size blocks by the rows on disk, not the
+                // (possibly much smaller) records of a selection of the fields
+                _impl->nRawRowsToPrep = std::max(PREPPED_ROWS_FACTOR / block.rowSize, std::size_t(1));
+            }
+            _impl->checkedRows = true;
         }
-    }
-    if (_impl->nRowsToPrep != 1 && row % _impl->nRowsToPrep == 0) {
         // Give readers a chance to read and cache up to nRowsToPrep rows-
         // worth of values.
-        std::size_t size = std::min(_impl->nRowsToPrep, fits.countRows() - row);
-        for (auto & reader : _impl->readers) {
-            reader->prepRead(row, size, fits);
+        std::size_t const nRowsToPrep = _impl->canReadRows ? _impl->nRawRowsToPrep : _impl->nRowsToPrep;
+        std::size_t size = std::min(nRowsToPrep, fits.countRows() - row);
+        _impl->preppedFirstRow = row;
+        _impl->preppedEndRow = row + size;
+        if (_impl->canReadRows) {
+            _impl->rowBuffer.resize(size * block.rowSize);
+            fits.readTableBytes(row, _impl->rowBuffer.size(), _impl->rowBuffer.data());
+            block.firstRow = row;
+            block.nRows = size;
+            block.data = _impl->rowBuffer.data();
+            for (auto &reader : _impl->readers) {
+                reader->prepReadRows(block, fits);
+            }
+        } else {
+            for (auto &reader : _impl->readers) {
+                reader->prepRead(row, size, fits);
+            }
+        }
+    }
+    if (!_impl->flagKeys.empty()) {
+        char const *flags =
+                block.data ? findColumn(block, _impl->flagColumn, 'X', _impl->flagKeys.size()) : nullptr;
+        if (flags && row >= block.firstRow && row < block.firstRow + block.nRows) {
+            // Flags are packed into bits, the first in the most significant bit of the first byte
+            flags += (row - block.firstRow) * block.rowSize;
+            for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
+                if (_impl->flagKeys[bit].isValid()) {
+                    record.set(_impl->flagKeys[bit], (flags[bit / 8] & (0x80 >> (bit % 8))) != 0);
+                }
+            }
+        } else {
+            fits.readTableArray<bool>(row, _impl->flagColumn, _impl->flagKeys.size(),
+                                      _impl->flagWorkspace.get());
+            for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
+                if (_impl->flagKeys[bit].isValid()) {
+                    record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+                }
+            }
         }
     }
     for (auto const & reader : _impl->readers) {
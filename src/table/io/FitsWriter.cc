@@ -1,8 +1,13 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "lsst/afw/table/io/FitsWriter.h"
+#include "lsst/afw/table/io/detail/FitsElements.h"
 #include "lsst/afw/table/BaseTable.h"
 #include "lsst/afw/table/BaseRecord.h"
 
@@ -130,13 +135,68 @@ void FitsWriter::_writeTable(std::shared_ptr<BaseTable const> const& table, std:
 // The driver code is at the bottom of this section; it's easier to understand if you start there
 // and work your way up.
 
+namespace {
+
+// Size of the buffer used to write many rows with one cfitsio call, in bytes
+std::size_t const ROW_BUFFER_SIZE = 1 << 20;
+
+using detail::encodeElements;
+
+// Strings are written up to their first null, and padded with nulls
+char* encodeElements(char const* in, std::size_t nElements, char* out) {
+    char const* end = std::find(in, in + nElements, '\0');
+    std::fill(std::copy(in, end, out), out + nElements, '\0');
+    return out + nElements;
+}
+
+// A Schema::forEach functor that computes the number of bytes in a FITS row, excluding the Flag column,
+// and whether all fields have a fixed size (variable-length fields are stored in the FITS heap).
+struct ComputeRowSize {
+    template <typename T>
+    void operator()(SchemaItem<T> const& item) const {
+        rowSize += item.key.getElementCount() * sizeof(typename Field<T>::Element);
+    }
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const& item) const {
+        if (item.key.isVariableLength()) {
+            isFixedSize = false;
+        } else {
+            rowSize += item.key.getElementCount() * sizeof(T);
+        }
+    }
+
+    void operator()(SchemaItem<std::string> const& item) const {
+        if (item.key.isVariableLength()) {
+            isFixedSize = false;
+        } else {
+            rowSize += item.key.getElementCount();
+        }
+    }
+
+    void operator()(SchemaItem<Flag> const& item) const {}
+
+    mutable std::size_t rowSize;
+    mutable bool isFixedSize;
+};
+
+}  // namespace
+
 // A Schema::forEach functor that writes table data for a single record when it is called.
 // We instantiate one of these, then reuse it on all the records after updating the data
 // members that tell it which record and row number it's on.
+//
+// When all fields have a fixed size, records are instead converted to FITS rows in a buffer, which is
+// written with a single cfitsio call when it is full and by flush(); this avoids one cfitsio call per
+// field per row, which dominates the time to write large catalogs.
 struct FitsWriter::ProcessRecords {
     template <typename T>
     void operator()(SchemaItem<T> const& item) const {
-        fits->writeTableArray(row, col, item.key.getElementCount(), record->getElement(item.key));
+        if (out) {
+            out = encodeElements(record->getElement(item.key), item.key.getElementCount(), out);
+        } else {
+            fits->writeTableArray(row, col, item.key.getElementCount(), record->getElement(item.key));
+        }
         ++col;
     }
 
@@ -145,6 +205,8 @@ struct FitsWriter::ProcessRecords {
         if (item.key.isVariableLength()) {
             ndarray::Array<T const, 1, 1> array = record->get(item.key);
             fits->writeTableArray(row, col, array.template getSize<0>(), array.getData());
+        } else if (out) {
+            out = encodeElements(record->getElement(item.key), item.key.getElementCount(), out);
         } else {
             fits->writeTableArray(row, col, item.key.getElementCount(), record->getElement(item.key));
         }
@@ -152,8 +214,12 @@ struct FitsWriter::ProcessRecords {
     }
 
     void operator()(SchemaItem<std::string> const& item) const {
-        // Write fixed-length and variable-length strings the same way
-        fits->writeTableScalar(row, col, record->get(item.key));
+        if (out) {
+            out = encodeElements(record->getElement(item.key), item.key.getElementCount(), out);
+        } else {
+            // Write fixed-length and variable-length strings the same way
+            fits->writeTableScalar(row, col, record->get(item.key));
+        }
         ++col;
     }
 
@@ -163,8 +229,27 @@ struct FitsWriter::ProcessRecords {
     }
 
     ProcessRecords(Fits* fits_, Schema const& schema_, int nFlags_, std::size_t const& row_)
-            : row(row_), col(0), bit(0), nFlags(nFlags_), fits(fits_), schema(schema_) {
+            : row(row_),
+              col(0),
+              bit(0),
+              nFlags(nFlags_),
+              fits(fits_),
+              record(nullptr),
+              schema(schema_),
+              rowSize(0),
+              firstRow(0),
+              nRows(0),
+              out(nullptr) {
         if (nFlags) flags.reset(new bool[nFlags]);
+        ComputeRowSize f = {static_cast<std::size_t>((nFlags + 7) / 8), true};
+        schema.forEach(f);
+        // Check the layout against the table's actual row size before relying on it
+        long naxis1 = 0;
+        fits->readKey("NAXIS1", naxis1);
+        if (f.isFixedSize && f.rowSize > 0 && static_cast<std::size_t>(naxis1) == f.rowSize) {
+            rowSize = f.rowSize;
+            buffer.resize(std::max(ROW_BUFFER_SIZE / rowSize, std::size_t(1)) * rowSize);
+        }
     }
 
     void apply(BaseRecord const* r) {
@@ -172,8 +257,34 @@ struct FitsWriter::ProcessRecords {
         col = 0;
         bit = 0;
         if (nFlags) ++col;
-        schema.forEach(*this);
-        if (nFlags) fits->writeTableArray(row, 0, nFlags, flags.get());
+        if (rowSize) {
+            if (nRows == 0) {
+                firstRow = row;
+            }
+            char* rowBegin = buffer.data() + nRows * rowSize;
+            out = rowBegin + (nFlags + 7) / 8;
+            schema.forEach(*this);
+            out = nullptr;
+            // Pack the flags into bits, the first in the most significant bit of the first byte
+            std::fill(rowBegin, rowBegin + (nFlags + 7) / 8, 0);
+            for (int i = 0; i < nFlags; ++i) {
+                if (flags[i]) rowBegin[i / 8] |= static_cast<char>(0x80 >> (i % 8));
+            }
+            if (++nRows * rowSize == buffer.size()) {
+                flush();
+            }
+        } else {
+            schema.forEach(*this);
+            if (nFlags) fits->writeTableArray(row, 0, nFlags, flags.get());
+        }
+    }
+
+    // Write any rows still in the buffer
+    void flush() {
+        if (nRows > 0) {
+            fits->writeTableBytes(firstRow, nRows * rowSize, buffer.data());
+            nRows = 0;
+        }
     }
 
     std::size_t const& row;
@@ -184,12 +295,22 @@ struct FitsWriter::ProcessRecords {
     std::unique_ptr<bool[]> flags;
     BaseRecord const* record;
     Schema schema;
+    std::size_t rowSize;       // bytes per FITS row if rows are buffered, or zero
+    std::vector<char> buffer;  // FITS rows waiting to be written
+    std::size_t firstRow;      // row number of the first row in the buffer
+    std::size_t nRows;         // number of rows in the buffer
+    mutable char* out;         // where the next field is converted to, while converting a record
 };
 
 void FitsWriter::_writeRecord(BaseRecord const& record) {
     ++_row;
     _processor->apply(&record);
 }
+
+void FitsWriter::_flushRecords() {
+    if (_processor) _processor->flush();
+}
+
 }  // namespace io
 }  // namespace table
 }  // namespace afw
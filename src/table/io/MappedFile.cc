@@ -0,0 +1,336 @@
+// -*- lsst-c++ -*-
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "boost/format.hpp"
+#include "boost/preprocessor/seq/for_each.hpp"
+#include "boost/preprocessor/tuple/to_seq.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/table/AliasMap.h"
+#include "lsst/afw/table/io/MappedFile.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace io {
+
+namespace {
+
+char const MAGIC[8] = {'A', 'F', 'W', 'T', 'A', 'B', 'L', 'E'};
+std::uint32_t const BYTE_ORDER_MARK = 0x01020304;
+std::uint32_t const VERSION = 2;
+std::size_t const DATA_ALIGNMENT = 4096;  // records start on a page boundary
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t byteOrder;
+    std::uint32_t version;
+    std::uint64_t recordSize;
+    std::uint64_t nRecords;
+    std::uint64_t schemaSize;  // size of the schema description that follows the header
+    std::uint64_t dataOffset;  // position of the first record
+    std::int64_t maxId;        // largest value of the "id" field, or 0 if there is no such field
+};
+
+// A field as it is described in the file.
+struct FieldDescription {
+    std::string type;
+    std::string name;
+    std::string doc;
+    std::string units;
+    std::int32_t size;  // element count of sized fields (strings and arrays); -1 for others
+    std::int32_t offset;
+    std::int32_t bit;  // bit of Flag fields; -1 for others
+};
+
+template <typename T>
+std::int32_t getFieldSize(FieldBase<T> const &) {
+    return -1;
+}
+
+template <typename T>
+std::int32_t getFieldSize(FieldBase<Array<T>> const &base) {
+    return base.getElementCount();
+}
+
+std::int32_t getFieldSize(FieldBase<std::string> const &base) { return base.getElementCount(); }
+
+template <typename T>
+std::int32_t getKeyBit(Key<T> const &) {
+    return -1;
+}
+
+std::int32_t getKeyBit(Key<Flag> const &key) { return key.getBit(); }
+
+// Schema functor that appends a description of each field to a buffer.
+class SchemaDescriber {
+public:
+    explicit SchemaDescriber(std::string &buffer) : _buffer(buffer) {}
+
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        std::int32_t size = getFieldSize(item.field);
+        if (size == 0) {
+            throw LSST_EXCEPT(
+                    pex::exceptions::LogicError,
+                    (boost::format("Variable-length field '%s' cannot be written to a mapped file.") %
+                     item.field.getName())
+                            .str());
+        }
+        putString(item.field.getTypeString());
+        putString(item.field.getName());
+        putString(item.field.getDoc());
+        putString(item.field.getUnits());
+        put(size);
+        put<std::int32_t>(item.key.getOffset());
+        put(getKeyBit(item.key));
+    }
+
+    template <typename T>
+    void put(T value) const {
+        _buffer.append(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    void putString(std::string const &value) const {
+        put<std::uint64_t>(value.size());
+        _buffer.append(value);
+    }
+
+private:
+    std::string &_buffer;
+};
+
+// Reads back what SchemaDescriber wrote, checking that it does not run past the end of the description.
+class DescriptionReader {
+public:
+    DescriptionReader(std::string const &filename, char const *begin, char const *end)
+            : _filename(filename), _next(begin), _end(end) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string getString() {
+        std::uint64_t size = get<std::uint64_t>();
+        return std::string(take(size), size);
+    }
+
+    FieldDescription getField() {
+        FieldDescription field;
+        field.type = getString();
+        field.name = getString();
+        field.doc = getString();
+        field.units = getString();
+        field.size = get<std::int32_t>();
+        field.offset = get<std::int32_t>();
+        field.bit = get<std::int32_t>();
+        return field;
+    }
+
+private:
+    char const *take(std::size_t size) {
+        if (static_cast<std::size_t>(_end - _next) < size) {
+            throw LSST_EXCEPT(pex::exceptions::IoError,
+                              (boost::format("Schema description in mapped file '%s' is truncated.") %
+                               _filename)
+                                      .str());
+        }
+        char const *result = _next;
+        _next += size;
+        return result;
+    }
+
+    std::string const &_filename;
+    char const *_next;
+    char const *_end;
+};
+
+template <typename T>
+bool addField(Schema &schema, FieldDescription const &field) {
+    FieldBase<T> base = field.size < 0 ? FieldBase<T>() : FieldBase<T>(field.size);
+    Key<T> key = schema.addField<T>(field.name, field.doc, field.units, base);
+    return key.getOffset() == field.offset && getKeyBit(key) == field.bit;
+}
+
+// Add a field to the schema, returning false if it was not added with the layout it had when written.
+bool addField(Schema &schema, FieldDescription const &field, std::string const &filename) {
+#define ADD_FIELD_OF_TYPE(r, data, elem) \
+    if (field.type == Field<elem>::getTypeString()) return addField<elem>(schema, field);
+
+    BOOST_PP_SEQ_FOR_EACH(ADD_FIELD_OF_TYPE, _,
+                          BOOST_PP_TUPLE_TO_SEQ(AFW_TABLE_FIELD_TYPE_N, AFW_TABLE_FIELD_TYPE_TUPLE))
+
+#undef ADD_FIELD_OF_TYPE
+    throw LSST_EXCEPT(pex::exceptions::IoError,
+                      (boost::format("Field '%s' in mapped file '%s' has unknown type '%s'.") % field.name %
+                       filename % field.type)
+                              .str());
+}
+
+[[noreturn]] void throwIoError(std::string const &message, std::string const &filename, int error) {
+    throw LSST_EXCEPT(pex::exceptions::IoError,
+                      (boost::format("%s '%s': %s") % message % filename % std::strerror(error)).str());
+}
+
+// Keeps a memory-mapped file alive for as long as there are records or arrays that refer to it.
+class Mapping : public ndarray::Manager {
+public:
+    typedef boost::intrusive_ptr<Mapping> Ptr;
+
+    Mapping(void *address, std::size_t size) : _address(address), _size(size) {}
+
+    char *getAddress() const { return reinterpret_cast<char *>(_address); }
+
+    ~Mapping() { ::munmap(_address, _size); }
+
+private:
+    void *_address;
+    std::size_t _size;
+};
+
+}  // namespace
+
+void MappedFile::_write(std::string const &filename, Schema const &schema,
+                        std::vector<BaseRecord const *> const &records) {
+    std::string description;
+    SchemaDescriber describer(description);
+    describer.put<std::uint64_t>(schema.getFieldCount());
+    schema.forEach(describer);
+    describer.put<std::uint64_t>(schema.getAliasMap()->size());
+    for (auto const &alias : *schema.getAliasMap()) {
+        describer.putString(alias.first);
+        describer.putString(alias.second);
+    }
+
+    // Save the largest ID, so readers can seed IdFactories without looking at every record
+    RecordId maxId = 0;
+    try {
+        Key<RecordId> const idKey = schema.find<RecordId>("id").key;
+        if (!records.empty()) {
+            maxId = records.front()->get(idKey);
+        }
+        for (BaseRecord const *record : records) {
+            maxId = std::max(maxId, record->get(idKey));
+        }
+    } catch (pex::exceptions::NotFoundError const &) {
+        // no ID field; leave maxId at 0
+    } catch (pex::exceptions::TypeError const &) {
+        // an "id" field that isn't a RecordId can't be used by an IdFactory either
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.recordSize = schema.getRecordSize();
+    header.nRecords = records.size();
+    header.schemaSize = description.size();
+    std::size_t const descriptionEnd = sizeof(FileHeader) + description.size();
+    header.dataOffset = (descriptionEnd + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    header.maxId = maxId;
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const *>(&header), sizeof(FileHeader));
+    out.write(description.data(), description.size());
+    std::string const padding(header.dataOffset - descriptionEnd, '\0');
+    out.write(padding.data(), padding.size());
+    for (BaseRecord const *record : records) {
+        out.write(reinterpret_cast<char const *>(record->_data), header.recordSize);
+    }
+    out.close();
+    if (!out) {
+        throwIoError("Could not write mapped file", filename, errno);
+    }
+}
+
+MappedFile::Contents MappedFile::_map(std::string const &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throwIoError("Could not open mapped file", filename, errno);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        int const error = errno;
+        ::close(fd);
+        throwIoError("Could not stat mapped file", filename, error);
+    }
+    std::size_t const fileSize = status.st_size;
+    if (fileSize < sizeof(FileHeader)) {
+        ::close(fd);
+        throw LSST_EXCEPT(pex::exceptions::IoError,
+                          (boost::format("File '%s' is too small to be a mapped file.") % filename).str());
+    }
+    // Map privately, so records can still be modified without the changes reaching the file (or
+    // other processes); pages that are never written stay shared with the page cache.
+    void *address = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int const error = errno;
+    ::close(fd);  // the mapping stays valid after the file is closed
+    if (address == MAP_FAILED) {
+        throwIoError("Could not map file", filename, error);
+    }
+    Mapping::Ptr mapping(new Mapping(address, fileSize));
+
+    FileHeader header;
+    std::memcpy(&header, mapping->getAddress(), sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw LSST_EXCEPT(pex::exceptions::IoError,
+                          (boost::format("File '%s' is not a mapped afw.table file.") % filename).str());
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK || header.version != VERSION) {
+        throw LSST_EXCEPT(
+                pex::exceptions::IoError,
+                (boost::format("Mapped file '%s' was written on a machine with a different byte order, or "
+                               "by an unsupported version (%d).") %
+                 filename % header.version)
+                        .str());
+    }
+    if (header.dataOffset < sizeof(FileHeader) + header.schemaSize || header.dataOffset > fileSize ||
+        (header.recordSize > 0 && (fileSize - header.dataOffset) / header.recordSize < header.nRecords)) {
+        throw LSST_EXCEPT(pex::exceptions::IoError,
+                          (boost::format("Mapped file '%s' is truncated.") % filename).str());
+    }
+
+    char const *descriptionBegin = mapping->getAddress() + sizeof(FileHeader);
+    DescriptionReader reader(filename, descriptionBegin, descriptionBegin + header.schemaSize);
+    Schema schema;
+    std::uint64_t const nFields = reader.get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < nFields; ++i) {
+        if (!addField(schema, reader.getField(), filename)) {
+            _throwLayoutMismatch(filename);
+        }
+    }
+    std::uint64_t const nAliases = reader.get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < nAliases; ++i) {
+        std::string alias = reader.getString();
+        schema.getAliasMap()->set(alias, reader.getString());
+    }
+    return Contents{schema, static_cast<std::size_t>(header.recordSize),
+                    static_cast<std::size_t>(header.nRecords), mapping->getAddress() + header.dataOffset,
+                    mapping, header.maxId};
+}
+
+void MappedFile::_throwLayoutMismatch(std::string const &filename) {
+    throw LSST_EXCEPT(pex::exceptions::IoError,
+                      (boost::format("The record layout in mapped file '%s' does not match the layout of "
+                                     "its schema in this version of afw.") %
+                       filename)
+                              .str());
+}
+
+}  // namespace io
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
@@ -383,6 +383,171 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(
                 convControl.getMaxInterpolationDistance(), maxInterpDist)
 
+        self.assertEqual(convControl.getFftMinKernelSize(), 15)
+        for fftMinKernelSize in (0, 1, 21):
+            convControl.setFftMinKernelSize(fftMinKernelSize)
+            self.assertEqual(convControl.getFftMinKernelSize(), fftMinKernelSize)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            convControl.setFftMinKernelSize(-1)
+
+        self.assertEqual(convControl.getLinearCombinationAlgorithm(),
+                         afwMath.ConvolutionControl.KERNEL_IMAGES)
+        for algorithm in (afwMath.ConvolutionControl.BASIS_IMAGES, afwMath.ConvolutionControl.KERNEL_IMAGES):
+            convControl.setLinearCombinationAlgorithm(algorithm)
+            self.assertEqual(convControl.getLinearCombinationAlgorithm(), algorithm)
+
+        self.assertEqual(convControl.getNumThreads(), 1)
+        for numThreads in (0, 1, 4):
+            convControl.setNumThreads(numThreads)
+            self.assertEqual(convControl.getNumThreads(), numThreads)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            convControl.setNumThreads(-1)
+
+    def testFftConvolve(self):
+        """Test that convolving with large kernels using FFTs matches real-space convolution
+        """
+        width, height = 300, 280  # large enough for several FFT tiles
+        maskedImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(300, 200),
+                                                            lsst.geom.Extent2I(width, height)))
+        rng = numpy.random.RandomState(5)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, (height, width))
+        maskedImage.variance.array[:] = rng.uniform(1.0, 2.0, (height, width))
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=(height, width)) < 0.01, 0x4, 0x0)
+
+        kWidth, kHeight = 21, 19
+        kImArr = numpy.zeros([kHeight, kWidth])
+        kImArr[:, 2:-3] = rng.uniform(0.5, 1.0, (kHeight, kWidth - 5))
+        kImArr[5, 7:9] = 0.0  # a hole, which mustn't smear the mask
+        fixedKernel = afwMath.FixedKernel(afwImage.makeImageFromArray(kImArr))
+
+        sFunc = afwMath.PolynomialFunction2D(1)
+        basisKernelList = makeGaussianKernelList(kWidth, kHeight, ((3.5, 3.5, 0.0), (5.5, 3.5, 0.5)))
+        lcKernel = afwMath.LinearCombinationKernel(basisKernelList, sFunc)
+        lcKernel.setSpatialParameters(((1.0, -0.1/width, -0.1/height), (0.0, 1.0/width, 0.5/height)))
+
+        realControl = afwMath.ConvolutionControl()
+        realControl.setFftMinKernelSize(0)
+        realControl.setMaxInterpolationDistance(0)
+        fftControl = afwMath.ConvolutionControl()
+        fftControl.setFftMinKernelSize(kHeight)
+        for kernel in (fixedKernel, lcKernel):
+            for doNormalize in (False, True):
+                realControl.setDoNormalize(doNormalize)
+                fftControl.setDoNormalize(doNormalize)
+                expected = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(expected, maskedImage, kernel, realControl)
+                convolved = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(convolved, maskedImage, kernel, fftControl)
+                self.assertMaskedImagesAlmostEqual(convolved, expected, rtol=1e-5, atol=1e-4)
+
+                convolvedImage = afwImage.ImageF(maskedImage.getBBox())
+                afwMath.convolve(convolvedImage, maskedImage.image, kernel, fftControl)
+                self.assertImagesAlmostEqual(convolvedImage, expected.image, rtol=1e-5, atol=1e-4)
+
+        # non-finite pixels must not be spread over a whole FFT tile
+        maskedImage.image[150, 140, afwImage.LOCAL] = numpy.nan
+        afwMath.convolve(convolved, maskedImage, fixedKernel, fftControl)
+        afwMath.convolve(expected, maskedImage, fixedKernel, realControl)
+        self.assertMaskedImagesAlmostEqual(convolved, expected, rtol=1e-5, atol=1e-4)
+
+    def testBasisConvolve(self):
+        """Test that convolving with basis images matches convolving with kernel images
+        """
+        width, height = 70, 90
+        maskedImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(-20, 35),
+                                                            lsst.geom.Extent2I(width, height)))
+        rng = numpy.random.RandomState(7)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, (height, width))
+        maskedImage.variance.array[:] = rng.uniform(1.0, 2.0, (height, width))
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=(height, width)) < 0.01, 0x4, 0x0)
+
+        kWidth, kHeight = 5, 7
+        sFunc = afwMath.PolynomialFunction2D(1)
+        gaussKernel = afwMath.LinearCombinationKernel(
+            makeGaussianKernelList(kWidth, kHeight, ((1.5, 1.5, 0.0), (2.5, 1.5, 0.5), (2.5, 2.5, 0.0))),
+            sFunc)
+        gaussKernel.setSpatialParameters(((1.0, -0.5/width, -0.5/height),
+                                          (0.0, 1.0/width, 0.0),
+                                          (0.0, 0.0, 1.0/height)))
+        deltaBasisList = makeDeltaFunctionKernelList(kWidth, kHeight)
+        deltaKernel = afwMath.LinearCombinationKernel(deltaBasisList, sFunc)
+        # leave some basis kernels with zero weight, so the mask footprint is not the whole kernel
+        deltaKernel.setSpatialParameters([(1.0 + i, (i % 3 - 1)/width, 0.0) if i % 4 else (0.0, 0.0, 0.0)
+                                          for i in range(len(deltaBasisList))])
+
+        kernelControl = afwMath.ConvolutionControl()
+        kernelControl.setMaxInterpolationDistance(0)
+        kernelControl.setFftMinKernelSize(0)
+        basisControl = afwMath.ConvolutionControl()
+        basisControl.setLinearCombinationAlgorithm(afwMath.ConvolutionControl.BASIS_IMAGES)
+        for kernel in (gaussKernel, deltaKernel):
+            for doNormalize in (False, True):
+                kernelControl.setDoNormalize(doNormalize)
+                basisControl.setDoNormalize(doNormalize)
+                expected = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(expected, maskedImage, kernel, kernelControl)
+                for numThreads in (1, 3):
+                    basisControl.setNumThreads(numThreads)
+                    convolved = afwImage.MaskedImageF(maskedImage.getBBox())
+                    afwMath.convolve(convolved, maskedImage, kernel, basisControl)
+                    self.assertMaskedImagesAlmostEqual(convolved, expected, rtol=1e-5, atol=1e-4)
+
+                    convolvedImage = afwImage.ImageF(maskedImage.getBBox())
+                    afwMath.convolve(convolvedImage, maskedImage.image, kernel, basisControl)
+                    self.assertImagesAlmostEqual(convolvedImage, expected.image, rtol=1e-5, atol=1e-4)
+
+    def testMultithreadedConvolve(self):
+        """Test that convolving with several threads gives the same result as with one
+        """
+        width, height = 130, 97
+        maskedImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(15, -40),
+                                                            lsst.geom.Extent2I(width, height)))
+        rng = numpy.random.RandomState(11)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, (height, width))
+        maskedImage.variance.array[:] = rng.uniform(1.0, 2.0, (height, width))
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=(height, width)) < 0.01, 0x4, 0x0)
+
+        sFunc = afwMath.PolynomialFunction2D(1)
+        analyticKernel = afwMath.AnalyticKernel(7, 6, afwMath.GaussianFunction2D(1.0, 1.0, 0.0), sFunc)
+        analyticKernel.setSpatialParameters(((1.5, 1.0/width, 0.0), (1.5, 0.0, 1.0/height), (0.0, 0.0, 0.0)))
+        separableKernel = afwMath.SeparableKernel(5, 9, afwMath.GaussianFunction1D(1.0),
+                                                  afwMath.GaussianFunction1D(2.0))
+        varyingSeparableKernel = afwMath.SeparableKernel(5, 9, afwMath.GaussianFunction1D(1.0),
+                                                         afwMath.GaussianFunction1D(2.0), sFunc)
+        varyingSeparableKernel.setSpatialParameters(((1.0, 0.5/width, 0.0), (2.0, 0.0, -0.5/height)))
+        lcKernel = afwMath.LinearCombinationKernel(
+            makeGaussianKernelList(9, 9, ((1.5, 1.5, 0.0), (2.5, 1.5, 0.5))), sFunc)
+        lcKernel.setSpatialParameters(((1.0, -0.5/width, -0.5/height), (0.0, 1.0/width, 0.5/height)))
+        fixedKernel = afwMath.FixedKernel(afwImage.ImageD(lsst.geom.Extent2I(21, 17), 1.0))
+
+        for kernel in (analyticKernel, separableKernel, varyingSeparableKernel, lcKernel, fixedKernel):
+            for maxInterpDist in (0, 10):
+                control = afwMath.ConvolutionControl()
+                control.setMaxInterpolationDistance(maxInterpDist)
+                control.setFftMinKernelSize(0)
+                expected = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(expected, maskedImage, kernel, control)
+                expectedImage = afwImage.ImageF(maskedImage.getBBox())
+                afwMath.convolve(expectedImage, maskedImage.image, kernel, control)
+                for numThreads in (2, 5, 0):
+                    control.setNumThreads(numThreads)
+                    convolved = afwImage.MaskedImageF(maskedImage.getBBox())
+                    afwMath.convolve(convolved, maskedImage, kernel, control)
+                    self.assertMaskedImagesEqual(convolved, expected)
+                    convolvedImage = afwImage.ImageF(maskedImage.getBBox())
+                    afwMath.convolve(convolvedImage, maskedImage.image, kernel, control)
+                    self.assertImagesEqual(convolvedImage, expectedImage)
+
+        # FFTs are computed in different tiles for each band, so only agree to roundoff
+        control = afwMath.ConvolutionControl()
+        control.setFftMinKernelSize(15)
+        expected = afwImage.MaskedImageF(maskedImage.getBBox())
+        afwMath.convolve(expected, maskedImage, fixedKernel, control)
+        control.setNumThreads(3)
+        convolved = afwImage.MaskedImageF(maskedImage.getBBox())
+        afwMath.convolve(convolved, maskedImage, fixedKernel, control)
+        self.assertMaskedImagesAlmostEqual(convolved, expected, rtol=1e-5, atol=1e-4)
+
     @unittest.skipIf(dataDir is None, "afwdata not setup")
     def testUnityConvolution(self):
         """Verify that convolution with a centered delta function reproduces the original.
@@ -442,6 +607,46 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
             refKernel=analyticKernel,
             kernelDescr="Gaussian Separable Kernel (compared to AnalyticKernel equivalent)")
 
+    def testSeparableConvolveByRows(self):
+        """Test convolving floating-point images with a spatially invariant separable kernel
+
+        The image is wide enough that it is convolved in several blocks of columns.
+        """
+        width, height = 2500, 60
+        maskedImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(-10, 20),
+                                                            lsst.geom.Extent2I(width, height)))
+        rng = numpy.random.RandomState(9)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, (height, width))
+        maskedImage.variance.array[:] = rng.uniform(1.0, 2.0, (height, width))
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=(height, width)) < 0.01, 0x4, 0x0)
+        maskedImage.image[1000, 30, afwImage.LOCAL] = numpy.nan
+
+        bruteControl = afwMath.ConvolutionControl()
+        bruteControl.setFftMinKernelSize(0)
+        separableControl = afwMath.ConvolutionControl()
+        for kWidth, kHeight, func1, func2 in (
+            (9, 31, afwMath.GaussianFunction1D(2.0), afwMath.GaussianFunction1D(6.0)),
+            # a Lanczos kernel, as used by offsetImage, whose x vector is a delta function
+            (7, 7, afwMath.LanczosFunction1D(3), afwMath.LanczosFunction1D(3, 0.3)),
+        ):
+            separableKernel = afwMath.SeparableKernel(kWidth, kHeight, func1, func2)
+            kernelImage = afwImage.ImageD(separableKernel.getDimensions())
+            for doNormalize in (False, True):
+                separableKernel.computeImage(kernelImage, doNormalize)
+                fixedKernel = afwMath.FixedKernel(kernelImage)
+                bruteControl.setDoNormalize(doNormalize)
+                separableControl.setDoNormalize(doNormalize)
+                expected = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(expected, maskedImage, fixedKernel, bruteControl)
+                convolved = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(convolved, maskedImage, separableKernel, separableControl)
+                self.assertMaskedImagesAlmostEqual(convolved, expected, rtol=1e-5, atol=1e-4)
+
+                inImage = maskedImage.image.convertD()
+                convolvedImage = afwImage.ImageD(maskedImage.getBBox())
+                afwMath.convolve(convolvedImage, inImage, separableKernel, separableControl)
+                self.assertImagesAlmostEqual(convolvedImage, expected.image, rtol=1e-5, atol=1e-4)
+
     @unittest.skipIf(dataDir is None, "afwdata not setup")
     def testSpatiallyInvariantConvolve(self):
         """Test convolution with a spatially invariant Gaussian function
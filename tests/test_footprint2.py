@@ -30,6 +30,8 @@ or
 
 import unittest
 
+import numpy as np
+
 import lsst.utils.tests
 import lsst.geom
 import lsst.afw.image as afwImage
@@ -166,6 +168,95 @@ class FootprintSetTestCase(unittest.TestCase):
         for i in range(len(objects)):
             self.assertEqual(objects[i], self.objects[i])
 
+    def testMultithreaded(self):
+        """Check that searching bands of an image in parallel gives the same Footprints,
+        in order of their first span, with the same peaks
+        """
+        np.random.seed(1)
+        mi = afwImage.MaskedImageF(lsst.geom.Extent2I(97, 403))
+        # smooth the noise a little, so that many objects cross the boundaries between bands
+        noise = np.random.normal(0.0, 1.0, size=(405, 99))
+        mi.image.array[:] = sum(noise[dy:dy + 403, dx:dx + 97] for dy in range(3) for dx in range(3))
+        mi.variance.array[:] = 9.0
+        for threshold in (afwDetect.Threshold(2.0), afwDetect.Threshold(1.0, afwDetect.Threshold.PIXEL_STDEV),
+                          afwDetect.Threshold(2.0, afwDetect.Threshold.VALUE, True, 1.5)):
+            ref = afwDetect.FootprintSet(mi, threshold, "", 2).getFootprints()
+            self.assertGreater(len(ref), 100)
+            firstSpans = [next(iter(foot.spans)) for foot in ref]
+            firstSpans = [(span.getY(), span.getX0()) for span in firstSpans]
+            self.assertEqual(firstSpans, sorted(firstSpans))
+            for numThreads in (2, 3, 0):
+                objects = afwDetect.FootprintSet(mi, threshold, "", 2, numThreads=numThreads).getFootprints()
+                self.assertEqual(len(objects), len(ref))
+                for foot, refFoot in zip(objects, ref):
+                    self.assertEqual(foot.spans, refFoot.spans)
+                    self.assertEqual([peak.getI() for peak in foot.peaks],
+                                     [peak.getI() for peak in refFoot.peaks])
+                    self.assertEqual([peak.getPeakValue() for peak in foot.peaks],
+                                     [peak.getPeakValue() for peak in refFoot.peaks])
+                # Peak IDs are assigned in the same order, whatever the number of threads
+                ids = [peak.getId() for foot in objects for peak in foot.peaks]
+                refIds = [peak.getId() for foot in ref for peak in foot.peaks]
+                self.assertEqual([i - min(ids) for i in ids], [i - min(refIds) for i in refIds])
+
+    def testWideRows(self):
+        """Check Footprints with spans that cross, start and end at the boundaries of the 64-pixel
+        words used to skip empty parts of rows, including NaNs and negative thresholds
+        """
+        mi = afwImage.MaskedImageF(lsst.geom.Extent2I(200, 5))
+        mi.variance.array[:] = 4.0
+        spanList = [(1, 60, 70), (1, 127, 128), (2, 63, 63), (2, 64, 64), (3, 0, 199), (4, 190, 199)]
+        for y, x0, x1 in spanList:
+            mi.image.array[y, x0:x1 + 1] = 10.0
+        mi.image.array[3, 100] = np.nan
+        expected = [[(1, 60, 70), (2, 63, 64), (3, 0, 99)], [(1, 127, 128)], [(3, 101, 199), (4, 190, 199)]]
+        for threshold, sign in ((afwDetect.Threshold(5.0), 1.0),
+                                (afwDetect.Threshold(2.0, afwDetect.Threshold.PIXEL_STDEV), 1.0),
+                                (afwDetect.Threshold(5.0, afwDetect.Threshold.VALUE, False), -1.0)):
+            image = afwImage.MaskedImageF(mi, True)
+            image.image.array *= sign
+            objects = afwDetect.FootprintSet(image, threshold).getFootprints()
+            self.assertEqual([[(sp.getY(), sp.getX0(), sp.getX1()) for sp in foot.spans] for foot in objects],
+                             expected)
+
+    def testCopyOnWrite(self):
+        """Check that copies, grows and merges share unchanged Footprints in copy-on-write mode"""
+        fs = afwDetect.FootprintSet(self.im, afwDetect.Threshold(10))
+        self.assertFalse(fs.isCopyOnWrite())
+        feet = fs.getFootprints()
+        for foot, deepFoot in zip(feet, afwDetect.FootprintSet(fs).getFootprints()):
+            self.assertIsNot(deepFoot, foot)
+            self.assertEqual(deepFoot, foot)
+
+        fs.setCopyOnWrite(True)
+        for copy in (afwDetect.FootprintSet(fs), afwDetect.FootprintSet(fs, 0, True)):
+            self.assertTrue(copy.isCopyOnWrite())
+            for foot, copyFoot in zip(feet, copy.getFootprints()):
+                self.assertIs(copyFoot, foot)
+        # setRegion must not modify the Footprints shared with fs
+        copy = afwDetect.FootprintSet(fs)
+        region = lsst.geom.Box2I(lsst.geom.Point2I(-1, -1), lsst.geom.Extent2I(20, 20))
+        copy.setRegion(region)
+        for foot, copyFoot in zip(feet, copy.getFootprints()):
+            self.assertIsNot(copyFoot, foot)
+            self.assertEqual(copyFoot.getRegion(), region)
+            self.assertEqual(foot.getRegion(), fs.getRegion())
+        # merge a Footprint that touches only the first object
+        other = afwDetect.FootprintSet(fs.getRegion())
+        spans = afwGeom.SpanSet(lsst.geom.Box2I(lsst.geom.Point2I(5, 1), lsst.geom.Extent2I(2, 1)))
+        other.setFootprints([afwDetect.Footprint(spans, fs.getRegion())])
+        merged = afwDetect.FootprintSet(fs)
+        merged.merge(other)
+        mergedFeet = merged.getFootprints()
+        self.assertEqual(len(mergedFeet), len(feet))
+        self.assertIsNot(mergedFeet[0], feet[0])
+        self.assertEqual(mergedFeet[0].getArea(), feet[0].getArea() + 2)
+        for foot, mergedFoot in zip(feet[1:], mergedFeet[1:]):
+            self.assertIs(mergedFoot, foot)
+        # the merge did not modify fs
+        self.assertEqual([foot.getArea() for foot in fs.getFootprints()], [foot.getArea() for foot in feet])
+        self.assertEqual(feet[0].getArea(), 5)
+
     def testGrow2(self):
         """Grow some more interesting shaped Footprints.  Informative with display, but no numerical tests"""
         # Can't set mask plane as the image is not a masked image.
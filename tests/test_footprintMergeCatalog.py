@@ -26,6 +26,7 @@ import numpy as np
 import lsst.utils.tests
 import lsst.pex.exceptions
 import lsst.geom
+import lsst.afw.geom as afwGeom
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
 import lsst.afw.table as afwTable
@@ -338,6 +339,89 @@ class FootprintMergeCatalogTestCase(lsst.utils.tests.TestCase):
             for peak in record.getFootprint().getPeaks():
                 self.assertTrue(isPeakInCatalog(peak, merge))
 
+    def testWideMerge(self):
+        """Test merging footprints spread over many cells of the spatial index
+
+        The second catalog connects footprints of the first that are several
+        index cells apart, including some at negative coordinates.
+        """
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        merged = afwDetect.FootprintMergeList(schema, ["1", "2"])
+        table = afwTable.SourceTable.make(schema, self.idFactory)
+
+        def makeCatalog(boxes):
+            catalog = afwTable.SourceCatalog(table)
+            for box in boxes:
+                footprint = afwDetect.Footprint(afwGeom.SpanSet(box))
+                footprint.addPeak(box.getCenterX(), box.getCenterY(), 1.0)
+                catalog.addNew().setFootprint(footprint)
+            return catalog
+
+        def makeBox(x0, y0, x1, y1):
+            return lsst.geom.Box2I(lsst.geom.Point2I(x0, y0), lsst.geom.Point2I(x1, y1))
+
+        boxes1 = [makeBox(x0, 0, x0 + 19, 19) for x0 in range(-300, 500, 100)]
+        boxes2 = [makeBox(-290, 10, 150, 10), makeBox(1000, 1000, 1009, 1009)]
+        merged.addCatalog(table, makeCatalog(boxes1), "1", 0.0)
+        merged.addCatalog(table, makeCatalog(boxes2), "2", 0.0)
+        mergedList = afwTable.SourceCatalog(table)
+        merged.getFinalSources(mergedList)
+
+        # The first five footprints of catalog 1 are joined into the first entry, and the other
+        # entries keep their order
+        expectedBoxes = [makeBox(-300, 0, 150, 19)] + boxes1[5:] + boxes2[1:]
+        self.assertEqual([record.getFootprint().getBBox() for record in mergedList], expectedBoxes)
+        self.assertEqual([record.get("merge_footprint_1") for record in mergedList],
+                         [True, True, True, True, False])
+        self.assertEqual([record.get("merge_footprint_2") for record in mergedList],
+                         [True, False, False, False, True])
+        self.assertEqual(len(mergedList[0].getFootprint().getPeaks()), 6)
+
+        # Merging another catalog uses the index built from the merged list
+        merged.addCatalog(table, makeCatalog([makeBox(110, 5, 210, 5)]), "2", 0.0)
+        mergedList = afwTable.SourceCatalog(table)
+        merged.getFinalSources(mergedList)
+        self.assertEqual([record.getFootprint().getBBox() for record in mergedList],
+                         [makeBox(-300, 0, 219, 19)] + boxes1[6:] + boxes2[1:])
+
+        merged.clearCatalog()
+        mergedList = afwTable.SourceCatalog(table)
+        merged.getFinalSources(mergedList)
+        self.assertEqual(len(mergedList), 0)
+
+    def testNegativeMerge(self):
+        """Test merging footprints in index cells at negative x and y
+        """
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        merged = afwDetect.FootprintMergeList(schema, ["1", "2"])
+        table = afwTable.SourceTable.make(schema, self.idFactory)
+
+        def makeCatalog(boxes):
+            catalog = afwTable.SourceCatalog(table)
+            for box in boxes:
+                footprint = afwDetect.Footprint(afwGeom.SpanSet(box))
+                footprint.addPeak(box.getCenterX(), box.getCenterY(), 1.0)
+                catalog.addNew().setFootprint(footprint)
+            return catalog
+
+        def makeBox(x0, y0, x1, y1):
+            return lsst.geom.Box2I(lsst.geom.Point2I(x0, y0), lsst.geom.Point2I(x1, y1))
+
+        # One footprint in each quadrant, and one just below and left of the origin
+        boxes1 = [makeBox(-600, -600, -581, -581), makeBox(-600, 400, -581, 419),
+                  makeBox(400, -600, 419, -581), makeBox(400, 400, 419, 419), makeBox(-10, -10, -1, -1)]
+        # Join the two footprints at negative y, and overlap the one near the origin
+        boxes2 = [makeBox(-590, -590, 410, -590), makeBox(-5, -5, 5, 5)]
+        merged.addCatalog(table, makeCatalog(boxes1), "1", 0.0)
+        merged.addCatalog(table, makeCatalog(boxes2), "2", 0.0)
+        mergedList = afwTable.SourceCatalog(table)
+        merged.getFinalSources(mergedList)
+
+        expectedBoxes = [makeBox(-600, -600, 419, -581), boxes1[1], boxes1[3], makeBox(-10, -10, 5, 5)]
+        self.assertEqual([record.getFootprint().getBBox() for record in mergedList], expectedBoxes)
+        self.assertEqual([record.get("merge_footprint_2") for record in mergedList],
+                         [True, False, False, True])
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -151,6 +151,28 @@ class HeavyFootprintTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsEqual(
             self.mi.getImage().getArray(), omi.getImage().getArray())
 
+    def testMakeHeavyMultithreaded(self):
+        """Test that making a FootprintSet heavy in parallel gives the same HeavyFootprints"""
+        np.random.seed(1)
+        mi = afwImage.MaskedImageF(lsst.geom.Extent2I(150, 100))
+        mi.image.array[:] = np.random.normal(0.0, 1.0, size=(100, 150))
+        mi.mask.array[:] = np.random.randint(0, 4, size=(100, 150))
+        mi.variance.array[:] = np.random.uniform(1.0, 2.0, size=(100, 150))
+        fs = afwDetect.FootprintSet(mi, afwDetect.Threshold(1.0))
+        self.assertGreater(len(fs.getFootprints()), 10)
+
+        ref = afwDetect.FootprintSet(fs)
+        ref.makeHeavy(mi)
+        for numThreads in (3, 0):
+            heavy = afwDetect.FootprintSet(fs)
+            heavy.makeHeavy(mi, numThreads=numThreads)
+            for foot, refFoot in zip(heavy.getFootprints(), ref.getFootprints()):
+                self.assertTrue(foot.isHeavy())
+                self.assertEqual(foot.spans, refFoot.spans)
+                np.testing.assert_array_equal(foot.getImageArray(), refFoot.getImageArray())
+                np.testing.assert_array_equal(foot.getMaskArray(), refFoot.getMaskArray())
+                np.testing.assert_array_equal(foot.getVarianceArray(), refFoot.getVarianceArray())
+
     def testXY0(self):
         """Test that inserting a HeavyFootprint obeys XY0"""
         fs = afwDetect.FootprintSet(self.mi, afwDetect.Threshold(1))
@@ -452,6 +452,91 @@ class SimpleTableTestCase(lsst.utils.tests.TestCase):
         outputRecord2.assign(inputRecord, mapper2)
         self.assertNotEqual(outputRecord2.getId(), inputRecord.getId())
 
+    def testBlockGrowth(self):
+        """Test that tables allocate geometrically larger blocks when records
+        are added one at a time.
+        """
+        schema = lsst.afw.table.Schema()
+        schema.addField("f", type=np.float64)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        sizes = []
+        for i in range(1500):
+            cat.addNew()
+            if cat.table.getBufferSize() == 0:
+                sizes.append(len(cat))
+        self.assertEqual(sizes[:4], [100, 300, 700, 1500])
+        # preallocate still gives exactly the requested space
+        cat.table.preallocate(10)
+        self.assertEqual(cat.table.getBufferSize(), 10)
+
+    def testBlockSizeLimit(self):
+        """Test that table blocks stop growing at 1 MiB, which bounds the
+        memory one surviving record of a long-lived table can keep alive.
+        """
+        schema = lsst.afw.table.Schema()
+        schema.addField("a", type="ArrayD", size=512, doc="4 KiB of doubles")
+        self.assertEqual(schema.getRecordSize(), 4096)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        blockSizes = []
+        for i in range(2000):
+            full = cat.table.getBufferSize() == 0
+            cat.addNew()
+            if full:
+                blockSizes.append(cat.table.getBufferSize() + 1)
+        self.assertEqual(blockSizes[:4], [100, 200, 256, 256])
+        self.assertLessEqual(max(blockSizes)*schema.getRecordSize(), 1 << 20)
+
+    def testCompact(self):
+        """Test moving the records of a non-contiguous catalog into a single
+        block, keeping the record objects.
+        """
+        schema = lsst.afw.table.Schema()
+        k1 = schema.addField("f1", type=np.int32)
+        k2 = schema.addField("f2", type=np.float64)
+        k3 = schema.addField("s", type=str, size=0)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for i in range(1000):
+            record = cat.addNew()
+            record.set(k1, i)
+            record.set(k2, 0.5*i)
+            record.set(k3, "a string too long to be stored inline: %d" % i)
+        self.assertFalse(cat.isContiguous())
+        oldRecord = cat[500]
+        cat.compact()
+        self.assertTrue(cat.isContiguous())
+        np.testing.assert_array_equal(cat[k1], np.arange(1000))
+        np.testing.assert_array_equal(cat[k2], 0.5*np.arange(1000))
+        for i, record in enumerate(cat):
+            self.assertEqual(record.get(k3), "a string too long to be stored inline: %d" % i)
+        # References to records made before compacting see the moved data.
+        oldRecord.set(k1, -1)
+        self.assertEqual(cat[k1][500], -1)
+        # Compacting a contiguous catalog does nothing.
+        cat.compact()
+        self.assertEqual(cat[k1][500], -1)
+        # New records are still allocated as usual.
+        cat.addNew().set(k1, 1000)
+        self.assertEqual(cat[1000].get(k1), 1000)
+        # Catalogs that hold a record twice or records of another table can't be compacted.
+        twice = lsst.afw.table.BaseCatalog(cat.table)
+        twice.append(cat[0])
+        twice.append(cat[1])
+        twice.append(cat[0])
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            twice.compact()
+        other = lsst.afw.table.BaseCatalog(cat.table.clone())
+        other.append(cat[2])
+        other.append(cat[1])
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            other.compact()
+        # ...even if they are contiguous.
+        contiguous = lsst.afw.table.BaseCatalog(cat.table.clone())
+        contiguous.append(cat[1])
+        contiguous.append(cat[2])
+        self.assertTrue(contiguous.isContiguous())
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            contiguous.compact()
+
     def testTicket2393(self):
         schema = lsst.afw.table.Schema()
         k = schema.addField(lsst.afw.table.Field[np.int32]("i", "doc for i"))
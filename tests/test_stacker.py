@@ -27,6 +27,7 @@ Run with:
 or
    pytest test_stacker.py
 """
+import os
 import unittest
 from functools import reduce
 
@@ -403,6 +404,112 @@ class StackTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(stack.mask[1, 1, afwImage.LOCAL], clipped)
         self.assertEqual(stack.mask[1, 2, afwImage.LOCAL], rejected)
 
+    def testStackMatchesStatistics(self):
+        """Test that stacking each pixel gives the same answer as makeStatistics on that pixel's inputs"""
+        nImg, width, height = 9, 300, 2  # wider than a tile of the stacking engine
+        BAD = 0x1
+        noGoodPixelsMask = afwImage.Mask.getPlaneBitMask("NO_DATA")
+        mimgList = []
+        for i in range(nImg):
+            mimg = afwImage.MaskedImageF(lsst.geom.Extent2I(width, height))
+            mimg.image.array[:] = np.random.normal(100.0, 10.0, (height, width))
+            mimg.image.array[:, i::7] = 1000.0  # outliers, to be clipped
+            mimg.image.array[1, i::11] = np.nan
+            mimg.mask.array[:] = np.where(np.random.uniform(size=(height, width)) < 0.1, BAD, 0x0)
+            mimg.mask.array[:, 3] = BAD  # no good pixels
+            mimg.mask.array[0, i::5] |= 0x4
+            mimg.variance.array[:] = np.random.uniform(1.0, 2.0, (height, width))
+            mimgList.append(mimg)
+
+        for weighted in (False, True):
+            sctrl = afwMath.StatisticsControl()
+            sctrl.setAndMask(BAD)
+            sctrl.setWeighted(weighted)
+            for flag in (afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP):
+                stack = afwMath.statisticsStack(mimgList, flag, sctrl)
+                for y in range(height):
+                    for x in range(width):
+                        pixels = afwImage.MaskedImageF(lsst.geom.Extent2I(nImg, 1))
+                        for i, mimg in enumerate(mimgList):
+                            pixels[i, 0, afwImage.LOCAL] = mimg[x, y, afwImage.LOCAL]
+                        stats = afwMath.makeStatistics(pixels, flag | afwMath.ERRORS | afwMath.NPOINT, sctrl)
+                        value, mask, variance = stack[x, y, afwImage.LOCAL]
+                        if stats.getValue(afwMath.NPOINT) == 0:
+                            self.assertTrue(np.isnan(value))
+                            self.assertEqual(mask, noGoodPixelsMask)
+                            continue
+                        self.assertFloatsAlmostEqual(value, stats.getValue(flag), rtol=1e-6, ignoreNaNs=True)
+                        self.assertFloatsAlmostEqual(variance, stats.getError(flag)**2, rtol=1e-5,
+                                                     ignoreNaNs=True)
+                        self.assertEqual(mask, stats.getOrMask())
+
+    def _makeStackInputs(self, nImg, width, height, xy0):
+        """Return a list of MaskedImageFs with some masked and NaN pixels"""
+        mimgList = []
+        for i in range(nImg):
+            mimg = afwImage.MaskedImageF(lsst.geom.Box2I(xy0, lsst.geom.Extent2I(width, height)))
+            mimg.image.array[:] = np.random.normal(100.0, 10.0, (height, width))
+            mimg.image.array[:, i::7] = 1000.0
+            mimg.image.array[i % height, i::11] = np.nan
+            mimg.mask.array[:] = np.where(np.random.uniform(size=(height, width)) < 0.1, 0x1, 0x0)
+            mimg.variance.array[:] = np.random.uniform(1.0, 2.0, (height, width))
+            mimgList.append(mimg)
+        return mimgList
+
+    def testMultithreadedStack(self):
+        """Test that stacking with several threads gives the same answer as a single thread"""
+        mimgList = self._makeStackInputs(7, 40, 23, lsst.geom.Point2I(0, 0))
+        for flag in (afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP, afwMath.MAX):
+            sctrl = afwMath.StatisticsControl()
+            sctrl.setAndMask(0x1)
+            expect = afwMath.statisticsStack(mimgList, flag, sctrl)
+            for nThreads in (3, 0):
+                sctrl.setNumThreads(nThreads)
+                stack = afwMath.statisticsStack(mimgList, flag, sctrl)
+                self.assertMaskedImagesEqual(stack, expect)
+
+    def testStreamingStack(self):
+        """Test that stacking bands read on demand gives the same answer as stacking in memory"""
+        nImg, width, height = 7, 40, 23
+        xy0 = lsst.geom.Point2I(10, -5)
+        mimgList = self._makeStackInputs(nImg, width, height, xy0)
+        maskMap = [(0x1, 0x2)]
+        clipped = 0x4
+
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(0x1)
+        sctrl.setNumThreads(2)
+        bboxes = []
+
+        def readBand(i, bbox):
+            bboxes.append(bbox)
+            return afwImage.MaskedImageF(mimgList[i], bbox, afwImage.PARENT, True)
+
+        for flag in (afwMath.MEANCLIP, afwMath.MAX):
+            expect = afwMath.statisticsStack(mimgList, flag, sctrl, [], clipped, maskMap)
+            stack = afwImage.MaskedImageF(mimgList[0].getBBox())
+            del bboxes[:]
+            afwMath.statisticsStack(stack, nImg, readBand, flag, sctrl, [], clipped, maskMap, 5)
+            self.assertMaskedImagesEqual(stack, expect)
+            self.assertEqual(len(bboxes), nImg*((height + 4)//5))
+            self.assertTrue(all(bbox.getHeight() <= 5 for bbox in bboxes))
+
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                fileNames = []
+                for i, mimg in enumerate(mimgList):
+                    fileNames.append(tmpFile.replace(".fits", "-%d.fits" % i))
+                    mimg.writeFits(fileNames[-1])
+                try:
+                    stack = afwImage.MaskedImageF(mimgList[0].getBBox())
+                    afwMath.statisticsStack(stack, fileNames, flag, sctrl, [], clipped, maskMap, 6)
+                    self.assertMaskedImagesEqual(stack, expect)
+                finally:
+                    for fileName in fileNames:
+                        os.remove(fileName)
+
+        with self.assertRaises(pexEx.InvalidParameterError):
+            afwMath.statisticsStack(stack, nImg, readBand, afwMath.MEAN, sctrl, [], clipped, maskMap, 0)
+
 #################################################################
 # Test suite boiler plate
 #################################################################
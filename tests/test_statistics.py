@@ -577,6 +577,144 @@ class StatisticsTestCase(lsst.utils.tests.TestCase):
             mask[1, 1] = maskVal
             self.assertEqual(afwMath.makeStatistics(image, mask, afwMath.NMASKED, ctrl).getValue(), 1)
 
+    def testRaggedRows(self):
+        """Test the standard statistics of masked images whose widths aren't a multiple of the
+        block size used to accumulate the sums, with NaNs and masked pixels scattered through them
+        """
+        badVal = 0x4
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(badVal)
+        flags = afwMath.NPOINT | afwMath.MEAN | afwMath.STDEV | afwMath.MIN | afwMath.MAX | afwMath.SUM
+
+        np.random.seed(42)
+        for width in range(1, 20):
+            mi = afwImage.MaskedImageF(width, 7)
+            mi.image.array[:] = np.random.normal(5.0, 2.0, mi.image.array.shape)
+            mi.mask.array[:] = np.random.choice([0x0, 0x1, badVal], mi.mask.array.shape)
+            mi.image.array[0, 0] = np.nan
+
+            good = np.isfinite(mi.image.array) & ((mi.mask.array & badVal) == 0)
+            values = mi.image.array[good].astype(float)
+            stats = afwMath.makeStatistics(mi, flags | afwMath.ORMASK, ctrl)
+
+            self.assertEqual(stats.getValue(afwMath.NPOINT), len(values))
+            if len(values) == 0:
+                continue
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEAN), np.mean(values), rtol=1e-12)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.SUM), np.sum(values), rtol=1e-12)
+            self.assertEqual(stats.getValue(afwMath.MIN), np.min(values))
+            self.assertEqual(stats.getValue(afwMath.MAX), np.max(values))
+            if len(values) > 1:
+                self.assertFloatsAlmostEqual(stats.getValue(afwMath.STDEV), np.std(values, ddof=1),
+                                             rtol=1e-10)
+            self.assertEqual(stats.getOrMask(), np.bitwise_or.reduce(mi.mask.array[good]))
+
+    def testRadixSelect(self):
+        """Test that the radix-select quantile algorithm agrees with the default"""
+        radixCtrl = afwMath.StatisticsControl()
+        radixCtrl.setQuantileAlgorithm(afwMath.StatisticsControl.QUANTILE_RADIX_SELECT)
+        self.assertEqual(radixCtrl.getQuantileAlgorithm(), afwMath.StatisticsControl.QUANTILE_RADIX_SELECT)
+        self.assertEqual(afwMath.StatisticsControl().getQuantileAlgorithm(),
+                         afwMath.StatisticsControl.QUANTILE_NTH_ELEMENT)
+
+        for image, isInt, mean, median, std in self.images:
+            # a negative value and a NaN (or the largest int) test the mapping of values to keys
+            image = image.clone()
+            image[0, 0] = -1000
+            image[1, 0] = np.iinfo(np.int32).max if isInt else np.nan
+
+            self.assertEqual(afwMath.makeStatistics(image, afwMath.MEDIAN, radixCtrl).getValue(),
+                             afwMath.makeStatistics(image, afwMath.MEDIAN).getValue())
+
+            flags = afwMath.MEDIAN | afwMath.IQRANGE | afwMath.MEANCLIP
+            stats = afwMath.makeStatistics(image, flags)
+            radixStats = afwMath.makeStatistics(image, flags, radixCtrl)
+            if isInt:
+                # Ties are resolved using the counts over the whole image
+                values = np.sort(image.array.flatten())
+                n = len(values)
+
+                def quantile(fraction):
+                    naive = values[int(fraction*(n - 1))]
+                    return naive - 0.5 + (fraction*n - np.sum(values < naive))/np.sum(values == naive)
+
+                self.assertAlmostEqual(radixStats.getValue(afwMath.MEDIAN), quantile(0.5), places=10)
+                self.assertAlmostEqual(radixStats.getValue(afwMath.IQRANGE), quantile(0.75) - quantile(0.25),
+                                       places=10)
+            else:
+                for prop in (afwMath.MEDIAN, afwMath.IQRANGE, afwMath.MEANCLIP):
+                    self.assertEqual(radixStats.getValue(prop), stats.getValue(prop))
+
+        values = [1.0, 2.0, 3.0, 2.0]
+        self.assertEqual(afwMath.makeStatistics(values, afwMath.MEDIAN, radixCtrl).getValue(), 2.0)
+
+        mask = afwImage.Mask(self.images[1][0].getBBox())
+        mask.set(0x1)
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(0x1)
+        ctrl.setQuantileAlgorithm(afwMath.StatisticsControl.QUANTILE_RADIX_SELECT)
+        self.assertTrue(np.isnan(afwMath.makeStatistics(self.images[1][0], mask, afwMath.MEDIAN,
+                                                        ctrl).getValue()))
+
+    def testIncrementalClip(self):
+        """Test that clipping a sorted copy of the pixels gives the same answers as the default"""
+        flags = afwMath.MEANCLIP | afwMath.STDEVCLIP | afwMath.VARIANCECLIP | afwMath.NCLIPPED
+        for algorithm in (afwMath.StatisticsControl.QUANTILE_NTH_ELEMENT,
+                          afwMath.StatisticsControl.QUANTILE_RADIX_SELECT):
+            ctrl = afwMath.StatisticsControl(numSigmaClip=2.5, numIter=5)
+            ctrl.setQuantileAlgorithm(algorithm)
+            incrementalCtrl = afwMath.StatisticsControl(numSigmaClip=2.5, numIter=5)
+            incrementalCtrl.setQuantileAlgorithm(algorithm)
+            incrementalCtrl.setIncrementalClip(True)
+            self.assertTrue(incrementalCtrl.getIncrementalClip())
+
+            for image, isInt, mean, median, std in self.images:
+                image = image.clone()
+                outlier = int(1000*mean) if isInt else 1000*mean
+                image[0, 0] = outlier
+                image[1, 0] = -outlier
+                if not isInt:
+                    image[2, 0] = np.nan
+
+                stats = afwMath.makeStatistics(image, flags, ctrl)
+                incrementalStats = afwMath.makeStatistics(image, flags, incrementalCtrl)
+                self.assertEqual(incrementalStats.getValue(afwMath.NCLIPPED),
+                                 stats.getValue(afwMath.NCLIPPED))
+                for prop in (afwMath.MEANCLIP, afwMath.STDEVCLIP, afwMath.VARIANCECLIP):
+                    self.assertFloatsAlmostEqual(incrementalStats.getValue(prop), stats.getValue(prop),
+                                                 rtol=1e-10)
+
+    def testNumThreads(self):
+        """Test that the results don't depend (beyond rounding) on the number of threads"""
+        mi = afwImage.MaskedImageF(lsst.geom.Extent2I(700, 500))
+        rng = np.random.RandomState(12345)
+        mi.image.array[:] = rng.normal(1000.0, 10.0, mi.image.array.shape)
+        mi.image.array[3, 5] = np.nan
+        mi.mask.array[:] = np.where(rng.uniform(size=mi.mask.array.shape) < 0.01, 0x1, 0x0)
+        mi.variance.array[:] = 100.0
+
+        flags = (afwMath.NPOINT | afwMath.MEAN | afwMath.SUM | afwMath.STDEV | afwMath.MIN | afwMath.MAX |
+                 afwMath.MEDIAN | afwMath.IQRANGE | afwMath.MEANCLIP | afwMath.STDEVCLIP)
+        for algorithm in (afwMath.StatisticsControl.QUANTILE_NTH_ELEMENT,
+                          afwMath.StatisticsControl.QUANTILE_RADIX_SELECT):
+            ctrl = afwMath.StatisticsControl()
+            ctrl.setAndMask(0x1)
+            ctrl.setQuantileAlgorithm(algorithm)
+            self.assertEqual(ctrl.getNumThreads(), 1)
+            serial = afwMath.makeStatistics(mi, flags, ctrl)
+
+            for numThreads in (2, 3, 0):
+                ctrl.setNumThreads(numThreads)
+                self.assertEqual(ctrl.getNumThreads(), numThreads)
+                stats = afwMath.makeStatistics(mi, flags, ctrl)
+                again = afwMath.makeStatistics(mi, flags, ctrl)
+                for prop in (afwMath.NPOINT, afwMath.MIN, afwMath.MAX, afwMath.MEDIAN, afwMath.IQRANGE):
+                    self.assertEqual(stats.getValue(prop), serial.getValue(prop))
+                for prop in (afwMath.MEAN, afwMath.SUM, afwMath.STDEV, afwMath.MEANCLIP, afwMath.STDEVCLIP):
+                    self.assertFloatsAlmostEqual(stats.getValue(prop), serial.getValue(prop), rtol=1e-10)
+                    # bit-reproducible for a given number of threads
+                    self.assertEqual(again.getValue(prop), stats.getValue(prop))
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
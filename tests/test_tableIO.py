@@ -27,6 +27,7 @@ import astropy.io.fits
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.table
 import lsst.afw.image
 
@@ -102,6 +103,337 @@ class TableIoTestCase(lsst.utils.tests.TestCase):
             self.assertFloatsEqual(larger[bb], larger2[bb])
             self.assertFloatsEqual(larger[cc], larger2[cc])
 
+    def testBufferedRows(self):
+        """Test that catalogs with only fixed-size fields, which are written
+        many rows at a time, round-trip and match what cfitsio would write.
+        """
+        schema = lsst.afw.table.Schema()
+        keys = {
+            "l": schema.addField("l", type=np.int64, doc="int64"),
+            "u": schema.addField("u", type=np.uint16, doc="uint16"),
+            "i": schema.addField("i", type=np.int32, doc="int32"),
+            "b": schema.addField("b", type=np.uint8, doc="uint8"),
+            "f": schema.addField("f", type=np.float32, doc="float"),
+            "d": schema.addField("d", type=np.float64, doc="double"),
+            "arrU": schema.addField("arrU", type="ArrayU", size=2, doc="uint16 array"),
+            "arrF": schema.addField("arrF", type="ArrayF", size=3, doc="float array"),
+        }
+        angleKey = schema.addField("angle", type="Angle", doc="angle")
+        stringKey = schema.addField("s", type=str, size=8, doc="string")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(10)]
+
+        # Enough rows for the buffer to be written several times, and partly filled at the end
+        nRows = 40000
+        rng = np.random.RandomState(1)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        cat.resize(nRows)
+        cat[keys["l"]] = rng.randint(-2**62, 2**62, size=nRows, dtype=np.int64)
+        cat[keys["u"]] = np.arange(nRows)*7 % 65536
+        cat[keys["i"]] = rng.randint(-2**31, 2**31, size=nRows, dtype=np.int64)
+        cat[keys["b"]] = np.arange(nRows) % 256
+        cat[keys["f"]] = rng.randn(nRows)
+        cat[keys["d"]] = rng.randn(nRows)
+        cat[keys["d"]][5] = np.nan
+        cat[keys["arrU"]] = rng.randint(0, 65536, size=(nRows, 2))
+        cat[keys["arrF"]] = rng.randn(nRows, 3)
+        for i, record in enumerate(cat):
+            record.set(angleKey, 0.001*i*lsst.geom.radians)
+            record.set(stringKey, "row%d" % (i % 10000))
+            record.set(flagKeys[i % 10], True)
+            record.set(flagKeys[(i // 10) % 10], True)
+        cat[keys["u"]][0] = 65535
+
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+            self.assertEqual(len(cat2), nRows)
+            for name, key in keys.items():
+                np.testing.assert_array_equal(cat[key], cat2[key], err_msg=name)
+            self.assertFloatsEqual(cat[angleKey], cat2[angleKey])
+            self.assertEqual([r.get(stringKey) for r in cat2[:20]], ["row%d" % i for i in range(20)])
+            self.assertEqual(cat2[-1].get(stringKey), "row%d" % ((nRows - 1) % 10000))
+            for flagKey in flagKeys:
+                np.testing.assert_array_equal(cat[flagKey], cat2[flagKey])
+
+            # Check the raw values with an independent reader
+            with astropy.io.fits.open(tmpFile) as inFits:
+                data = inFits[1].data
+                np.testing.assert_array_equal(data["u"], cat[keys["u"]])
+                np.testing.assert_array_equal(data["l"], cat[keys["l"]])
+                np.testing.assert_array_equal(data["arrU"], cat[keys["arrU"]])
+                self.assertEqual(data["s"][3], "row3")
+                self.assertEqual(list(data["flags"][12]),
+                                 [i in (1, 2) for i in range(10)])
+
+    def testVariableLengthRows(self):
+        """Test that catalogs with variable-length fields, which are written
+        field by field, still round-trip.
+        """
+        schema = lsst.afw.table.Schema()
+        aa = schema.addField("a", type=np.float64, doc="a")
+        bb = schema.addField("b", type="ArrayF", size=0, doc="variable-length array")
+        flag = schema.addField("flag", type="Flag", doc="flag")
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for i in range(5):
+            record = cat.addNew()
+            record.set(aa, float(i))
+            record.set(bb, np.arange(i, dtype=np.float32))
+            record.set(flag, i % 2 == 1)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+            for record, record2 in zip(cat, cat2):
+                self.assertEqual(record.get(aa), record2.get(aa))
+                np.testing.assert_array_equal(record.get(bb), record2.get(bb))
+                self.assertEqual(record.get(flag), record2.get(flag))
+
+    def testReadRows(self):
+        """Test reading catalogs a block of raw rows at a time, across block
+        boundaries and with columns that must still be read by cfitsio.
+        """
+        schema = lsst.afw.table.Schema()
+        ll = schema.addField("l", type=np.int64, doc="int64")
+        uu = schema.addField("u", type=np.uint16, doc="uint16")
+        bb = schema.addField("b", type=np.uint8, doc="uint8")
+        ff = schema.addField("f", type=np.float32, doc="float")
+        arrU = schema.addField("arrU", type="ArrayU", size=3, doc="uint16 array")
+        arrD = schema.addField("arrD", type="ArrayD", size=2, doc="double array")
+        angle = schema.addField("angle", type="Angle", doc="angle")
+        ss = schema.addField("s", type=str, size=6, doc="string")
+        vv = schema.addField("v", type="ArrayF", size=0, doc="variable-length array")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(9)]
+        nRows = 53
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for i in range(nRows):
+            record = cat.addNew()
+            record.set(ll, -2**40 + i)
+            record.set(uu, 65535 - i)
+            record.set(bb, 200 + i % 50)
+            record.set(ff, 0.5*i)
+            record.set(arrU, np.array([i, 2*i, 65535], dtype=np.uint16))
+            record.set(arrD, np.array([i, -i], dtype=float))
+            record.set(angle, 0.25*i*lsst.geom.radians)
+            record.set(ss, "r%d" % i)
+            record.set(vv, np.arange(i % 4, dtype=np.float32))
+            record.set(flagKeys[i % 9], True)
+        oldFactor = lsst.afw.table.io.getPreppedRowsFactor()
+        try:
+            for factor in (1, 5*schema.getRecordSize(), 1 << 15):
+                lsst.afw.table.io.setPreppedRowsFactor(factor)
+                with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                    cat.writeFits(tmpFile)
+                    cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+                self.assertEqual(len(cat2), nRows)
+                for record, record2 in zip(cat, cat2):
+                    for key in (ll, uu, bb, ff, ss) + tuple(flagKeys):
+                        self.assertEqual(record.get(key), record2.get(key))
+                    self.assertEqual(record.get(angle), record2.get(angle))
+                    for key in (arrU, arrD, vv):
+                        np.testing.assert_array_equal(record.get(key), record2.get(key))
+        finally:
+            lsst.afw.table.io.setPreppedRowsFactor(oldFactor)
+
+    def testReadScaledRows(self):
+        """Test that scaled columns written by other software are still
+        read through cfitsio when reading blocks of raw rows.
+        """
+        columns = [astropy.io.fits.Column(name="a", format="J", array=2*np.arange(10), bscale=2.0),
+                   astropy.io.fits.Column(name="b", format="D", array=np.arange(10)*0.5)]
+        hdu = astropy.io.fits.BinTableHDU.from_columns(columns)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            hdu.writeto(tmpFile)
+            cat = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+        np.testing.assert_array_equal(cat["a"], 2*np.arange(10))
+        np.testing.assert_array_equal(cat["b"], np.arange(10)*0.5)
+
+    def testReadConvertedRows(self):
+        """Test that columns whose FITS type differs from that of their field
+        are still converted by cfitsio when reading blocks of raw rows.
+        """
+        values = np.arange(30, dtype=np.int64).reshape(10, 3) - 1000
+        columns = [astropy.io.fits.Column(name="a", format="3K", array=values),
+                   astropy.io.fits.Column(name="b", format="D", array=np.arange(10)*0.5)]
+        hdu = astropy.io.fits.BinTableHDU.from_columns(columns)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            hdu.writeto(tmpFile)
+            cat = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+        aa = cat.schema["a"].asKey()
+        for record, expected in zip(cat, values):
+            np.testing.assert_array_equal(record.get(aa), expected.astype(np.float32))
+        np.testing.assert_array_equal(cat["b"], np.arange(10)*0.5)
+
+    def testReadSelection(self):
+        """Test reading a subset of the fields and rows of a catalog.
+        """
+        schema = lsst.afw.table.Schema()
+        ax = schema.addField("a_x", type=np.float64, doc="a x")
+        ay = schema.addField("a_y", type=np.float64, doc="a y")
+        aFlag = schema.addField("a_flag", type="Flag", doc="a flag")
+        bb = schema.addField("b", type=np.int32, doc="b")
+        cc = schema.addField("c", type=np.int32, doc="c")
+        cFlag = schema.addField("c_flag", type="Flag", doc="c flag")
+        nRows = 40
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for i in range(nRows):
+            record = cat.addNew()
+            record.set(ax, 0.5*i)
+            record.set(ay, -0.5*i)
+            record.set(aFlag, i % 2 == 0)
+            record.set(bb, i)
+            record.set(cc, -i)
+            record.set(cFlag, i % 3 == 0)
+        selection = lsst.afw.table.io.FitsReadSelection(fields=["b"], prefixes=["a_"])
+        oldFactor = lsst.afw.table.io.getPreppedRowsFactor()
+        try:
+            for factor in (1, 6*schema.getRecordSize(), 1 << 15):
+                lsst.afw.table.io.setPreppedRowsFactor(factor)
+                with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                    cat.writeFits(tmpFile)
+                    cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile, selection)
+                    selection.firstRow = 7
+                    selection.maxRows = 20
+                    cat3 = lsst.afw.table.BaseCatalog.readFits(tmpFile, selection)
+                    selection.firstRow = 0
+                    selection.maxRows = nRows + 1
+                self.assertEqual(cat2.schema.getNames(), {"a_flag", "a_x", "a_y", "b"})
+                self.assertEqual(len(cat2), nRows)
+                self.assertEqual(len(cat3), 20)
+                for cat4, rows in ((cat2, range(nRows)), (cat3, range(7, 27))):
+                    np.testing.assert_array_equal(cat4["a_x"], cat["a_x"][rows])
+                    np.testing.assert_array_equal(cat4["a_y"], cat["a_y"][rows])
+                    np.testing.assert_array_equal(cat4["a_flag"], cat["a_flag"][rows])
+                    np.testing.assert_array_equal(cat4["b"], cat["b"][rows])
+        finally:
+            lsst.afw.table.io.setPreppedRowsFactor(oldFactor)
+
+    def testReadCfitsioSelection(self):
+        """Test reading a selection of only fields that cfitsio must read,
+        from a catalog that also has fields decodable from raw rows.
+        """
+        schema = lsst.afw.table.Schema()
+        dd = schema.addField("d", type=np.float64, doc="double")
+        ss = schema.addField("s", type=str, size=4, doc="string")
+        vv = schema.addField("v", type="ArrayI", size=0, doc="variable-length array")
+        nRows = 30
+        cat = lsst.afw.table.BaseCatalog(schema)
+        for i in range(nRows):
+            record = cat.addNew()
+            record.set(dd, 0.5*i)
+            record.set(ss, "s%d" % i)
+            record.set(vv, np.arange(i % 5, dtype=np.int32))
+        selection = lsst.afw.table.io.FitsReadSelection(fields=["s", "v"])
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile, selection)
+        self.assertEqual(cat2.schema.getNames(), {"s", "v"})
+        for record, record2 in zip(cat, cat2):
+            self.assertEqual(record.get(ss), record2.get("s"))
+            np.testing.assert_array_equal(record.get(vv), record2.get("v"))
+
+    def testReadSourceSelection(self):
+        """Test that reading a subset of the fields of a SourceCatalog keeps
+        the fields SourceTable requires.
+        """
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        xx = schema.addField("base_x", type=np.float64, doc="x")
+        yy = schema.addField("ext_y", type=np.float64, doc="y")
+        cat = lsst.afw.table.SourceCatalog(schema)
+        for i in range(5):
+            record = cat.addNew()
+            record.set(xx, i)
+            record.set(yy, -i)
+        selection = lsst.afw.table.io.FitsReadSelection(prefixes=["base_"], firstRow=3)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            cat2 = lsst.afw.table.SourceCatalog.readFits(tmpFile, selection)
+        self.assertIn("base_x", cat2.schema)
+        self.assertNotIn("ext_y", cat2.schema)
+        self.assertTrue(lsst.afw.table.SourceTable.checkSchema(cat2.schema))
+        self.assertEqual(list(cat2["id"]), list(cat["id"][3:]))
+        self.assertEqual(list(cat2["base_x"]), list(cat["base_x"][3:]))
+
+    def testMapped(self):
+        """Test writing catalogs in the native record layout and reading
+        them back by mapping the file into memory.
+        """
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        ff = schema.addField("f", type=np.float32, doc="float")
+        uu = schema.addField("u", type=np.uint16, doc="uint16")
+        angle = schema.addField("angle", type="Angle", doc="angle")
+        arrD = schema.addField("arrD", type="ArrayD", size=3, doc="double array")
+        ss = schema.addField("s", type=str, size=5, doc="string")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(70)]
+        schema.getAliasMap().set("g", "f")
+        nRecords = 250
+        cat = lsst.afw.table.SourceCatalog(schema)
+        for i in range(nRecords):
+            record = cat.addNew()
+            record.set(ff, 0.5*i)
+            record.set(uu, 65535 - i)
+            record.set(angle, 0.125*i*lsst.geom.radians)
+            record.set(arrD, np.array([i, -i, 2*i], dtype=float))
+            record.set(ss, "s%d" % i)
+            record.set(flagKeys[i % 70], True)
+        self.assertFalse(cat.isContiguous())
+        with lsst.utils.tests.getTempFilePath(".afw") as tmpFile:
+            cat.writeMapped(tmpFile)
+            cat2 = lsst.afw.table.SourceCatalog.readMapped(tmpFile)
+            self.assertEqual(cat2.schema, cat.schema)
+            self.assertEqual(cat2.schema.getAliasMap().get("g"), "f")
+            self.assertEqual(len(cat2), nRecords)
+            self.assertTrue(cat2.isContiguous())
+            np.testing.assert_array_equal(cat2["id"], cat["id"])
+            np.testing.assert_array_equal(cat2["f"], cat["f"])
+            np.testing.assert_array_equal(cat2["u"], cat["u"])
+            np.testing.assert_array_equal(cat2["angle"], cat["angle"])
+            np.testing.assert_array_equal(cat2["arrD"], cat["arrD"])
+            for record, record2 in zip(cat, cat2):
+                self.assertEqual(record.get(ss), record2.get(ss))
+                for key in flagKeys:
+                    self.assertEqual(record.get(key), record2.get(key))
+            # Modifications are private to the mapping, and new records are allocated as usual.
+            cat2[0].set(ff, -1.0)
+            record = cat2.addNew()
+            self.assertTrue(np.isnan(record.get(ff)))
+            self.assertEqual(record.get(uu), 0)
+            cat3 = lsst.afw.table.BaseCatalog.readMapped(tmpFile)
+            self.assertEqual(cat3[0].get(ff), 0.0)
+            self.assertEqual(len(cat3), nRecords)
+        # The records keep the mapping alive after the catalog is gone.
+        column = cat3["u"]
+        record = cat3[nRecords - 1]
+        del cat3
+        np.testing.assert_array_equal(column, cat["u"])
+        self.assertEqual(record.get(ss), "s%d" % (nRecords - 1))
+
+    def testMappedIds(self):
+        """Test that mapped records keep their IDs, and that new records get
+        IDs larger than any that were read.
+        """
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        nRecords = 150
+        cat = lsst.afw.table.SourceCatalog(schema)
+        for i in range(nRecords):
+            cat.addNew().setId(1000 + 7*((i*31) % nRecords))
+        maxId = max(record.getId() for record in cat)
+        with lsst.utils.tests.getTempFilePath(".afw") as tmpFile:
+            cat.writeMapped(tmpFile)
+            for catType in (lsst.afw.table.SourceCatalog, lsst.afw.table.SimpleCatalog):
+                cat2 = catType.readMapped(tmpFile)
+                np.testing.assert_array_equal(cat2["id"], cat["id"])
+                self.assertEqual(cat2.addNew().getId(), maxId + 1)
+
+    def testMappedVariableLength(self):
+        """Test that variable-length fields cannot be written to a mapped file.
+        """
+        schema = lsst.afw.table.Schema()
+        schema.addField("v", type="ArrayF", size=0, doc="variable-length array")
+        cat = lsst.afw.table.BaseCatalog(schema)
+        cat.addNew()
+        with lsst.utils.tests.getTempFilePath(".afw") as tmpFile:
+            with self.assertRaises(lsst.pex.exceptions.LogicError):
+                cat.writeMapped(tmpFile)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -233,6 +233,260 @@ class WarpExposureTestCase(lsst.utils.tests.TestCase):
                 self.assertEqual(
                     wc.getMaskWarpingKernel().getCacheSize(), newCacheSize)
 
+    def testWarpingControlNumThreads(self):
+        """Test the numThreads property of WarpingControl
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getNumThreads(), 1)
+        for numThreads in (0, 4, 1):
+            wc.setNumThreads(numThreads)
+            self.assertEqual(wc.getNumThreads(), numThreads)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            wc.setNumThreads(-1)
+
+    def testMultithreadedWarp(self):
+        """Test that warping gives the same result for any number of threads
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees),
+        )
+        np.random.seed(1)
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[1][:] = np.random.randint(0, 4, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+
+        for interpLength in (0, 1, 10):
+            for maskKernelName in ("", "bilinear"):
+                warpControl = afwMath.WarpingControl("lanczos3", maskKernelName, 0, interpLength)
+                refMaskedImage = afwImage.MaskedImageF(110, 121)
+                refNumGoodPix = afwMath.warpImage(refMaskedImage, destWcs, srcMaskedImage, srcWcs,
+                                                  warpControl)
+                self.assertGreater(refNumGoodPix, 0)
+                for numThreads in (3, 0):
+                    warpControl.setNumThreads(numThreads)
+                    destMaskedImage = afwImage.MaskedImageF(110, 121)
+                    numGoodPix = afwMath.warpImage(destMaskedImage, destWcs, srcMaskedImage, srcWcs,
+                                                   warpControl)
+                    msg = f"interpLength={interpLength}; maskKernelName={maskKernelName!r}; " \
+                        f"numThreads={numThreads}"
+                    self.assertEqual(numGoodPix, refNumGoodPix, msg=msg)
+                    self.assertMaskedImagesEqual(destMaskedImage, refMaskedImage, msg=msg)
+
+    def testWarpExposures(self):
+        """Test that warpExposures matches warpExposure for each exposure
+        and that the coverage masks mark the pixels that could not be computed
+        """
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees),
+        )
+        destBBox = lsst.geom.Box2I(lsst.geom.Point2I(-5, 3), lsst.geom.Extent2I(110, 121))
+        np.random.seed(2)
+        srcExposures = []
+        for i, crvalOffset in enumerate((0.0, 5.0, 30.0)):
+            srcWcs = afwGeom.makeSkyWcs(
+                crpix=lsst.geom.Point2D(10, 11),
+                crval=lsst.geom.SpherePoint(41.7 + crvalOffset, 32.9, lsst.geom.degrees),
+                cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+            )
+            srcExposure = afwImage.ExposureF(afwImage.MaskedImageF(100 - i, 101), srcWcs)
+            srcArrays = srcExposure.getMaskedImage().getArrays()
+            shape = srcArrays[0].shape
+            srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+            srcArrays[1][:] = np.random.randint(0, 4, size=shape)
+            srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+            srcExposure.getInfo().setVisitInfo(makeVisitInfo())
+            srcExposures.append(srcExposure)
+
+        noDataBit = afwImage.Mask.getPlaneBitMask("NO_DATA")
+        for interpLength in (0, 10):
+            warpControl = afwMath.WarpingControl("lanczos3", "", 0, interpLength)
+            refList = []
+            for srcExposure in srcExposures:
+                refExposure = afwImage.ExposureF(destBBox, destWcs)
+                refNumGoodPix = afwMath.warpExposure(refExposure, srcExposure, warpControl)
+                refList.append((refExposure, refNumGoodPix))
+            # the last source exposure does not overlap the destination
+            self.assertGreater(refList[0][1], 0)
+            self.assertEqual(refList[2][1], 0)
+
+            for numThreads in (1, 3, 5):
+                warpControl.setNumThreads(numThreads)
+                warpedList = afwMath.warpExposures(destWcs, destBBox, srcExposures, warpControl)
+                self.assertEqual(len(warpedList), len(srcExposures))
+                for warped, (refExposure, refNumGoodPix) in zip(warpedList, refList):
+                    msg = f"interpLength={interpLength}; numThreads={numThreads}"
+                    self.assertEqual(warped.numGoodPixels, refNumGoodPix, msg=msg)
+                    self.assertEqual(warped.exposure.getBBox(), destBBox, msg=msg)
+                    self.assertEqual(warped.exposure.getWcs(), destWcs, msg=msg)
+                    self.assertEqual(warped.exposure.getInfo().getVisitInfo(),
+                                     refExposure.getInfo().getVisitInfo(), msg=msg)
+                    self.assertMaskedImagesEqual(warped.exposure.getMaskedImage(),
+                                                 refExposure.getMaskedImage(), msg=msg)
+                    self.assertEqual(warped.coverage.getBBox(), destBBox, msg=msg)
+                    noData = warped.coverage.getArray() & noDataBit != 0
+                    self.assertEqual(np.sum(~noData), refNumGoodPix, msg=msg)
+                    np.testing.assert_array_equal(
+                        noData, ~np.isfinite(warped.exposure.getMaskedImage().getImage().getArray()),
+                        err_msg=msg)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwMath.warpExposures(destWcs, destBBox, [afwImage.ExposureF(10, 10)], warpControl)
+        self.assertEqual(afwMath.warpExposures(destWcs, destBBox, [], warpControl), [])
+
+    def testInterpolationBatches(self):
+        """Test interpolation on a destination image with enough interpolation grid points
+        that they are transformed in more than one batch
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(150, 160),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.01*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(149, 158),
+            crval=lsst.geom.SpherePoint(41.69, 32.91, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.0095*lsst.geom.degrees, orientation=5*lsst.geom.degrees),
+        )
+        np.random.seed(3)
+        srcImage = afwImage.ImageF(300, 320)
+        srcImage.array[:] = np.random.normal(10000, 1000, size=srcImage.array.shape)
+
+        # an interpolation length of 1 gives each pixel the exact source position, apart from roundoff
+        warpControl = afwMath.WarpingControl("lanczos3", "", 0, 0)
+        exactImage = afwImage.ImageF(310, 330)
+        exactNumGoodPix = afwMath.warpImage(exactImage, destWcs, srcImage, srcWcs, warpControl)
+        self.assertGreater(exactNumGoodPix, 0)
+        for numThreads in (1, 4):
+            warpControl.setInterpLength(1)
+            warpControl.setNumThreads(numThreads)
+            destImage = afwImage.ImageF(310, 330)
+            numGoodPix = afwMath.warpImage(destImage, destWcs, srcImage, srcWcs, warpControl)
+            self.assertEqual(numGoodPix, exactNumGoodPix)
+            self.assertImagesAlmostEqual(destImage, exactImage, rtol=1e-6)
+
+    def testAdaptiveInterpolation(self):
+        """Test adaptive interpolation against exact transforms and fixed interpolation
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getInterpTolerance(), 0)
+        wc.setInterpTolerance(0.01)
+        self.assertEqual(wc.getInterpTolerance(), 0.01)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            wc.setInterpTolerance(-0.1)
+
+        # a wide field, so that linear interpolation of the source position has measurable errors
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees),
+        )
+        # a smooth source image, so errors in source position produce small, predictable errors
+        srcImage = afwImage.ImageD(100, 101)
+        yInd, xInd = np.indices(srcImage.array.shape)
+        srcImage.array[:] = 1000 + 3*xInd + 2*yInd
+
+        warpControl = afwMath.WarpingControl("bilinear", "", 0, 0)
+        exactImage = afwImage.ImageD(110, 121)
+        exactNumGoodPix = afwMath.warpImage(exactImage, destWcs, srcImage, srcWcs, warpControl)
+        self.assertGreater(exactNumGoodPix, 0)
+        good = np.isfinite(exactImage.array)
+
+        # a tolerance much smaller than roundoff in the warped values must give the exact result
+        warpControl.setInterpLength(64)
+        warpControl.setInterpTolerance(1e-10)
+        for numThreads in (1, 3):
+            warpControl.setNumThreads(numThreads)
+            destImage = afwImage.ImageD(110, 121)
+            numGoodPix = afwMath.warpImage(destImage, destWcs, srcImage, srcWcs, warpControl)
+            self.assertEqual(numGoodPix, exactNumGoodPix)
+            self.assertImagesAlmostEqual(destImage, exactImage, rtol=1e-7)
+
+        # a small tolerance must be much more accurate than fixed interpolation with the same length
+        warpControl.setInterpTolerance(0)
+        fixedImage = afwImage.ImageD(110, 121)
+        afwMath.warpImage(fixedImage, destWcs, srcImage, srcWcs, warpControl)
+        warpControl.setInterpTolerance(1e-5)
+        adaptiveImage = afwImage.ImageD(110, 121)
+        afwMath.warpImage(adaptiveImage, destWcs, srcImage, srcWcs, warpControl)
+        good &= np.isfinite(fixedImage.array) & np.isfinite(adaptiveImage.array)
+        fixedErr = np.max(np.abs(fixedImage.array - exactImage.array)[good])
+        adaptiveErr = np.max(np.abs(adaptiveImage.array - exactImage.array)[good])
+        self.assertLess(adaptiveErr, 0.25*fixedErr)
+
+    def testLanczosTable(self):
+        """Test warping with tabulated Lanczos kernels against exact kernels
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getLanczosTableSize(), 0)
+        wc.setLanczosTableSize(1024)
+        self.assertEqual(wc.getLanczosTableSize(), 1024)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            wc.setLanczosTableSize(-1)
+
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees),
+        )
+        np.random.seed(2)
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[1][:] = np.random.randint(0, 4, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+
+        for kernelName, maskKernelName in (("lanczos2", ""), ("lanczos3", "bilinear"),
+                                           ("lanczos4", "lanczos2"), ("lanczos5", "")):
+            order = int(kernelName[-1])
+            for tableSize in (256, 1024):
+                # the documented bound on the error of each weight, times 16 order for each pixel,
+                # times the largest source value under the kernel
+                weightErr = np.pi**2*(1 + 1/order**2)/(24*tableSize**2)
+                atol = 16*order*weightErr*15000
+                msg = f"kernelName={kernelName}; maskKernelName={maskKernelName}; tableSize={tableSize}"
+                warpControl = afwMath.WarpingControl(kernelName, maskKernelName)
+                exactMaskedImage = afwImage.MaskedImageF(110, 121)
+                exactNumGoodPix = afwMath.warpImage(exactMaskedImage, destWcs, srcMaskedImage, srcWcs,
+                                                    warpControl)
+
+                warpControl.setLanczosTableSize(tableSize)
+                for numThreads in (1, 3):
+                    warpControl.setNumThreads(numThreads)
+                    tableMaskedImage = afwImage.MaskedImageF(110, 121)
+                    numGoodPix = afwMath.warpImage(tableMaskedImage, destWcs, srcMaskedImage, srcWcs,
+                                                   warpControl)
+                    self.assertEqual(numGoodPix, exactNumGoodPix, msg=msg)
+                    self.assertMaskedImagesAlmostEqual(tableMaskedImage, exactMaskedImage, doMask=True,
+                                                       rtol=0, atol=atol, msg=msg)
+
+                    tableImage = afwImage.ImageF(110, 121)
+                    afwMath.warpImage(tableImage, destWcs, srcMaskedImage.getImage(), srcWcs, warpControl)
+                    self.assertImagesAlmostEqual(tableImage, exactMaskedImage.getImage(),
+                                                 rtol=0, atol=atol, msg=msg)
+
     def testWarpingControlError(self):
         """Test error handling of WarpingControl
         """